@@ -0,0 +1,454 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h>
+#include "lz4.h"
+#include "storage.h"
+#include "workspace.h"
+
+// Crash-safe copy of the open tabs: a journal of the editors' edits, appended in batches by a thread of its own.
+// The render thread only hands over what each editor recorded that frame. The writer replays the edits on its own
+// copy of every tab's text, which it also uses to rewrite the journal as a snapshot once it has grown well past one.
+// The next injection reopens the tabs from it.
+namespace Autosave {
+	const ImU32 Magic = 0x4e524a47; // "GJRN"
+	const ImU32 Version = 1;
+	const int FlushInterval = 1000;         // milliseconds between batches
+	const size_t CompactMinimum = 256 * 1024;
+
+	enum RecordKind : ImU32 {
+		RecordOpen,     // a new tab, or a tab renamed, the payload is its name
+		RecordClose,
+		RecordReset,    // the whole text, compressed
+		RecordEdit,     // removed bytes at line and index, the payload is the text put in their place
+	};
+
+	struct FileHeader {
+		ImU32 magic;
+		ImU32 version;
+	};
+
+	// Followed by the payload
+	struct RecordHeader {
+		ImU32 hash;             // of the rest of the header and the payload
+		ImU32 kind;
+		ImU32 tab;
+		ImU32 line;
+		ImU32 index;
+		ImU32 removed;
+		ImU32 payloadSize;
+		ImU32 textSize;         // of a reset's text once decompressed
+	};
+
+	struct Event {
+		RecordKind kind;
+		int tab;
+		TextEditor::Change change;  // the name for RecordOpen
+	};
+
+	struct Replica {
+		int tab;
+		std::string name;
+		std::vector<std::string> lines;
+		bool lost;              // an edit didn't apply, the rest are skipped until the render thread sends a reset
+	};
+
+	// Render thread
+	struct Known {
+		int tab;
+		std::string name;
+	};
+	std::vector<Known> known;
+	std::vector<TextEditor::Change> taken;
+	std::vector<Event> outbox;
+
+	// Shared, guarded by mutex
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<Event> pending;
+	std::vector<int> resync;                // tabs whose replica was lost
+	std::atomic<bool> resyncRequested(false);
+	bool stopping = false;
+	std::thread writer;
+
+	// Writer thread, and the loader thread before it starts
+	std::string path;
+	std::vector<Replica> replicas;
+	size_t fileSize = 0;    // end of the last good record, anything after it is a torn write and gets overwritten
+	size_t snapshotSize = 0;
+
+	ImU32 RecordHash(const RecordHeader& header, const char* payload) {
+		ImU32 hash = ImHashData(&header.kind, sizeof(RecordHeader) - sizeof(header.hash));
+		return ImHashData(payload, header.payloadSize, hash);
+	}
+
+	Replica* Find(int tab) {
+		for (Replica& replica : replicas) {
+			if (replica.tab == tab)
+				return &replica;
+		}
+		return nullptr;
+	}
+
+	void SplitLines(const std::string& text, std::vector<std::string>& lines) {
+		lines.clear();
+		size_t start = 0;
+		for (size_t lineBreak; (lineBreak = text.find('\n', start)) != std::string::npos; start = lineBreak + 1)
+			lines.emplace_back(text, start, lineBreak - start);
+		lines.emplace_back(text, start, std::string::npos);
+	}
+
+	std::string JoinLines(const std::vector<std::string>& lines) {
+		size_t size = lines.size() - 1;
+		for (const std::string& line : lines)
+			size += line.size();
+
+		std::string text;
+		text.reserve(size);
+		for (size_t i = 0; i < lines.size(); i++) {
+			if (i > 0)
+				text += '\n';
+			text += lines[i];
+		}
+		return text;
+	}
+
+	// Returns false if the edit doesn't fit the text, which is left as it was
+	bool ApplyEdit(std::vector<std::string>& lines, const TextEditor::Change& change) {
+		if (change.mLine < 0 || (size_t)change.mLine >= lines.size() || change.mIndex < 0 || (size_t)change.mIndex > lines[change.mLine].size())
+			return false;
+
+		// Where the removed bytes end, line breaks count as one
+		size_t endLine = change.mLine;
+		size_t endIndex = change.mIndex;
+		size_t removed = change.mRemoved;
+		while (removed > lines[endLine].size() - endIndex) {
+			removed -= lines[endLine].size() - endIndex + 1;
+			if (++endLine == lines.size())
+				return false;
+			endIndex = 0;
+		}
+		endIndex += removed;
+
+		std::string tail = lines[endLine].substr(endIndex);
+		const std::string& text = change.mText;
+		size_t lineBreak = text.find('\n');
+		std::string& first = lines[change.mLine];
+		first.resize(change.mIndex);
+		first.append(text, 0, lineBreak);
+
+		std::vector<std::string> added;
+		while (lineBreak != std::string::npos) {
+			size_t next = text.find('\n', lineBreak + 1);
+			added.emplace_back(text, lineBreak + 1, (next == std::string::npos ? text.size() : next) - lineBreak - 1);
+			lineBreak = next;
+		}
+		(added.empty() ? first : added.back()) += tail;
+
+		if (endLine > (size_t)change.mLine || !added.empty()) {
+			lines.erase(lines.begin() + change.mLine + 1, lines.begin() + endLine + 1);
+			lines.insert(lines.begin() + change.mLine + 1, std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+		}
+		return true;
+	}
+
+	// Replays a record on the replicas, returns false if it didn't apply
+	bool Apply(RecordKind kind, int tab, const TextEditor::Change& change) {
+		Replica* replica = Find(tab);
+		switch (kind) {
+		case RecordOpen:
+			if (!replica) {
+				replicas.push_back({ tab, change.mText, { std::string() }, false });
+				return true;
+			}
+			replica->name = change.mText;
+			return true;
+		case RecordClose:
+			if (!replica)
+				return false;
+			replicas.erase(replicas.begin() + (replica - replicas.data()));
+			return true;
+		case RecordReset:
+			if (!replica)
+				return false;
+			SplitLines(change.mText, replica->lines);
+			replica->lost = false;
+			return true;
+		case RecordEdit:
+			return replica && !replica->lost && ApplyEdit(replica->lines, change);
+		}
+		return false;
+	}
+
+	void WriteRecord(std::vector<char>& out, RecordKind kind, int tab, const TextEditor::Change& change) {
+		RecordHeader header = {};
+		header.kind = kind;
+		header.tab = (ImU32)tab;
+		header.line = (ImU32)change.mLine;
+		header.index = (ImU32)change.mIndex;
+		header.removed = (ImU32)change.mRemoved;
+		header.textSize = (ImU32)change.mText.size();
+
+		size_t start = out.size();
+		out.resize(start + sizeof(header) + (kind == RecordReset ? Lz4::Bound(change.mText.size()) : change.mText.size()));
+		char* payload = out.data() + start + sizeof(header);
+		if (kind == RecordReset) {
+			header.payloadSize = (ImU32)Lz4::Compress(change.mText.data(), change.mText.size(), payload);
+		}
+		else {
+			memcpy(payload, change.mText.data(), change.mText.size());
+			header.payloadSize = header.textSize;
+		}
+		out.resize(start + sizeof(header) + header.payloadSize);
+		header.hash = RecordHash(header, out.data() + start + sizeof(header));
+		memcpy(out.data() + start, &header, sizeof(header));
+	}
+
+	// Walks the records up to the first one that is cut off or doesn't match its hash
+	void Parse(const char* data, size_t size) {
+		replicas.clear();
+		fileSize = 0;
+
+		FileHeader fileHeader;
+		if (size < sizeof(fileHeader))
+			return;
+		memcpy(&fileHeader, data, sizeof(fileHeader));
+		if (fileHeader.magic != Magic || fileHeader.version != Version)
+			return;
+
+		size_t offset = sizeof(fileHeader);
+		TextEditor::Change change;
+		while (size - offset >= sizeof(RecordHeader)) {
+			RecordHeader header;
+			memcpy(&header, data + offset, sizeof(header));
+			const char* payload = data + offset + sizeof(header);
+			if (header.payloadSize > size - offset - sizeof(header) || RecordHash(header, payload) != header.hash)
+				break;
+
+			change.mLine = (int)header.line;
+			change.mIndex = (int)header.index;
+			change.mRemoved = header.removed;
+			if (header.kind == RecordReset) {
+				change.mText.resize(header.textSize);
+				if (!Lz4::Decompress(payload, header.payloadSize, &change.mText[0], header.textSize))
+					break;
+			}
+			else {
+				change.mText.assign(payload, header.payloadSize);
+			}
+			Apply((RecordKind)header.kind, (int)header.tab, change);
+			offset += sizeof(header) + header.payloadSize;
+		}
+		fileSize = offset;
+	}
+
+	bool Append(const std::vector<char>& records) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		// A new file, or one that wasn't ours, starts over with a header
+		std::vector<char> header;
+		if (fileSize == 0) {
+			FileHeader fileHeader = { Magic, Version };
+			header.assign((const char*)&fileHeader, (const char*)&fileHeader + sizeof(fileHeader));
+		}
+
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)fileSize;
+		DWORD written = 0;
+		DWORD headerWritten = 0;
+		bool ok = SetFilePointerEx(file, position, NULL, FILE_BEGIN) &&
+			(header.empty() || (WriteFile(file, header.data(), (DWORD)header.size(), &headerWritten, NULL) && headerWritten == header.size())) &&
+			WriteFile(file, records.data(), (DWORD)records.size(), &written, NULL) && written == records.size() && SetEndOfFile(file);
+		CloseHandle(file);
+		if (ok)
+			fileSize += header.size() + records.size();
+		return ok;
+	}
+
+	// Rewrites the journal as the current name and text of each tab
+	bool WriteSnapshot() {
+		std::vector<char> bytes;
+		FileHeader fileHeader = { Magic, Version };
+		bytes.insert(bytes.end(), (const char*)&fileHeader, (const char*)&fileHeader + sizeof(fileHeader));
+
+		TextEditor::Change change;
+		for (const Replica& replica : replicas) {
+			change.mText = replica.name;
+			WriteRecord(bytes, RecordOpen, replica.tab, change);
+			change.mText = JoinLines(replica.lines);
+			WriteRecord(bytes, RecordReset, replica.tab, change);
+		}
+		if (!WriteFileBytes(path, bytes.data(), bytes.size()))
+			return false;
+		fileSize = snapshotSize = bytes.size();
+		return true;
+	}
+
+	// Typing and backspacing at the end of what was just typed become one record
+	bool Merge(Event& last, const Event& event) {
+		if (last.kind != RecordEdit || event.kind != RecordEdit || last.tab != event.tab || last.change.mLine != event.change.mLine ||
+			last.change.mText.find('\n') != std::string::npos)
+			return false;
+
+		size_t end = last.change.mIndex + last.change.mText.size();
+		if (event.change.mRemoved == 0 && (size_t)event.change.mIndex == end) {
+			last.change.mText += event.change.mText;
+			return true;
+		}
+		if (event.change.mText.empty() && event.change.mIndex >= last.change.mIndex && event.change.mIndex + event.change.mRemoved == end) {
+			last.change.mText.resize(event.change.mIndex - last.change.mIndex);
+			return true;
+		}
+		return false;
+	}
+
+	void Flush(std::vector<Event>& events) {
+		std::vector<Event> merged;
+		for (Event& event : events) {
+			if (merged.empty() || !Merge(merged.back(), event))
+				merged.push_back(std::move(event));
+		}
+
+		std::vector<char> records;
+		std::vector<int> lost;
+		for (const Event& event : merged) {
+			Replica* replica = Find(event.tab);
+			bool wasLost = replica && replica->lost;
+			if (!Apply(event.kind, event.tab, event.change)) {
+				if (event.kind == RecordEdit && replica && !wasLost) {
+					replica->lost = true;
+					lost.push_back(event.tab);
+				}
+				continue;
+			}
+			WriteRecord(records, event.kind, event.tab, event.change);
+		}
+
+		if (!lost.empty()) {
+			std::lock_guard<std::mutex> lock(mutex);
+			resync.insert(resync.end(), lost.begin(), lost.end());
+			resyncRequested = true;
+		}
+
+		if (records.empty())
+			return;
+		bool compact = fileSize + records.size() > snapshotSize * 4 + CompactMinimum;
+		if (!compact || !WriteSnapshot())
+			Append(records);
+	}
+
+	void Run() {
+		std::vector<Event> events;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			condition.wait_for(lock, std::chrono::milliseconds(FlushInterval), [] { return stopping; });
+			events.swap(pending);
+			bool stop = stopping;
+			lock.unlock();
+
+			if (!events.empty())
+				Flush(events);
+			events.clear();
+			if (stop)
+				return;
+			lock.lock();
+		}
+	}
+
+	// Reopens the tabs of the last injection and starts the writer. The tabs get new ids, so the journal starts
+	// over as a snapshot under those.
+	void Restore(const std::string& journalPath) {
+		path = journalPath;
+		MappedFile file;
+		if (file.Open(path))
+			Parse(file.data, file.size);
+		file.Close();
+
+		for (Replica& replica : replicas) {
+			Workspace::Tab* tab = Workspace::Add(replica.name);
+			tab->editor.SetText(JoinLines(replica.lines));
+			tab->editor.TakeChanges(taken);
+			replica.tab = tab->id;
+			known.push_back({ tab->id, tab->name });
+		}
+		WriteSnapshot();
+		writer = std::thread(Run);
+	}
+
+	// Called once a frame on the render thread, after the editors were drawn. Never waits on the writer, the lock
+	// is only held by it to swap the pending events out.
+	void Update() {
+		for (size_t i = 0; i < known.size();) {
+			bool open = std::any_of(Workspace::tabs.begin(), Workspace::tabs.end(), [&](const std::unique_ptr<Workspace::Tab>& tab) {
+				return tab->id == known[i].tab;
+			});
+			if (open) {
+				i++;
+				continue;
+			}
+			outbox.push_back({ RecordClose, known[i].tab, TextEditor::Change() });
+			known.erase(known.begin() + i);
+		}
+
+		for (auto& tab : Workspace::tabs) {
+			auto it = std::find_if(known.begin(), known.end(), [&](const Known& k) { return k.tab == tab->id; });
+			if (it == known.end() || it->name != tab->name) {
+				TextEditor::Change name;
+				name.mText = tab->name;
+				outbox.push_back({ RecordOpen, tab->id, std::move(name) });
+				if (it == known.end())
+					known.push_back({ tab->id, tab->name });
+				else
+					it->name = tab->name;
+			}
+
+			tab->editor.TakeChanges(taken);
+			for (TextEditor::Change& change : taken)
+				outbox.push_back({ change.mReset ? RecordReset : RecordEdit, tab->id, std::move(change) });
+		}
+
+		if (resyncRequested.exchange(false)) {
+			std::vector<int> lost;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				lost.swap(resync);
+			}
+			for (auto& tab : Workspace::tabs) {
+				if (std::find(lost.begin(), lost.end(), tab->id) == lost.end())
+					continue;
+				TextEditor::Change reset;
+				reset.mReset = true;
+				reset.mText = tab->editor.GetText();
+				outbox.push_back({ RecordReset, tab->id, std::move(reset) });
+			}
+		}
+
+		if (outbox.empty())
+			return;
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.insert(pending.end(), std::make_move_iterator(outbox.begin()), std::make_move_iterator(outbox.end()));
+		outbox.clear();
+	}
+
+	// Writes out whatever is pending, on uninject
+	void Stop() {
+		if (!writer.joinable())
+			return;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		condition.notify_one();
+		writer.join();
+	}
+}
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "hooks/Present.h"
 #include "hooks/CursorHooks.h"
 #include "hooks/PaintTraverse.h"
+#include "ipc.h"
 
 #include "globals.h"
 
@@ -49,6 +50,9 @@ LRESULT WndProc(const HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
 }
 
 DWORD WINAPI LoaderThread(PVOID thread) {
+    // Build fonts here, before the window proc or Present hook can touch the ImGui context
+    initImGui();
+
     HWND hWnd = FindWindow("Valve001", 0);
     oWndProc = (WNDPROC)SetWindowLongPtr(hWnd, GWLP_WNDPROC, (LONG_PTR)WndProc);
 
@@ -57,6 +61,9 @@ DWORD WINAPI LoaderThread(PVOID thread) {
     hookCursor();
     hookPaintTraverse();
 
+    // Scripts from other programs go through the same queue PaintTraverse drains
+    Ipc::Start(Ipc::PipeName);
+
     while (!Globals::uninject) {
         Sleep(10);
     }
@@ -67,6 +74,14 @@ DWORD WINAPI LoaderThread(PVOID thread) {
     Sleep(100);
     MH_Uninitialize();
 
+    // If Present never ran again to free the minimap textures, leak them rather than release them off the render thread
+    TextEditor::SetTextureHandler({ nullptr, nullptr, nullptr });
+
+    // Nothing runs or edits scripts anymore, drop external clients, stop watching files and write out the last of the journal
+    Ipc::Stop();
+    Watcher::Stop();
+    Autosave::Stop();
+
     SetWindowLongPtr(hWnd, GWLP_WNDPROC, (LONG_PTR)oWndProc);
 
     Sleep(2000);
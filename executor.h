@@ -0,0 +1,69 @@
+#pragma once
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "globals.h"
+
+// Scripts waiting for the game thread. Any thread can submit, PaintTraverse takes everything queued once a frame and
+// runs it in order, each job in the realm it was submitted for, then hands the outcome to the job's callback.
+namespace Executor {
+	struct Job {
+		std::string code;
+		bool menuRealm;
+		int tag;                                            // the submitter's own reference, passed back to done
+		void (*done)(const Job& job, const char* error);    // on the game thread, error is null if the script ran
+	};
+
+	// An error from a script run from an editor tab, waiting for the render thread to mark it in that tab
+	struct EditorError {
+		int tab;
+		int line;
+		std::string message;
+	};
+
+	std::mutex mutex;                       // guards both below
+	std::vector<Job> queue;
+	std::vector<EditorError> editorErrors;
+
+	void Submit(Job job) {
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.push_back(std::move(job));
+	}
+
+	bool ParseError(std::string fullError, int& errorLine, std::string& errorString) {
+		int firstColon = fullError.find(":");
+		int secondColon = fullError.find(":", firstColon + 1);
+		// Only "chunk:line: message" has a line to mark
+		if (firstColon < 0 || secondColon < 0 || secondColon == firstColon + 1 || !isdigit((unsigned char)fullError[firstColon + 1]))
+			return false;
+		std::string lineSlice = fullError.substr(firstColon + 1, secondColon - firstColon - 1);
+		errorLine = std::stoi(lineSlice);
+		errorString = fullError.substr(secondColon + 2, strlen(fullError.c_str()) - (secondColon + 2));
+		return true;
+	}
+
+	// Job::done for the editor's Execute button, tagged with the tab's id. The error is marked on its line in that tab.
+	void MarkEditorError(const Job& job, const char* error) {
+		EditorError marker;
+		if (!error || !ParseError(error, marker.line, marker.message))
+			return;
+		marker.tab = job.tag;
+		std::lock_guard<std::mutex> lock(mutex);
+		editorErrors.push_back(std::move(marker));
+	}
+
+	void TakeEditorErrors(std::vector<EditorError>& errors) {
+		errors.clear();
+		std::lock_guard<std::mutex> lock(mutex);
+		errors.swap(editorErrors);
+	}
+
+	// The vectors trade buffers, so once both have grown neither side allocates
+	void Take(std::vector<Job>& jobs) {
+		jobs.clear();
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.swap(queue);
+	}
+}
\ No newline at end of file
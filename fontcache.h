@@ -0,0 +1,253 @@
+#pragma once
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h>
+#include "storage.h"
+
+// Caches the built font atlas (pixels, glyph tables, custom rects) on disk so later injections
+// skip stb_truetype rasterization. The cache is keyed by a hash of everything that feeds the build.
+namespace FontCache {
+	const ImU32 Magic = 0x43414647; // "GFAC"
+	const ImU32 Version = 1;
+
+	struct Header {
+		ImU32 magic;
+		ImU32 version;
+		ImU32 configHash;
+		int texWidth, texHeight;
+		int packIdMouseCursors, packIdLines;
+		int customRectCount;
+		int fontCount;
+		ImVec2 texUvScale;
+		ImVec2 texUvWhitePixel;
+		ImVec4 texUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+	};
+
+	struct CachedRect {
+		unsigned short width, height, x, y;
+		unsigned int glyphId;
+		float glyphAdvanceX;
+		ImVec2 glyphOffset;
+		int fontIndex;
+	};
+
+	struct CachedFont {
+		float fontSize, ascent, descent;
+		int metricsTotalSurface;
+		int configIndex, configDataCount;
+		ImWchar fallbackChar, ellipsisChar;
+		int glyphCount;
+	};
+
+	int FontIndex(ImFontAtlas* atlas, const ImFont* font) {
+		for (int i = 0; i < atlas->Fonts.Size; i++)
+			if (atlas->Fonts[i] == font)
+				return i;
+		return -1;
+	}
+
+	int ConfigIndex(ImFontAtlas* atlas, const ImFontConfig* config) {
+		return config ? (int)(config - atlas->ConfigData.Data) : -1;
+	}
+
+	// Hashes every input of ImFontAtlas::Build, plus the layout of the structures we dump raw
+	ImU32 ConfigHash(ImFontAtlas* atlas) {
+		ImU32 hash = ImHashStr(IMGUI_VERSION);
+		int layout[] = { (int)sizeof(ImFontGlyph), (int)sizeof(ImWchar), (int)sizeof(Header), (int)sizeof(CachedRect), (int)sizeof(CachedFont) };
+		hash = ImHashData(layout, sizeof(layout), hash);
+
+		int atlasParams[] = { atlas->Flags, atlas->TexDesiredWidth, atlas->TexGlyphPadding, (int)atlas->FontBuilderFlags, atlas->Fonts.Size };
+		hash = ImHashData(atlasParams, sizeof(atlasParams), hash);
+
+		for (const ImFontConfig& cfg : atlas->ConfigData) {
+			hash = ImHashData(cfg.FontData, (size_t)cfg.FontDataSize, hash);
+			hash = ImHashData(&cfg.FontNo, sizeof(cfg.FontNo), hash);
+			hash = ImHashData(&cfg.SizePixels, sizeof(cfg.SizePixels), hash);
+			hash = ImHashData(&cfg.OversampleH, sizeof(cfg.OversampleH), hash);
+			hash = ImHashData(&cfg.OversampleV, sizeof(cfg.OversampleV), hash);
+			hash = ImHashData(&cfg.PixelSnapH, sizeof(cfg.PixelSnapH), hash);
+			hash = ImHashData(&cfg.GlyphExtraSpacing, sizeof(cfg.GlyphExtraSpacing), hash);
+			hash = ImHashData(&cfg.GlyphOffset, sizeof(cfg.GlyphOffset), hash);
+			hash = ImHashData(&cfg.GlyphMinAdvanceX, sizeof(cfg.GlyphMinAdvanceX), hash);
+			hash = ImHashData(&cfg.GlyphMaxAdvanceX, sizeof(cfg.GlyphMaxAdvanceX), hash);
+			hash = ImHashData(&cfg.MergeMode, sizeof(cfg.MergeMode), hash);
+			hash = ImHashData(&cfg.FontBuilderFlags, sizeof(cfg.FontBuilderFlags), hash);
+			hash = ImHashData(&cfg.RasterizerMultiply, sizeof(cfg.RasterizerMultiply), hash);
+			hash = ImHashData(&cfg.EllipsisChar, sizeof(cfg.EllipsisChar), hash);
+
+			const ImWchar* ranges = cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault();
+			const ImWchar* rangesEnd = ranges;
+			while (rangesEnd[0] && rangesEnd[1])
+				rangesEnd += 2;
+			hash = ImHashData(ranges, (size_t)(rangesEnd - ranges) * sizeof(ImWchar), hash);
+
+			int dstIndex = FontIndex(atlas, cfg.DstFont);
+			hash = ImHashData(&dstIndex, sizeof(dstIndex), hash);
+		}
+
+		// User rects registered before the build change the packing
+		for (const ImFontAtlasCustomRect& r : atlas->CustomRects) {
+			int rect[] = { r.Width, r.Height, (int)r.GlyphID, FontIndex(atlas, r.Font) };
+			hash = ImHashData(rect, sizeof(rect), hash);
+		}
+		return hash;
+	}
+
+	template <typename T>
+	void Append(std::vector<char>& out, const T* data, size_t count = 1) {
+		const char* bytes = reinterpret_cast<const char*>(data);
+		out.insert(out.end(), bytes, bytes + sizeof(T) * count);
+	}
+
+	template <typename T>
+	bool Consume(const char*& cur, const char* end, T* data, size_t count = 1) {
+		size_t size = sizeof(T) * count;
+		if ((size_t)(end - cur) < size)
+			return false;
+		memcpy(data, cur, size);
+		cur += size;
+		return true;
+	}
+
+	bool Save(ImFontAtlas* atlas, ImU32 configHash, const std::string& path) {
+		if (!atlas->TexPixelsAlpha8)
+			return false;
+
+		Header header = {};
+		header.magic = Magic;
+		header.version = Version;
+		header.configHash = configHash;
+		header.texWidth = atlas->TexWidth;
+		header.texHeight = atlas->TexHeight;
+		header.packIdMouseCursors = atlas->PackIdMouseCursors;
+		header.packIdLines = atlas->PackIdLines;
+		header.customRectCount = atlas->CustomRects.Size;
+		header.fontCount = atlas->Fonts.Size;
+		header.texUvScale = atlas->TexUvScale;
+		header.texUvWhitePixel = atlas->TexUvWhitePixel;
+		memcpy(header.texUvLines, atlas->TexUvLines, sizeof(header.texUvLines));
+
+		size_t pixelCount = (size_t)atlas->TexWidth * atlas->TexHeight;
+		std::vector<char> out;
+		out.reserve(sizeof(Header) + pixelCount + 64 * 1024);
+		Append(out, &header);
+
+		for (const ImFontAtlasCustomRect& r : atlas->CustomRects) {
+			CachedRect rect = { r.Width, r.Height, r.X, r.Y, r.GlyphID, r.GlyphAdvanceX, r.GlyphOffset, FontIndex(atlas, r.Font) };
+			Append(out, &rect);
+		}
+
+		for (ImFont* font : atlas->Fonts) {
+			CachedFont cached = {};
+			cached.fontSize = font->FontSize;
+			cached.ascent = font->Ascent;
+			cached.descent = font->Descent;
+			cached.metricsTotalSurface = font->MetricsTotalSurface;
+			cached.configIndex = ConfigIndex(atlas, font->ConfigData);
+			cached.configDataCount = font->ConfigDataCount;
+			cached.fallbackChar = font->FallbackChar;
+			cached.ellipsisChar = font->EllipsisChar;
+			cached.glyphCount = font->Glyphs.Size;
+			Append(out, &cached);
+			Append(out, font->Glyphs.Data, (size_t)font->Glyphs.Size);
+		}
+
+		Append(out, atlas->TexPixelsAlpha8, pixelCount);
+		return WriteFileBytes(path, out.data(), out.size());
+	}
+
+	// Restores a previously built atlas. Fonts must already be added (AddFont*) in the same order as when saving.
+	bool Load(ImFontAtlas* atlas, ImU32 configHash, const std::string& path) {
+		std::vector<char> data;
+		if (!ReadFileBytes(path, data))
+			return false;
+
+		const char* cur = data.data();
+		const char* end = cur + data.size();
+
+		Header header;
+		if (!Consume(cur, end, &header) || header.magic != Magic || header.version != Version || header.configHash != configHash)
+			return false;
+		if (header.fontCount != atlas->Fonts.Size || header.texWidth <= 0 || header.texHeight <= 0 || header.customRectCount < 0)
+			return false;
+
+		ImVector<ImFontAtlasCustomRect> rects;
+		rects.resize(header.customRectCount);
+		for (ImFontAtlasCustomRect& r : rects) {
+			CachedRect rect;
+			if (!Consume(cur, end, &rect) || rect.fontIndex >= atlas->Fonts.Size)
+				return false;
+			r.Width = rect.width;
+			r.Height = rect.height;
+			r.X = rect.x;
+			r.Y = rect.y;
+			r.GlyphID = rect.glyphId;
+			r.GlyphAdvanceX = rect.glyphAdvanceX;
+			r.GlyphOffset = rect.glyphOffset;
+			r.Font = rect.fontIndex >= 0 ? atlas->Fonts[rect.fontIndex] : NULL;
+		}
+
+		// Validate everything before touching the atlas so a corrupt file leaves it untouched
+		const char* fontsBegin = cur;
+		for (int i = 0; i < header.fontCount; i++) {
+			CachedFont cached;
+			if (!Consume(cur, end, &cached) || cached.configIndex < 0 || cached.configIndex >= atlas->ConfigData.Size || cached.glyphCount < 0)
+				return false;
+			if ((size_t)(end - cur) < sizeof(ImFontGlyph) * (size_t)cached.glyphCount)
+				return false;
+			cur += sizeof(ImFontGlyph) * (size_t)cached.glyphCount;
+		}
+
+		size_t pixelCount = (size_t)header.texWidth * header.texHeight;
+		if ((size_t)(end - cur) != pixelCount)
+			return false;
+
+		atlas->ClearTexData();
+		atlas->TexWidth = header.texWidth;
+		atlas->TexHeight = header.texHeight;
+		atlas->TexUvScale = header.texUvScale;
+		atlas->TexUvWhitePixel = header.texUvWhitePixel;
+		memcpy(atlas->TexUvLines, header.texUvLines, sizeof(header.texUvLines));
+		atlas->PackIdMouseCursors = header.packIdMouseCursors;
+		atlas->PackIdLines = header.packIdLines;
+		atlas->CustomRects.swap(rects);
+
+		cur = fontsBegin;
+		for (ImFont* font : atlas->Fonts) {
+			CachedFont cached;
+			Consume(cur, end, &cached);
+
+			font->ClearOutputData();
+			font->FontSize = cached.fontSize;
+			font->Ascent = cached.ascent;
+			font->Descent = cached.descent;
+			font->ConfigData = &atlas->ConfigData[cached.configIndex];
+			font->ConfigDataCount = (short)cached.configDataCount;
+			font->ContainerAtlas = atlas;
+			font->FallbackChar = cached.fallbackChar;
+			font->EllipsisChar = cached.ellipsisChar;
+			font->Glyphs.resize(cached.glyphCount);
+			Consume(cur, end, font->Glyphs.Data, (size_t)cached.glyphCount);
+			font->MetricsTotalSurface = cached.metricsTotalSurface;
+			font->BuildLookupTable();
+		}
+
+		atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(pixelCount);
+		memcpy(atlas->TexPixelsAlpha8, cur, pixelCount);
+		return true;
+	}
+
+	// Loads the cached atlas, or builds it and refreshes the cache when the font config changed
+	bool LoadOrBuild(ImFontAtlas* atlas, const std::string& path) {
+		if (atlas->Fonts.empty())
+			atlas->AddFontDefault();
+
+		ImU32 configHash = ConfigHash(atlas);
+		if (Load(atlas, configHash, path))
+			return true;
+
+		if (!atlas->Build())
+			return false;
+		Save(atlas, configHash, path);
+		return true;
+	}
+}
\ No newline at end of file
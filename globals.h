@@ -1,17 +1,8 @@
 #pragma once
-
-struct LuaError {
-	bool active = true;
-	int line;
-	std::string error;
-};
+#include <atomic>
 
 namespace Globals {
 	bool showMenu = false;
 	bool uninject = false;
-	bool runLua = false;
-	bool menuRealm = false;
-	std::string lua = "";
-
-	LuaError luaError;
+	std::atomic<bool> menuRealm(false);    // set from the menu, read by the file watcher and pipe threads too
 }
\ No newline at end of file
@@ -0,0 +1,2297 @@
+#pragma once
+// Generated by tools/gen_glua_api.py from tools/glua_api.txt, do not edit. Rerun the script after changing the dump.
+#include <cstdint>
+
+namespace GLuaApi {
+	struct Entry {
+		uint16_t name;         // offset into Names
+		uint16_t detail;       // offset into Details
+		uint8_t nameLength;
+		uint8_t depth;         // number of dots in the name
+	};
+
+	const int EntryCount = 852;
+
+	// Sorted by name, ignoring case
+	const Entry Entries[EntryCount] = {
+		{ 0, 0, 2, 0 },
+		{ 3, 6, 12, 0 },
+		{ 16, 70, 17, 0 },
+		{ 34, 115, 12, 0 },
+		{ 47, 144, 5, 0 },
+		{ 53, 205, 9, 0 },
+		{ 63, 252, 6, 0 },
+		{ 70, 324, 3, 0 },
+		{ 74, 332, 11, 1 },
+		{ 86, 376, 8, 1 },
+		{ 95, 406, 8, 1 },
+		{ 104, 431, 7, 1 },
+		{ 112, 406, 9, 1 },
+		{ 122, 376, 8, 1 },
+		{ 131, 332, 10, 1 },
+		{ 142, 332, 7, 1 },
+		{ 150, 332, 7, 1 },
+		{ 158, 332, 10, 1 },
+		{ 169, 406, 9, 1 },
+		{ 179, 462, 9, 1 },
+		{ 189, 506, 12, 0 },
+		{ 202, 520, 23, 0 },
+		{ 226, 324, 3, 0 },
+		{ 230, 532, 14, 1 },
+		{ 245, 574, 7, 1 },
+		{ 253, 574, 9, 1 },
+		{ 263, 574, 9, 1 },
+		{ 273, 574, 11, 1 },
+		{ 285, 574, 16, 1 },
+		{ 302, 577, 18, 1 },
+		{ 321, 591, 11, 1 },
+		{ 333, 574, 18, 1 },
+		{ 352, 609, 19, 1 },
+		{ 372, 652, 9, 1 },
+		{ 382, 574, 11, 1 },
+		{ 394, 668, 11, 1 },
+		{ 406, 843, 13, 1 },
+		{ 420, 884, 18, 1 },
+		{ 439, 963, 13, 0 },
+		{ 453, 324, 4, 0 },
+		{ 458, 977, 12, 1 },
+		{ 471, 574, 10, 1 },
+		{ 482, 983, 18, 1 },
+		{ 501, 983, 19, 1 },
+		{ 521, 1004, 9, 1 },
+		{ 531, 574, 14, 1 },
+		{ 546, 1022, 15, 0 },
+		{ 562, 1086, 17, 0 },
+		{ 580, 1151, 15, 0 },
+		{ 596, 1192, 5, 0 },
+		{ 602, 1248, 10, 0 },
+		{ 613, 1285, 9, 0 },
+		{ 623, 1324, 10, 0 },
+		{ 634, 1324, 10, 0 },
+		{ 645, 1364, 11, 0 },
+		{ 657, 1390, 13, 0 },
+		{ 671, 324, 10, 0 },
+		{ 682, 1463, 14, 1 },
+		{ 697, 1566, 23, 1 },
+		{ 721, 1610, 19, 1 },
+		{ 741, 1629, 17, 1 },
+		{ 759, 1643, 14, 1 },
+		{ 774, 1712, 12, 0 },
+		{ 787, 324, 6, 0 },
+		{ 794, 1629, 13, 1 },
+		{ 808, 1737, 16, 1 },
+		{ 825, 1780, 16, 1 },
+		{ 842, 1823, 10, 1 },
+		{ 853, 324, 9, 0 },
+		{ 863, 1850, 16, 1 },
+		{ 880, 1876, 16, 1 },
+		{ 897, 1916, 17, 1 },
+		{ 915, 1929, 16, 1 },
+		{ 932, 1958, 14, 1 },
+		{ 947, 1976, 14, 1 },
+		{ 962, 2009, 15, 1 },
+		{ 978, 2022, 18, 0 },
+		{ 997, 2173, 12, 0 },
+		{ 1010, 2291, 14, 0 },
+		{ 1025, 2353, 11, 0 },
+		{ 1037, 2436, 7, 0 },
+		{ 1045, 324, 5, 0 },
+		{ 1051, 2449, 23, 1 },
+		{ 1075, 2507, 10, 1 },
+		{ 1086, 2557, 24, 1 },
+		{ 1111, 2614, 12, 1 },
+		{ 1124, 2657, 21, 1 },
+		{ 1146, 2701, 26, 1 },
+		{ 1173, 2734, 12, 1 },
+		{ 1186, 2777, 10, 0 },
+		{ 1197, 324, 5, 0 },
+		{ 1203, 574, 11, 1 },
+		{ 1215, 2799, 13, 1 },
+		{ 1229, 2821, 13, 1 },
+		{ 1243, 2871, 13, 1 },
+		{ 1257, 2954, 14, 1 },
+		{ 1272, 2799, 18, 1 },
+		{ 1291, 520, 17, 1 },
+		{ 1309, 3030, 16, 1 },
+		{ 1326, 3075, 13, 1 },
+		{ 1340, 3133, 14, 1 },
+		{ 1355, 3221, 18, 1 },
+		{ 1374, 3262, 16, 1 },
+		{ 1391, 574, 11, 1 },
+		{ 1403, 3317, 15, 1 },
+		{ 1419, 3400, 15, 1 },
+		{ 1435, 3440, 17, 1 },
+		{ 1453, 3489, 9, 0 },
+		{ 1463, 3516, 14, 0 },
+		{ 1478, 3530, 24, 0 },
+		{ 1503, 3562, 13, 0 },
+		{ 1517, 3618, 11, 0 },
+		{ 1529, 3774, 19, 0 },
+		{ 1549, 3929, 9, 0 },
+		{ 1559, 3983, 15, 0 },
+		{ 1575, 324, 4, 0 },
+		{ 1580, 4012, 13, 1 },
+		{ 1594, 4158, 18, 1 },
+		{ 1613, 574, 14, 1 },
+		{ 1628, 4182, 15, 1 },
+		{ 1644, 4266, 17, 1 },
+		{ 1662, 4478, 15, 1 },
+		{ 1678, 4674, 23, 1 },
+		{ 1702, 4939, 9, 1 },
+		{ 1712, 4974, 15, 1 },
+		{ 1728, 5046, 17, 1 },
+		{ 1746, 5066, 12, 1 },
+		{ 1759, 5248, 9, 0 },
+		{ 1769, 5385, 15, 0 },
+		{ 1785, 5410, 19, 0 },
+		{ 1805, 5450, 14, 0 },
+		{ 1820, 5500, 11, 0 },
+		{ 1832, 5535, 9, 0 },
+		{ 1842, 5554, 12, 0 },
+		{ 1855, 5631, 13, 0 },
+		{ 1869, 5669, 11, 0 },
+		{ 1881, 5700, 12, 0 },
+		{ 1894, 5748, 10, 0 },
+		{ 1905, 324, 7, 0 },
+		{ 1913, 5766, 21, 1 },
+		{ 1935, 5886, 15, 1 },
+		{ 1951, 5978, 19, 1 },
+		{ 1971, 6076, 14, 1 },
+		{ 1986, 6109, 12, 0 },
+		{ 1999, 6274, 9, 0 },
+		{ 2009, 324, 6, 0 },
+		{ 2016, 6459, 21, 1 },
+		{ 2038, 520, 16, 1 },
+		{ 2055, 2436, 26, 1 },
+		{ 2082, 520, 15, 1 },
+		{ 2098, 520, 21, 1 },
+		{ 2120, 6472, 20, 1 },
+		{ 2141, 6472, 22, 1 },
+		{ 2164, 2436, 16, 1 },
+		{ 2181, 2436, 19, 1 },
+		{ 2201, 6486, 6, 0 },
+		{ 2208, 324, 4, 0 },
+		{ 2213, 6517, 11, 1 },
+		{ 2225, 6542, 21, 1 },
+		{ 2247, 6588, 17, 1 },
+		{ 2265, 6662, 16, 1 },
+		{ 2282, 6686, 25, 1 },
+		{ 2308, 6725, 16, 1 },
+		{ 2325, 6749, 15, 1 },
+		{ 2341, 6772, 14, 1 },
+		{ 2356, 6814, 15, 1 },
+		{ 2372, 6885, 14, 1 },
+		{ 2387, 6910, 17, 1 },
+		{ 2405, 520, 11, 1 },
+		{ 2417, 6950, 15, 1 },
+		{ 2433, 6976, 13, 1 },
+		{ 2447, 2436, 18, 1 },
+		{ 2466, 7018, 13, 1 },
+		{ 2480, 7048, 5, 0 },
+		{ 2486, 977, 11, 0 },
+		{ 2498, 977, 20, 0 },
+		{ 2519, 7088, 9, 0 },
+		{ 2529, 7100, 6, 0 },
+		{ 2536, 7100, 9, 0 },
+		{ 2546, 324, 4, 0 },
+		{ 2551, 7113, 11, 1 },
+		{ 2563, 7143, 14, 1 },
+		{ 2578, 1629, 14, 1 },
+		{ 2593, 1629, 11, 1 },
+		{ 2605, 7229, 11, 1 },
+		{ 2617, 7271, 9, 1 },
+		{ 2627, 7342, 10, 1 },
+		{ 2638, 7388, 9, 1 },
+		{ 2648, 7457, 9, 1 },
+		{ 2658, 7511, 11, 1 },
+		{ 2670, 7570, 9, 1 },
+		{ 2680, 7615, 9, 1 },
+		{ 2690, 7656, 10, 1 },
+		{ 2701, 7690, 13, 0 },
+		{ 2715, 2436, 11, 0 },
+		{ 2727, 2436, 9, 0 },
+		{ 2737, 324, 4, 0 },
+		{ 2742, 7717, 16, 1 },
+		{ 2759, 7734, 13, 1 },
+		{ 2773, 7774, 17, 1 },
+		{ 2791, 7800, 15, 1 },
+		{ 2807, 7861, 14, 1 },
+		{ 2822, 7885, 16, 1 },
+		{ 2839, 6459, 17, 1 },
+		{ 2857, 6459, 11, 1 },
+		{ 2869, 2436, 18, 1 },
+		{ 2888, 2436, 17, 1 },
+		{ 2906, 7907, 13, 1 },
+		{ 2920, 6472, 16, 1 },
+		{ 2937, 2436, 15, 1 },
+		{ 2953, 6472, 17, 1 },
+		{ 2971, 324, 9, 0 },
+		{ 2981, 7920, 16, 1 },
+		{ 2998, 0, 8, 0 },
+		{ 3007, 7939, 9, 0 },
+		{ 3017, 7861, 15, 0 },
+		{ 3033, 7963, 15, 0 },
+		{ 3049, 7987, 7, 0 },
+		{ 3057, 8020, 14, 0 },
+		{ 3072, 8076, 13, 0 },
+		{ 3086, 8127, 15, 0 },
+		{ 3102, 8175, 14, 0 },
+		{ 3117, 8175, 12, 0 },
+		{ 3130, 8220, 15, 0 },
+		{ 3146, 8266, 15, 0 },
+		{ 3162, 6459, 11, 0 },
+		{ 3174, 8307, 11, 0 },
+		{ 3186, 8319, 12, 0 },
+		{ 3199, 8339, 15, 0 },
+		{ 3215, 8394, 17, 0 },
+		{ 3233, 7907, 13, 0 },
+		{ 3247, 0, 2, 0 },
+		{ 3250, 324, 4, 0 },
+		{ 3255, 520, 16, 1 },
+		{ 3272, 324, 3, 0 },
+		{ 3276, 574, 18, 1 },
+		{ 3295, 8541, 23, 1 },
+		{ 3319, 574, 14, 1 },
+		{ 3334, 8559, 23, 1 },
+		{ 3358, 6472, 20, 1 },
+		{ 3379, 6472, 19, 1 },
+		{ 3399, 983, 12, 1 },
+		{ 3412, 2436, 10, 1 },
+		{ 3423, 2436, 10, 1 },
+		{ 3434, 8580, 11, 1 },
+		{ 3446, 8593, 18, 1 },
+		{ 3465, 8624, 15, 1 },
+		{ 3481, 324, 4, 0 },
+		{ 3486, 8655, 8, 1 },
+		{ 3495, 7907, 19, 1 },
+		{ 3515, 324, 4, 0 },
+		{ 3520, 8790, 8, 1 },
+		{ 3529, 8837, 9, 1 },
+		{ 3539, 520, 13, 1 },
+		{ 3553, 8895, 11, 1 },
+		{ 3565, 8930, 8, 1 },
+		{ 3574, 8961, 10, 0 },
+		{ 3585, 9020, 10, 0 },
+		{ 3596, 9075, 4, 0 },
+		{ 3601, 324, 4, 0 },
+		{ 3606, 9105, 10, 1 },
+		{ 3617, 9190, 9, 1 },
+		{ 3627, 9293, 7, 0 },
+		{ 3635, 324, 5, 0 },
+		{ 3641, 2436, 22, 1 },
+		{ 3664, 983, 18, 1 },
+		{ 3683, 9318, 16, 1 },
+		{ 3700, 9344, 16, 1 },
+		{ 3717, 9370, 18, 1 },
+		{ 3736, 6472, 19, 1 },
+		{ 3756, 9397, 15, 1 },
+		{ 3772, 6472, 19, 1 },
+		{ 3792, 9421, 17, 1 },
+		{ 3810, 6472, 17, 1 },
+		{ 3828, 9450, 19, 1 },
+		{ 3848, 9500, 22, 1 },
+		{ 3871, 9523, 18, 1 },
+		{ 3890, 8624, 18, 1 },
+		{ 3909, 574, 22, 1 },
+		{ 3932, 9397, 19, 1 },
+		{ 3952, 9397, 20, 1 },
+		{ 3973, 9397, 21, 1 },
+		{ 3995, 9539, 6, 0 },
+		{ 4002, 9578, 7, 0 },
+		{ 4010, 9578, 6, 0 },
+		{ 4017, 9604, 7, 0 },
+		{ 4025, 9628, 17, 0 },
+		{ 4043, 9578, 8, 0 },
+		{ 4052, 9578, 8, 0 },
+		{ 4061, 6472, 20, 0 },
+		{ 4082, 9578, 10, 0 },
+		{ 4093, 9658, 9, 0 },
+		{ 4103, 9578, 8, 0 },
+		{ 4112, 9578, 7, 0 },
+		{ 4120, 9578, 8, 0 },
+		{ 4129, 9578, 7, 0 },
+		{ 4137, 9683, 22, 0 },
+		{ 4160, 9708, 14, 0 },
+		{ 4175, 9738, 7, 0 },
+		{ 4183, 9578, 8, 0 },
+		{ 4192, 324, 3, 0 },
+		{ 4196, 574, 9, 1 },
+		{ 4206, 9769, 7, 1 },
+		{ 4214, 9769, 6, 1 },
+		{ 4221, 9813, 10, 1 },
+		{ 4232, 324, 8, 0 },
+		{ 4241, 9832, 12, 1 },
+		{ 4254, 9877, 17, 1 },
+		{ 4272, 9906, 16, 1 },
+		{ 4289, 9962, 13, 1 },
+		{ 4303, 10010, 15, 1 },
+		{ 4319, 10036, 16, 1 },
+		{ 4336, 10068, 5, 0 },
+		{ 4342, 324, 8, 0 },
+		{ 4351, 10111, 12, 1 },
+		{ 4364, 10149, 18, 1 },
+		{ 4383, 10175, 4, 0 },
+		{ 4388, 10220, 9, 0 },
+		{ 4398, 10278, 10, 0 },
+		{ 4409, 324, 4, 0 },
+		{ 4414, 10330, 8, 1 },
+		{ 4423, 10370, 13, 1 },
+		{ 4437, 10406, 8, 1 },
+		{ 4446, 10435, 15, 1 },
+		{ 4462, 10492, 13, 1 },
+		{ 4476, 10526, 8, 1 },
+		{ 4485, 10565, 11, 0 },
+		{ 4497, 10578, 12, 0 },
+		{ 4510, 324, 6, 0 },
+		{ 4517, 10666, 13, 1 },
+		{ 4531, 10690, 12, 1 },
+		{ 4544, 10745, 8, 0 },
+		{ 4553, 324, 4, 0 },
+		{ 4558, 10816, 8, 1 },
+		{ 4567, 10837, 9, 1 },
+		{ 4577, 10860, 20, 1 },
+		{ 4598, 10891, 13, 1 },
+		{ 4612, 10948, 18, 1 },
+		{ 4631, 11013, 9, 1 },
+		{ 4641, 11013, 9, 1 },
+		{ 4651, 11039, 10, 1 },
+		{ 4662, 11070, 13, 1 },
+		{ 4676, 11096, 17, 1 },
+		{ 4694, 11149, 9, 1 },
+		{ 4704, 11175, 10, 1 },
+		{ 4715, 11149, 8, 1 },
+		{ 4724, 11149, 9, 1 },
+		{ 4734, 11224, 8, 1 },
+		{ 4743, 11251, 13, 1 },
+		{ 4757, 11251, 16, 1 },
+		{ 4774, 11306, 14, 1 },
+		{ 4789, 11365, 8, 1 },
+		{ 4798, 11149, 10, 1 },
+		{ 4809, 11393, 9, 1 },
+		{ 4819, 11435, 10, 1 },
+		{ 4830, 11464, 9, 1 },
+		{ 4840, 11471, 13, 1 },
+		{ 4854, 11494, 18, 1 },
+		{ 4873, 11551, 10, 1 },
+		{ 4884, 11606, 8, 1 },
+		{ 4893, 10816, 10, 1 },
+		{ 4904, 11644, 8, 1 },
+		{ 4913, 11644, 8, 1 },
+		{ 4922, 11393, 8, 1 },
+		{ 4931, 11676, 9, 1 },
+		{ 4941, 11708, 19, 1 },
+		{ 4961, 11464, 7, 1 },
+		{ 4969, 11733, 8, 1 },
+		{ 4978, 11764, 8, 1 },
+		{ 4987, 11791, 9, 1 },
+		{ 4997, 11826, 11, 1 },
+		{ 5009, 11869, 15, 1 },
+		{ 5025, 11883, 10, 1 },
+		{ 5036, 11966, 10, 1 },
+		{ 5047, 11149, 8, 1 },
+		{ 5056, 11149, 9, 1 },
+		{ 5066, 12012, 11, 1 },
+		{ 5078, 406, 9, 1 },
+		{ 5088, 406, 8, 1 },
+		{ 5097, 11149, 9, 1 },
+		{ 5107, 12052, 17, 1 },
+		{ 5125, 12105, 13, 1 },
+		{ 5139, 12147, 6, 0 },
+		{ 5146, 12230, 4, 0 },
+		{ 5151, 324, 4, 0 },
+		{ 5156, 574, 18, 1 },
+		{ 5175, 12261, 10, 1 },
+		{ 5186, 12305, 10, 1 },
+		{ 5197, 574, 8, 1 },
+		{ 5206, 12346, 11, 1 },
+		{ 5218, 12362, 13, 1 },
+		{ 5232, 12380, 9, 1 },
+		{ 5242, 12445, 13, 1 },
+		{ 5256, 12506, 13, 1 },
+		{ 5270, 12539, 5, 0 },
+		{ 5276, 977, 3, 0 },
+		{ 5280, 977, 4, 0 },
+		{ 5285, 977, 4, 0 },
+		{ 5290, 324, 7, 0 },
+		{ 5298, 12564, 12, 1 },
+		{ 5311, 520, 22, 1 },
+		{ 5334, 12633, 18, 1 },
+		{ 5353, 12672, 25, 1 },
+		{ 5379, 6472, 16, 1 },
+		{ 5396, 324, 3, 0 },
+		{ 5400, 574, 9, 1 },
+		{ 5410, 574, 13, 1 },
+		{ 5424, 983, 13, 1 },
+		{ 5438, 983, 16, 1 },
+		{ 5455, 12826, 12, 1 },
+		{ 5468, 7088, 13, 1 },
+		{ 5482, 2436, 11, 1 },
+		{ 5494, 6472, 12, 1 },
+		{ 5507, 12857, 13, 1 },
+		{ 5521, 12892, 12, 1 },
+		{ 5534, 2436, 14, 1 },
+		{ 5549, 7907, 14, 1 },
+		{ 5564, 2436, 13, 1 },
+		{ 5578, 2436, 14, 1 },
+		{ 5593, 12918, 11, 1 },
+		{ 5605, 577, 14, 1 },
+		{ 5620, 7100, 14, 1 },
+		{ 5635, 10565, 14, 1 },
+		{ 5650, 6459, 14, 1 },
+		{ 5665, 12946, 13, 1 },
+		{ 5679, 12984, 12, 1 },
+		{ 5692, 13025, 12, 1 },
+		{ 5705, 6459, 14, 1 },
+		{ 5720, 7100, 14, 1 },
+		{ 5735, 13057, 11, 1 },
+		{ 5747, 0, 13, 1 },
+		{ 5761, 13097, 8, 1 },
+		{ 5770, 13097, 12, 1 },
+		{ 5783, 12362, 11, 1 },
+		{ 5795, 12362, 11, 1 },
+		{ 5807, 574, 16, 1 },
+		{ 5824, 13107, 9, 1 },
+		{ 5834, 13167, 14, 1 },
+		{ 5849, 13181, 12, 1 },
+		{ 5862, 13181, 13, 1 },
+		{ 5876, 13199, 14, 1 },
+		{ 5891, 13240, 13, 1 },
+		{ 5905, 13289, 15, 1 },
+		{ 5921, 13305, 15, 1 },
+		{ 5937, 13321, 14, 1 },
+		{ 5952, 13336, 12, 1 },
+		{ 5965, 13370, 15, 1 },
+		{ 5981, 12346, 15, 1 },
+		{ 5997, 13387, 15, 1 },
+		{ 6013, 13400, 15, 1 },
+		{ 6029, 13416, 14, 1 },
+		{ 6044, 13458, 13, 1 },
+		{ 6058, 13469, 13, 1 },
+		{ 6072, 13515, 15, 1 },
+		{ 6088, 13531, 15, 1 },
+		{ 6104, 13547, 4, 0 },
+		{ 6109, 324, 12, 0 },
+		{ 6122, 13590, 22, 1 },
+		{ 6145, 13632, 24, 1 },
+		{ 6170, 13676, 17, 1 },
+		{ 6188, 13686, 13, 0 },
+		{ 6202, 13715, 13, 0 },
+		{ 6216, 324, 2, 0 },
+		{ 6219, 2436, 8, 1 },
+		{ 6228, 13773, 7, 1 },
+		{ 6236, 13824, 11, 1 },
+		{ 6248, 13863, 9, 1 },
+		{ 6258, 13890, 7, 1 },
+		{ 6266, 13923, 5, 0 },
+		{ 6272, 13959, 8, 0 },
+		{ 6281, 13973, 14, 0 },
+		{ 6296, 14048, 20, 0 },
+		{ 6317, 14125, 15, 0 },
+		{ 6333, 14181, 4, 0 },
+		{ 6338, 14211, 5, 0 },
+		{ 6344, 324, 7, 0 },
+		{ 6352, 7100, 18, 1 },
+		{ 6371, 520, 30, 1 },
+		{ 6402, 14248, 6, 0 },
+		{ 6409, 324, 6, 0 },
+		{ 6416, 14279, 20, 1 },
+		{ 6437, 520, 13, 1 },
+		{ 6451, 520, 14, 1 },
+		{ 6466, 14306, 14, 1 },
+		{ 6481, 14338, 19, 1 },
+		{ 6501, 14365, 21, 1 },
+		{ 6523, 2436, 15, 1 },
+		{ 6539, 520, 16, 1 },
+		{ 6556, 7018, 15, 1 },
+		{ 6572, 324, 14, 0 },
+		{ 6587, 14394, 28, 1 },
+		{ 6616, 520, 29, 1 },
+		{ 6646, 14422, 35, 1 },
+		{ 6682, 977, 5, 0 },
+		{ 6688, 14451, 12, 0 },
+		{ 6701, 14481, 10, 0 },
+		{ 6712, 14538, 16, 0 },
+		{ 6729, 324, 10, 0 },
+		{ 6740, 14561, 14, 1 },
+		{ 6755, 14595, 21, 1 },
+		{ 6777, 14636, 8, 0 },
+		{ 6786, 14672, 6, 0 },
+		{ 6793, 14704, 6, 0 },
+		{ 6800, 2436, 13, 0 },
+		{ 6814, 2436, 8, 0 },
+		{ 6823, 14749, 15, 0 },
+		{ 6839, 14798, 25, 0 },
+		{ 6865, 324, 6, 0 },
+		{ 6872, 14811, 14, 1 },
+		{ 6887, 14875, 23, 1 },
+		{ 6911, 14942, 14, 1 },
+		{ 6926, 14972, 12, 1 },
+		{ 6939, 15071, 17, 1 },
+		{ 6957, 574, 19, 1 },
+		{ 6977, 15101, 32, 1 },
+		{ 7010, 15120, 17, 1 },
+		{ 7028, 15155, 15, 1 },
+		{ 7044, 15278, 14, 1 },
+		{ 7059, 15372, 15, 1 },
+		{ 7075, 15465, 15, 1 },
+		{ 7091, 15558, 19, 1 },
+		{ 7111, 15654, 21, 1 },
+		{ 7133, 15684, 17, 1 },
+		{ 7151, 15798, 17, 1 },
+		{ 7169, 15881, 26, 1 },
+		{ 7196, 15896, 23, 1 },
+		{ 7220, 16013, 26, 1 },
+		{ 7247, 16151, 20, 1 },
+		{ 7268, 16179, 22, 1 },
+		{ 7291, 16194, 29, 1 },
+		{ 7321, 16232, 19, 1 },
+		{ 7341, 16268, 23, 1 },
+		{ 7365, 16295, 31, 1 },
+		{ 7397, 16333, 20, 1 },
+		{ 7418, 16295, 26, 1 },
+		{ 7445, 574, 19, 1 },
+		{ 7465, 574, 19, 1 },
+		{ 7485, 574, 22, 1 },
+		{ 7508, 16490, 20, 1 },
+		{ 7529, 16490, 20, 1 },
+		{ 7550, 16513, 23, 1 },
+		{ 7574, 16626, 16, 1 },
+		{ 7591, 16681, 17, 1 },
+		{ 7609, 16700, 15, 1 },
+		{ 7625, 574, 23, 1 },
+		{ 7649, 16718, 25, 1 },
+		{ 7675, 16749, 22, 1 },
+		{ 7698, 16763, 18, 1 },
+		{ 7717, 15101, 22, 1 },
+		{ 7740, 16779, 21, 1 },
+		{ 7762, 16852, 32, 1 },
+		{ 7795, 16877, 23, 1 },
+		{ 7819, 16896, 30, 1 },
+		{ 7850, 16919, 30, 1 },
+		{ 7881, 16942, 31, 1 },
+		{ 7913, 16966, 25, 1 },
+		{ 7939, 16966, 26, 1 },
+		{ 7966, 16980, 31, 1 },
+		{ 7998, 17004, 18, 1 },
+		{ 8017, 17045, 29, 1 },
+		{ 8047, 17072, 32, 1 },
+		{ 8080, 7088, 12, 0 },
+		{ 8093, 17098, 9, 0 },
+		{ 8103, 17245, 17, 0 },
+		{ 8121, 17283, 14, 0 },
+		{ 8136, 1629, 7, 0 },
+		{ 8144, 324, 8, 0 },
+		{ 8153, 17337, 16, 1 },
+		{ 8170, 17351, 20, 1 },
+		{ 8191, 17371, 17, 0 },
+		{ 8209, 17393, 9, 0 },
+		{ 8219, 17393, 11, 0 },
+		{ 8231, 17478, 16, 0 },
+		{ 8248, 17491, 23, 0 },
+		{ 8272, 17521, 11, 0 },
+		{ 8284, 17521, 12, 0 },
+		{ 8297, 2436, 4, 0 },
+		{ 8302, 324, 13, 0 },
+		{ 8316, 17545, 17, 1 },
+		{ 8334, 520, 21, 1 },
+		{ 8356, 17545, 23, 1 },
+		{ 8380, 17573, 22, 1 },
+		{ 8403, 2436, 4, 0 },
+		{ 8408, 17603, 6, 0 },
+		{ 8415, 17631, 16, 0 },
+		{ 8432, 17645, 7, 0 },
+		{ 8440, 17696, 14, 0 },
+		{ 8455, 17721, 13, 0 },
+		{ 8469, 17747, 15, 0 },
+		{ 8485, 17771, 14, 0 },
+		{ 8500, 17797, 12, 0 },
+		{ 8513, 17826, 15, 0 },
+		{ 8529, 17853, 15, 0 },
+		{ 8545, 17877, 12, 0 },
+		{ 8558, 17915, 11, 0 },
+		{ 8570, 17970, 24, 0 },
+		{ 8595, 18046, 18, 0 },
+		{ 8614, 18107, 5, 0 },
+		{ 8620, 324, 5, 0 },
+		{ 8626, 18136, 9, 1 },
+		{ 8636, 6749, 19, 1 },
+		{ 8656, 520, 14, 1 },
+		{ 8671, 18154, 10, 1 },
+		{ 8682, 18253, 14, 1 },
+		{ 8697, 18300, 13, 1 },
+		{ 8711, 18346, 13, 0 },
+		{ 8725, 324, 9, 0 },
+		{ 8735, 18375, 22, 1 },
+		{ 8758, 18418, 27, 1 },
+		{ 8786, 324, 3, 0 },
+		{ 8790, 574, 9, 1 },
+		{ 8800, 574, 10, 1 },
+		{ 8811, 6459, 13, 1 },
+		{ 8825, 18557, 9, 1 },
+		{ 8835, 18581, 12, 1 },
+		{ 8848, 18621, 14, 1 },
+		{ 8863, 18646, 10, 1 },
+		{ 8874, 18698, 15, 1 },
+		{ 8890, 324, 10, 0 },
+		{ 8901, 18728, 22, 1 },
+		{ 8924, 18773, 19, 1 },
+		{ 8944, 18822, 23, 1 },
+		{ 8968, 574, 23, 1 },
+		{ 8992, 18857, 19, 1 },
+		{ 9012, 18881, 6, 0 },
+		{ 9019, 324, 6, 0 },
+		{ 9026, 18907, 11, 1 },
+		{ 9038, 18977, 11, 1 },
+		{ 9050, 18993, 12, 1 },
+		{ 9063, 19048, 15, 1 },
+		{ 9079, 19084, 14, 1 },
+		{ 9094, 19153, 11, 1 },
+		{ 9106, 19261, 13, 1 },
+		{ 9120, 19292, 20, 1 },
+		{ 9141, 19338, 16, 1 },
+		{ 9158, 19362, 31, 1 },
+		{ 9190, 19386, 26, 1 },
+		{ 9217, 19416, 26, 1 },
+		{ 9244, 19447, 13, 1 },
+		{ 9258, 19489, 11, 1 },
+		{ 9270, 19585, 14, 1 },
+		{ 9285, 19633, 21, 1 },
+		{ 9307, 19656, 11, 1 },
+		{ 9319, 19691, 10, 1 },
+		{ 9330, 19633, 12, 1 },
+		{ 9343, 19714, 12, 1 },
+		{ 9356, 19779, 15, 1 },
+		{ 9372, 19804, 15, 1 },
+		{ 9388, 19633, 18, 1 },
+		{ 9407, 19827, 10, 1 },
+		{ 9418, 19893, 14, 1 },
+		{ 9433, 19633, 14, 1 },
+		{ 9448, 19656, 12, 1 },
+		{ 9461, 19945, 14, 1 },
+		{ 9476, 20014, 12, 1 },
+		{ 9489, 20062, 17, 1 },
+		{ 9507, 19416, 21, 1 },
+		{ 9529, 20105, 10, 1 },
+		{ 9540, 20169, 14, 1 },
+		{ 9555, 20199, 23, 1 },
+		{ 9579, 20199, 35, 1 },
+		{ 9615, 20223, 14, 1 },
+		{ 9630, 20245, 11, 1 },
+		{ 9642, 20296, 15, 1 },
+		{ 9658, 20296, 16, 1 },
+		{ 9675, 19633, 12, 1 },
+		{ 9688, 20338, 18, 0 },
+		{ 9707, 324, 7, 0 },
+		{ 9715, 20362, 18, 1 },
+		{ 9734, 20396, 23, 1 },
+		{ 9758, 20414, 18, 1 },
+		{ 9777, 20520, 16, 1 },
+		{ 9794, 20577, 24, 1 },
+		{ 9819, 20640, 16, 1 },
+		{ 9836, 20657, 16, 1 },
+		{ 9853, 20707, 16, 1 },
+		{ 9870, 20657, 24, 1 },
+		{ 9895, 20750, 31, 1 },
+		{ 9927, 20817, 26, 1 },
+		{ 9954, 2436, 26, 1 },
+		{ 9981, 520, 20, 1 },
+		{ 10002, 20923, 21, 1 },
+		{ 10024, 520, 20, 1 },
+		{ 10045, 983, 18, 1 },
+		{ 10064, 20950, 19, 1 },
+		{ 10084, 7861, 20, 1 },
+		{ 10105, 20982, 17, 1 },
+		{ 10123, 2436, 20, 1 },
+		{ 10144, 2436, 19, 1 },
+		{ 10164, 21001, 26, 1 },
+		{ 10191, 21021, 20, 1 },
+		{ 10212, 21068, 15, 1 },
+		{ 10228, 21086, 19, 1 },
+		{ 10248, 21021, 20, 1 },
+		{ 10269, 8559, 18, 1 },
+		{ 10288, 21107, 18, 1 },
+		{ 10307, 324, 6, 0 },
+		{ 10314, 2436, 14, 1 },
+		{ 10329, 6459, 17, 1 },
+		{ 10347, 6472, 15, 1 },
+		{ 10363, 6472, 14, 1 },
+		{ 10378, 6472, 12, 1 },
+		{ 10391, 6472, 17, 1 },
+		{ 10409, 6472, 16, 1 },
+		{ 10426, 2436, 16, 1 },
+		{ 10443, 2436, 13, 1 },
+		{ 10457, 2436, 7, 0 },
+		{ 10465, 324, 5, 0 },
+		{ 10471, 21126, 9, 1 },
+		{ 10481, 21164, 15, 1 },
+		{ 10497, 21213, 22, 1 },
+		{ 10520, 21236, 12, 1 },
+		{ 10533, 21327, 10, 1 },
+		{ 10544, 21358, 16, 1 },
+		{ 10561, 21387, 11, 1 },
+		{ 10573, 21409, 11, 1 },
+		{ 10585, 21213, 10, 1 },
+		{ 10596, 21421, 17, 1 },
+		{ 10614, 21458, 13, 1 },
+		{ 10628, 21480, 16, 1 },
+		{ 10645, 21480, 18, 1 },
+		{ 10664, 21499, 19, 1 },
+		{ 10684, 21525, 14, 1 },
+		{ 10699, 21559, 13, 1 },
+		{ 10713, 21595, 12, 1 },
+		{ 10726, 21645, 13, 1 },
+		{ 10740, 21645, 18, 1 },
+		{ 10759, 21668, 18, 1 },
+		{ 10778, 21698, 19, 1 },
+		{ 10798, 21730, 19, 1 },
+		{ 10818, 21387, 10, 1 },
+		{ 10829, 21751, 11, 1 },
+		{ 10841, 21825, 12, 1 },
+		{ 10854, 21854, 12, 1 },
+		{ 10867, 21894, 19, 1 },
+		{ 10887, 21730, 13, 1 },
+		{ 10901, 21922, 10, 1 },
+		{ 10912, 21957, 15, 1 },
+		{ 10928, 22006, 18, 1 },
+		{ 10947, 21730, 14, 1 },
+		{ 10962, 22060, 14, 1 },
+		{ 10977, 520, 11, 0 },
+		{ 10989, 324, 4, 0 },
+		{ 10994, 520, 16, 1 },
+		{ 11011, 22126, 13, 1 },
+		{ 11025, 22154, 12, 1 },
+		{ 11038, 22126, 15, 1 },
+		{ 11054, 22183, 13, 1 },
+		{ 11068, 22183, 15, 1 },
+		{ 11084, 22212, 10, 1 },
+		{ 11095, 22292, 10, 1 },
+		{ 11106, 22318, 8, 0 },
+		{ 11115, 22386, 8, 0 },
+		{ 11124, 324, 5, 0 },
+		{ 11130, 22457, 12, 1 },
+		{ 11143, 22546, 12, 1 },
+		{ 11156, 22615, 12, 1 },
+		{ 11169, 22646, 11, 1 },
+		{ 11181, 22674, 12, 1 },
+		{ 11194, 22694, 14, 1 },
+		{ 11209, 22721, 12, 1 },
+		{ 11222, 22646, 11, 1 },
+		{ 11234, 22646, 10, 1 },
+		{ 11245, 22694, 14, 1 },
+		{ 11260, 22646, 12, 1 },
+		{ 11273, 22646, 13, 1 },
+		{ 11287, 22751, 6, 0 },
+		{ 11294, 22774, 8, 0 },
+		{ 11303, 22814, 8, 0 },
+		{ 11312, 22836, 4, 0 },
+		{ 11317, 22856, 6, 0 },
+		{ 11324, 324, 4, 0 },
+		{ 11329, 13305, 14, 1 },
+		{ 11344, 1629, 11, 1 },
+		{ 11356, 22881, 11, 1 },
+		{ 11368, 13387, 14, 1 },
+		{ 11383, 22901, 6, 0 },
+		{ 11390, 2436, 18, 0 },
+		{ 11409, 324, 4, 0 },
+		{ 11414, 19691, 21, 1 },
+		{ 11436, 22967, 14, 1 },
+		{ 11451, 19633, 17, 1 },
+		{ 11469, 23067, 17, 1 },
+		{ 11487, 23114, 16, 1 },
+		{ 11504, 19633, 13, 1 },
+		{ 11518, 23207, 8, 1 },
+		{ 11527, 6459, 14, 1 },
+		{ 11542, 23239, 10, 1 },
+		{ 11553, 23298, 15, 1 },
+		{ 11569, 23356, 19, 1 },
+		{ 11589, 23434, 11, 1 },
+		{ 11601, 23553, 17, 1 },
+		{ 11619, 23575, 26, 1 },
+		{ 11646, 23599, 19, 1 },
+		{ 11666, 23654, 19, 1 },
+		{ 11686, 23675, 20, 1 },
+		{ 11707, 23706, 24, 1 },
+		{ 11732, 23834, 26, 1 },
+		{ 11759, 23926, 14, 1 },
+		{ 11774, 9708, 17, 1 },
+		{ 11792, 9708, 16, 1 },
+		{ 11809, 23955, 16, 1 },
+		{ 11826, 24043, 21, 1 },
+		{ 11848, 24141, 17, 1 },
+		{ 11866, 24190, 22, 1 },
+		{ 11889, 24223, 22, 1 },
+		{ 11912, 24256, 17, 1 },
+		{ 11930, 24325, 18, 1 },
+		{ 11949, 24353, 18, 1 },
+		{ 11968, 24372, 18, 1 },
+		{ 11987, 24391, 15, 1 },
+		{ 12003, 24446, 9, 1 },
+		{ 12013, 24446, 11, 1 },
+		{ 12025, 24471, 17, 1 },
+		{ 12043, 24552, 16, 1 },
+		{ 12060, 24715, 10, 1 },
+		{ 12071, 24727, 18, 1 },
+		{ 12090, 24727, 16, 1 },
+		{ 12107, 24749, 16, 1 },
+		{ 12124, 24802, 21, 1 },
+		{ 12146, 24865, 10, 1 },
+		{ 12157, 24898, 16, 1 },
+		{ 12174, 24937, 14, 1 },
+		{ 12189, 24937, 14, 1 },
+		{ 12204, 24964, 17, 1 },
+		{ 12222, 9708, 19, 0 },
+		{ 12242, 24986, 10, 0 },
+		{ 12253, 25011, 6, 0 },
+		{ 12260, 25064, 10, 0 },
+		{ 12271, 324, 4, 0 },
+		{ 12276, 25108, 11, 1 },
+		{ 12288, 25175, 20, 1 },
+		{ 12309, 6472, 18, 1 },
+		{ 12328, 25241, 11, 1 },
+		{ 12340, 25271, 21, 1 },
+		{ 12362, 520, 11, 1 },
+		{ 12374, 25297, 20, 1 },
+		{ 12395, 8307, 20, 1 },
+		{ 12416, 8307, 21, 1 },
+		{ 12438, 8307, 18, 1 },
+		{ 12457, 6472, 20, 1 },
+		{ 12478, 25325, 13, 1 },
+		{ 12492, 2436, 13, 0 },
+		{ 12506, 17004, 8, 0 },
+		{ 12515, 324, 7, 0 },
+		{ 12523, 17545, 11, 1 },
+		{ 12535, 520, 15, 1 },
+		{ 12551, 25398, 17, 1 },
+		{ 12569, 25429, 17, 1 },
+		{ 12587, 25467, 16, 1 },
+		{ 12604, 25504, 12, 0 },
+		{ 12617, 25599, 6, 0 },
+	};
+
+	const char Names[] =
+		"_G\0"
+		"AccessorFunc\0"
+		"AddConsoleCommand\0"
+		"AddCSLuaFile\0"
+		"Angle\0"
+		"AngleRand\0"
+		"assert\0"
+		"bit\0"
+		"bit.arshift\0"
+		"bit.band\0"
+		"bit.bnot\0"
+		"bit.bor\0"
+		"bit.bswap\0"
+		"bit.bxor\0"
+		"bit.lshift\0"
+		"bit.rol\0"
+		"bit.ror\0"
+		"bit.rshift\0"
+		"bit.tobit\0"
+		"bit.tohex\0"
+		"BroadcastLua\0"
+		"BuildNetworkedVarsTable\0"
+		"cam\0"
+		"cam.ApplyShake\0"
+		"cam.End\0"
+		"cam.End2D\0"
+		"cam.End3D\0"
+		"cam.End3D2D\0"
+		"cam.EndOrthoView\0"
+		"cam.GetModelMatrix\0"
+		"cam.IgnoreZ\0"
+		"cam.PopModelMatrix\0"
+		"cam.PushModelMatrix\0"
+		"cam.Start\0"
+		"cam.Start2D\0"
+		"cam.Start3D\0"
+		"cam.Start3D2D\0"
+		"cam.StartOrthoView\0"
+		"ChangeTooltip\0"
+		"chat\0"
+		"chat.AddText\0"
+		"chat.Close\0"
+		"chat.GetChatBoxPos\0"
+		"chat.GetChatBoxSize\0"
+		"chat.Open\0"
+		"chat.PlaySound\0"
+		"ClientsideModel\0"
+		"ClientsideRagdoll\0"
+		"ClientsideScene\0"
+		"Color\0"
+		"ColorAlpha\0"
+		"ColorRand\0"
+		"ColorToHSL\0"
+		"ColorToHSV\0"
+		"CompileFile\0"
+		"CompileString\0"
+		"concommand\0"
+		"concommand.Add\0"
+		"concommand.AutoComplete\0"
+		"concommand.GetTable\0"
+		"concommand.Remove\0"
+		"concommand.Run\0"
+		"ConVarExists\0"
+		"cookie\0"
+		"cookie.Delete\0"
+		"cookie.GetNumber\0"
+		"cookie.GetString\0"
+		"cookie.Set\0"
+		"coroutine\0"
+		"coroutine.create\0"
+		"coroutine.resume\0"
+		"coroutine.running\0"
+		"coroutine.status\0"
+		"coroutine.wait\0"
+		"coroutine.wrap\0"
+		"coroutine.yield\0"
+		"CreateClientConVar\0"
+		"CreateConVar\0"
+		"CreateMaterial\0"
+		"CreateSound\0"
+		"CurTime\0"
+		"cvars\0"
+		"cvars.AddChangeCallback\0"
+		"cvars.Bool\0"
+		"cvars.GetConVarCallbacks\0"
+		"cvars.Number\0"
+		"cvars.OnConVarChanged\0"
+		"cvars.RemoveChangeCallback\0"
+		"cvars.String\0"
+		"DamageInfo\0"
+		"debug\0"
+		"debug.debug\0"
+		"debug.getfenv\0"
+		"debug.gethook\0"
+		"debug.getinfo\0"
+		"debug.getlocal\0"
+		"debug.getmetatable\0"
+		"debug.getregistry\0"
+		"debug.getupvalue\0"
+		"debug.sethook\0"
+		"debug.setlocal\0"
+		"debug.setmetatable\0"
+		"debug.setupvalue\0"
+		"debug.Trace\0"
+		"debug.traceback\0"
+		"debug.upvalueid\0"
+		"debug.upvaluejoin\0"
+		"DebugInfo\0"
+		"DeriveGamemode\0"
+		"Derma_DrawBackgroundBlur\0"
+		"Derma_Message\0"
+		"Derma_Query\0"
+		"Derma_StringRequest\0"
+		"DermaMenu\0"
+		"DisableClipping\0"
+		"draw\0"
+		"draw.DrawText\0"
+		"draw.GetFontHeight\0"
+		"draw.NoTexture\0"
+		"draw.RoundedBox\0"
+		"draw.RoundedBoxEx\0"
+		"draw.SimpleText\0"
+		"draw.SimpleTextOutlined\0"
+		"draw.Text\0"
+		"draw.TextShadow\0"
+		"draw.TexturedQuad\0"
+		"draw.WordBox\0"
+		"DrawBloom\0"
+		"DrawColorModify\0"
+		"DrawMaterialOverlay\0"
+		"DrawMotionBlur\0"
+		"DrawSharpen\0"
+		"DrawSobel\0"
+		"DrawSunbeams\0"
+		"DrawTexturize\0"
+		"DrawToyTown\0"
+		"DynamicLight\0"
+		"EffectData\0"
+		"effects\0"
+		"effects.BeamRingPoint\0"
+		"effects.Bubbles\0"
+		"effects.BubbleTrail\0"
+		"effects.Create\0"
+		"EmitSentence\0"
+		"EmitSound\0"
+		"engine\0"
+		"engine.ActiveGamemode\0"
+		"engine.GetAddons\0"
+		"engine.GetDemoPlaybackTick\0"
+		"engine.GetGames\0"
+		"engine.GetUserContent\0"
+		"engine.IsPlayingDemo\0"
+		"engine.IsRecordingDemo\0"
+		"engine.TickCount\0"
+		"engine.TickInterval\0"
+		"Entity\0"
+		"ents\0"
+		"ents.Create\0"
+		"ents.CreateClientProp\0"
+		"ents.FindAlongRay\0"
+		"ents.FindByClass\0"
+		"ents.FindByClassAndParent\0"
+		"ents.FindByModel\0"
+		"ents.FindByName\0"
+		"ents.FindInBox\0"
+		"ents.FindInCone\0"
+		"ents.FindInPVS\0"
+		"ents.FindInSphere\0"
+		"ents.GetAll\0"
+		"ents.GetByIndex\0"
+		"ents.GetCount\0"
+		"ents.GetEdictCount\0"
+		"ents.Iterator\0"
+		"error\0"
+		"ErrorNoHalt\0"
+		"ErrorNoHaltWithStack\0"
+		"EyeAngles\0"
+		"EyePos\0"
+		"EyeVector\0"
+		"file\0"
+		"file.Append\0"
+		"file.AsyncRead\0"
+		"file.CreateDir\0"
+		"file.Delete\0"
+		"file.Exists\0"
+		"file.Find\0"
+		"file.IsDir\0"
+		"file.Open\0"
+		"file.Read\0"
+		"file.Rename\0"
+		"file.Size\0"
+		"file.Time\0"
+		"file.Write\0"
+		"FindMetaTable\0"
+		"FrameNumber\0"
+		"FrameTime\0"
+		"game\0"
+		"game.AddAmmoType\0"
+		"game.AddDecal\0"
+		"game.AddParticles\0"
+		"game.CleanUpMap\0"
+		"game.GetAmmoID\0"
+		"game.GetAmmoName\0"
+		"game.GetIPAddress\0"
+		"game.GetMap\0"
+		"game.GetSkillLevel\0"
+		"game.GetTimeScale\0"
+		"game.GetWorld\0"
+		"game.IsDedicated\0"
+		"game.MaxPlayers\0"
+		"game.SinglePlayer\0"
+		"gameevent\0"
+		"gameevent.Listen\0"
+		"GAMEMODE\0"
+		"GetConVar\0"
+		"GetConVarNumber\0"
+		"GetConVarString\0"
+		"getfenv\0"
+		"GetGlobalAngle\0"
+		"GetGlobalBool\0"
+		"GetGlobalEntity\0"
+		"GetGlobalFloat\0"
+		"GetGlobalInt\0"
+		"GetGlobalString\0"
+		"GetGlobalVector\0"
+		"GetHostName\0"
+		"GetHUDPanel\0"
+		"getmetatable\0"
+		"GetRenderTarget\0"
+		"GetRenderTargetEx\0"
+		"GetViewEntity\0"
+		"GM\0"
+		"gmod\0"
+		"gmod.GetGamemode\0"
+		"gui\0"
+		"gui.ActivateGameUI\0"
+		"gui.EnableScreenClicker\0"
+		"gui.HideGameUI\0"
+		"gui.InternalCursorMoved\0"
+		"gui.IsConsoleVisible\0"
+		"gui.IsGameUIVisible\0"
+		"gui.MousePos\0"
+		"gui.MouseX\0"
+		"gui.MouseY\0"
+		"gui.OpenURL\0"
+		"gui.ScreenToVector\0"
+		"gui.SetMousePos\0"
+		"halo\0"
+		"halo.Add\0"
+		"halo.RenderedEntity\0"
+		"hook\0"
+		"hook.Add\0"
+		"hook.Call\0"
+		"hook.GetTable\0"
+		"hook.Remove\0"
+		"hook.Run\0"
+		"HSLToColor\0"
+		"HSVToColor\0"
+		"HTTP\0"
+		"http\0"
+		"http.Fetch\0"
+		"http.Post\0"
+		"include\0"
+		"input\0"
+		"input.CheckKeyTrapping\0"
+		"input.GetCursorPos\0"
+		"input.GetKeyCode\0"
+		"input.GetKeyName\0"
+		"input.IsButtonDown\0"
+		"input.IsControlDown\0"
+		"input.IsKeyDown\0"
+		"input.IsKeyTrapping\0"
+		"input.IsMouseDown\0"
+		"input.IsShiftDown\0"
+		"input.LookupBinding\0"
+		"input.LookupKeyBinding\0"
+		"input.SelectWeapon\0"
+		"input.SetCursorPos\0"
+		"input.StartKeyTrapping\0"
+		"input.WasKeyPressed\0"
+		"input.WasKeyReleased\0"
+		"input.WasMousePressed\0"
+		"ipairs\0"
+		"isangle\0"
+		"isbool\0"
+		"IsColor\0"
+		"IsEnemyEntityName\0"
+		"IsEntity\0"
+		"isentity\0"
+		"IsFirstTimePredicted\0"
+		"isfunction\0"
+		"IsMounted\0"
+		"isnumber\0"
+		"ispanel\0"
+		"isstring\0"
+		"istable\0"
+		"IsTableOfEntitiesValid\0"
+		"IsUselessModel\0"
+		"IsValid\0"
+		"isvector\0"
+		"jit\0"
+		"jit.flush\0"
+		"jit.off\0"
+		"jit.on\0"
+		"jit.status\0"
+		"killicon\0"
+		"killicon.Add\0"
+		"killicon.AddAlias\0"
+		"killicon.AddFont\0"
+		"killicon.Draw\0"
+		"killicon.Exists\0"
+		"killicon.GetSize\0"
+		"Label\0"
+		"language\0"
+		"language.Add\0"
+		"language.GetPhrase\0"
+		"Lerp\0"
+		"LerpAngle\0"
+		"LerpVector\0"
+		"list\0"
+		"list.Add\0"
+		"list.Contains\0"
+		"list.Get\0"
+		"list.GetForEdit\0"
+		"list.HasEntry\0"
+		"list.Set\0"
+		"LocalPlayer\0"
+		"LocalToWorld\0"
+		"markup\0"
+		"markup.Escape\0"
+		"markup.Parse\0"
+		"Material\0"
+		"math\0"
+		"math.abs\0"
+		"math.acos\0"
+		"math.AngleDifference\0"
+		"math.Approach\0"
+		"math.ApproachAngle\0"
+		"math.asin\0"
+		"math.atan\0"
+		"math.atan2\0"
+		"math.BinToInt\0"
+		"math.BSplinePoint\0"
+		"math.ceil\0"
+		"math.Clamp\0"
+		"math.cos\0"
+		"math.cosh\0"
+		"math.deg\0"
+		"math.Distance\0"
+		"math.DistanceSqr\0"
+		"math.EaseInOut\0"
+		"math.exp\0"
+		"math.floor\0"
+		"math.fmod\0"
+		"math.frexp\0"
+		"math.huge\0"
+		"math.IntToBin\0"
+		"math.IsNearlyEqual\0"
+		"math.ldexp\0"
+		"math.log\0"
+		"math.log10\0"
+		"math.max\0"
+		"math.min\0"
+		"math.mod\0"
+		"math.modf\0"
+		"math.NormalizeAngle\0"
+		"math.pi\0"
+		"math.pow\0"
+		"math.rad\0"
+		"math.Rand\0"
+		"math.random\0"
+		"math.randomseed\0"
+		"math.Remap\0"
+		"math.Round\0"
+		"math.sin\0"
+		"math.sinh\0"
+		"math.SnapTo\0"
+		"math.sqrt\0"
+		"math.tan\0"
+		"math.tanh\0"
+		"math.TimeFraction\0"
+		"math.Truncate\0"
+		"Matrix\0"
+		"Mesh\0"
+		"mesh\0"
+		"mesh.AdvanceVertex\0"
+		"mesh.Begin\0"
+		"mesh.Color\0"
+		"mesh.End\0"
+		"mesh.Normal\0"
+		"mesh.Position\0"
+		"mesh.Quad\0"
+		"mesh.QuadEasy\0"
+		"mesh.TexCoord\0"
+		"Model\0"
+		"Msg\0"
+		"MsgC\0"
+		"MsgN\0"
+		"navmesh\0"
+		"navmesh.Find\0"
+		"navmesh.GetAllNavAreas\0"
+		"navmesh.GetNavArea\0"
+		"navmesh.GetNearestNavArea\0"
+		"navmesh.IsLoaded\0"
+		"net\0"
+		"net.Abort\0"
+		"net.Broadcast\0"
+		"net.BytesLeft\0"
+		"net.BytesWritten\0"
+		"net.Incoming\0"
+		"net.ReadAngle\0"
+		"net.ReadBit\0"
+		"net.ReadBool\0"
+		"net.ReadColor\0"
+		"net.ReadData\0"
+		"net.ReadDouble\0"
+		"net.ReadEntity\0"
+		"net.ReadFloat\0"
+		"net.ReadHeader\0"
+		"net.ReadInt\0"
+		"net.ReadMatrix\0"
+		"net.ReadNormal\0"
+		"net.ReadPlayer\0"
+		"net.ReadString\0"
+		"net.ReadTable\0"
+		"net.ReadType\0"
+		"net.ReadUInt\0"
+		"net.ReadUInt64\0"
+		"net.ReadVector\0"
+		"net.Receive\0"
+		"net.Receivers\0"
+		"net.Send\0"
+		"net.SendOmit\0"
+		"net.SendPAS\0"
+		"net.SendPVS\0"
+		"net.SendToServer\0"
+		"net.Start\0"
+		"net.WriteAngle\0"
+		"net.WriteBit\0"
+		"net.WriteBool\0"
+		"net.WriteColor\0"
+		"net.WriteData\0"
+		"net.WriteDouble\0"
+		"net.WriteEntity\0"
+		"net.WriteFloat\0"
+		"net.WriteInt\0"
+		"net.WriteMatrix\0"
+		"net.WriteNormal\0"
+		"net.WritePlayer\0"
+		"net.WriteString\0"
+		"net.WriteTable\0"
+		"net.WriteType\0"
+		"net.WriteUInt\0"
+		"net.WriteUInt64\0"
+		"net.WriteVector\0"
+		"next\0"
+		"notification\0"
+		"notification.AddLegacy\0"
+		"notification.AddProgress\0"
+		"notification.Kill\0"
+		"NumModelSkins\0"
+		"OnModelLoaded\0"
+		"os\0"
+		"os.clock\0"
+		"os.date\0"
+		"os.difftime\0"
+		"os.getenv\0"
+		"os.time\0"
+		"pairs\0"
+		"Particle\0"
+		"ParticleEffect\0"
+		"ParticleEffectAttach\0"
+		"ParticleEmitter\0"
+		"Path\0"
+		"pcall\0"
+		"physenv\0"
+		"physenv.GetGravity\0"
+		"physenv.GetPerformanceSettings\0"
+		"Player\0"
+		"player\0"
+		"player.CreateNextBot\0"
+		"player.GetAll\0"
+		"player.GetBots\0"
+		"player.GetByID\0"
+		"player.GetBySteamID\0"
+		"player.GetBySteamID64\0"
+		"player.GetCount\0"
+		"player.GetHumans\0"
+		"player.Iterator\0"
+		"player_manager\0"
+		"player_manager.AddValidModel\0"
+		"player_manager.AllValidModels\0"
+		"player_manager.TranslatePlayerModel\0"
+		"print\0"
+		"PrintMessage\0"
+		"PrintTable\0"
+		"ProjectedTexture\0"
+		"properties\0"
+		"properties.Add\0"
+		"properties.GetHovered\0"
+		"rawequal\0"
+		"rawget\0"
+		"rawset\0"
+		"RealFrameTime\0"
+		"RealTime\0"
+		"RecipientFilter\0"
+		"RegisterDermaMenuForClose\0"
+		"render\0"
+		"render.AddBeam\0"
+		"render.BlurRenderTarget\0"
+		"render.Capture\0"
+		"render.Clear\0"
+		"render.ClearDepth\0"
+		"render.ClearStencil\0"
+		"render.CopyRenderTargetToTexture\0"
+		"render.DepthRange\0"
+		"render.DrawBeam\0"
+		"render.DrawBox\0"
+		"render.DrawLine\0"
+		"render.DrawQuad\0"
+		"render.DrawQuadEasy\0"
+		"render.DrawScreenQuad\0"
+		"render.DrawSphere\0"
+		"render.DrawSprite\0"
+		"render.DrawTextureToScreen\0"
+		"render.DrawWireframeBox\0"
+		"render.DrawWireframeSphere\0"
+		"render.GetLightColor\0"
+		"render.GetRenderTarget\0"
+		"render.GetScreenEffectTexture\0"
+		"render.GetViewSetup\0"
+		"render.MaterialOverride\0"
+		"render.OverrideAlphaWriteEnable\0"
+		"render.OverrideBlend\0"
+		"render.OverrideDepthEnable\0"
+		"render.PopFilterMag\0"
+		"render.PopFilterMin\0"
+		"render.PopRenderTarget\0"
+		"render.PushFilterMag\0"
+		"render.PushFilterMin\0"
+		"render.PushRenderTarget\0"
+		"render.ReadPixel\0"
+		"render.RenderView\0"
+		"render.SetBlend\0"
+		"render.SetColorMaterial\0"
+		"render.SetColorModulation\0"
+		"render.SetLightingMode\0"
+		"render.SetMaterial\0"
+		"render.SetRenderTarget\0"
+		"render.SetScissorRect\0"
+		"render.SetStencilCompareFunction\0"
+		"render.SetStencilEnable\0"
+		"render.SetStencilFailOperation\0"
+		"render.SetStencilPassOperation\0"
+		"render.SetStencilReferenceValue\0"
+		"render.SetStencilTestMask\0"
+		"render.SetStencilWriteMask\0"
+		"render.SetStencilZFailOperation\0"
+		"render.SetViewPort\0"
+		"render.SuppressEngineLighting\0"
+		"render.UpdateScreenEffectTexture\0"
+		"RenderAngles\0"
+		"RenderDoF\0"
+		"RenderStereoscopy\0"
+		"RenderSuperDoF\0"
+		"require\0"
+		"resource\0"
+		"resource.AddFile\0"
+		"resource.AddWorkshop\0"
+		"RunConsoleCommand\0"
+		"RunString\0"
+		"RunStringEx\0"
+		"SafeRemoveEntity\0"
+		"SafeRemoveEntityDelayed\0"
+		"ScreenScale\0"
+		"ScreenScaleH\0"
+		"ScrH\0"
+		"scripted_ents\0"
+		"scripted_ents.Get\0"
+		"scripted_ents.GetList\0"
+		"scripted_ents.GetStored\0"
+		"scripted_ents.Register\0"
+		"ScrW\0"
+		"select\0"
+		"SetClipboardText\0"
+		"setfenv\0"
+		"SetGlobalAngle\0"
+		"SetGlobalBool\0"
+		"SetGlobalEntity\0"
+		"SetGlobalFloat\0"
+		"SetGlobalInt\0"
+		"SetGlobalString\0"
+		"SetGlobalVector\0"
+		"setmetatable\0"
+		"SortedPairs\0"
+		"SortedPairsByMemberValue\0"
+		"SortedPairsByValue\0"
+		"Sound\0"
+		"sound\0"
+		"sound.Add\0"
+		"sound.GetProperties\0"
+		"sound.GetTable\0"
+		"sound.Play\0"
+		"sound.PlayFile\0"
+		"sound.PlayURL\0"
+		"SoundDuration\0"
+		"spawnmenu\0"
+		"spawnmenu.ActivateTool\0"
+		"spawnmenu.AddToolMenuOption\0"
+		"sql\0"
+		"sql.Begin\0"
+		"sql.Commit\0"
+		"sql.LastError\0"
+		"sql.Query\0"
+		"sql.QueryRow\0"
+		"sql.QueryValue\0"
+		"sql.SQLStr\0"
+		"sql.TableExists\0"
+		"steamworks\0"
+		"steamworks.DownloadUGC\0"
+		"steamworks.FileInfo\0"
+		"steamworks.IsSubscribed\0"
+		"steamworks.OpenWorkshop\0"
+		"steamworks.ViewFile\0"
+		"STNDRD\0"
+		"string\0"
+		"string.byte\0"
+		"string.char\0"
+		"string.Comma\0"
+		"string.EndsWith\0"
+		"string.Explode\0"
+		"string.find\0"
+		"string.format\0"
+		"string.FormattedTime\0"
+		"string.FromColor\0"
+		"string.GetExtensionFromFilename\0"
+		"string.GetFileFromFilename\0"
+		"string.GetPathFromFilename\0"
+		"string.gmatch\0"
+		"string.gsub\0"
+		"string.Implode\0"
+		"string.JavascriptSafe\0"
+		"string.Left\0"
+		"string.len\0"
+		"string.lower\0"
+		"string.match\0"
+		"string.NiceSize\0"
+		"string.NiceTime\0"
+		"string.PatternSafe\0"
+		"string.rep\0"
+		"string.Replace\0"
+		"string.reverse\0"
+		"string.Right\0"
+		"string.SetChar\0"
+		"string.Split\0"
+		"string.StartsWith\0"
+		"string.StripExtension\0"
+		"string.sub\0"
+		"string.ToColor\0"
+		"string.ToMinutesSeconds\0"
+		"string.ToMinutesSecondsMilliseconds\0"
+		"string.ToTable\0"
+		"string.Trim\0"
+		"string.TrimLeft\0"
+		"string.TrimRight\0"
+		"string.upper\0"
+		"SuppressHostEvents\0"
+		"surface\0"
+		"surface.CreateFont\0"
+		"surface.DisableClipping\0"
+		"surface.DrawCircle\0"
+		"surface.DrawLine\0"
+		"surface.DrawOutlinedRect\0"
+		"surface.DrawPoly\0"
+		"surface.DrawRect\0"
+		"surface.DrawText\0"
+		"surface.DrawTexturedRect\0"
+		"surface.DrawTexturedRectRotated\0"
+		"surface.DrawTexturedRectUV\0"
+		"surface.GetAlphaMultiplier\0"
+		"surface.GetDrawColor\0"
+		"surface.GetHUDTexture\0"
+		"surface.GetTextColor\0"
+		"surface.GetTextPos\0"
+		"surface.GetTextSize\0"
+		"surface.GetTextureID\0"
+		"surface.PlaySound\0"
+		"surface.ScreenHeight\0"
+		"surface.ScreenWidth\0"
+		"surface.SetAlphaMultiplier\0"
+		"surface.SetDrawColor\0"
+		"surface.SetFont\0"
+		"surface.SetMaterial\0"
+		"surface.SetTextColor\0"
+		"surface.SetTextPos\0"
+		"surface.SetTexture\0"
+		"system\0"
+		"system.AppTime\0"
+		"system.GetCountry\0"
+		"system.HasFocus\0"
+		"system.IsLinux\0"
+		"system.IsOSX\0"
+		"system.IsWindowed\0"
+		"system.IsWindows\0"
+		"system.SteamTime\0"
+		"system.UpTime\0"
+		"SysTime\0"
+		"table\0"
+		"table.Add\0"
+		"table.ClearKeys\0"
+		"table.CollapseKeyValue\0"
+		"table.concat\0"
+		"table.Copy\0"
+		"table.CopyFromTo\0"
+		"table.Count\0"
+		"table.Empty\0"
+		"table.Flip\0"
+		"table.ForceInsert\0"
+		"table.GetKeys\0"
+		"table.GetLastKey\0"
+		"table.GetLastValue\0"
+		"table.GetWinningKey\0"
+		"table.HasValue\0"
+		"table.Inherit\0"
+		"table.insert\0"
+		"table.IsEmpty\0"
+		"table.IsSequential\0"
+		"table.KeyFromValue\0"
+		"table.KeysFromValue\0"
+		"table.LowerKeyNames\0"
+		"table.maxn\0"
+		"table.Merge\0"
+		"table.Random\0"
+		"table.remove\0"
+		"table.RemoveByValue\0"
+		"table.Reverse\0"
+		"table.sort\0"
+		"table.SortByKey\0"
+		"table.SortByMember\0"
+		"table.SortDesc\0"
+		"table.ToString\0"
+		"TauntCamera\0"
+		"team\0"
+		"team.GetAllTeams\0"
+		"team.GetColor\0"
+		"team.GetName\0"
+		"team.GetPlayers\0"
+		"team.GetScore\0"
+		"team.NumPlayers\0"
+		"team.SetUp\0"
+		"team.Valid\0"
+		"TimedCos\0"
+		"TimedSin\0"
+		"timer\0"
+		"timer.Adjust\0"
+		"timer.Create\0"
+		"timer.Exists\0"
+		"timer.Pause\0"
+		"timer.Remove\0"
+		"timer.RepsLeft\0"
+		"timer.Simple\0"
+		"timer.Start\0"
+		"timer.Stop\0"
+		"timer.TimeLeft\0"
+		"timer.Toggle\0"
+		"timer.UnPause\0"
+		"tobool\0"
+		"tonumber\0"
+		"tostring\0"
+		"type\0"
+		"TypeID\0"
+		"undo\0"
+		"undo.AddEntity\0"
+		"undo.Create\0"
+		"undo.Finish\0"
+		"undo.SetPlayer\0"
+		"unpack\0"
+		"UnPredictedCurTime\0"
+		"util\0"
+		"util.AddNetworkString\0"
+		"util.AimVector\0"
+		"util.Base64Decode\0"
+		"util.Base64Encode\0"
+		"util.BlastDamage\0"
+		"util.Compress\0"
+		"util.CRC\0"
+		"util.DateStamp\0"
+		"util.Decal\0"
+		"util.Decompress\0"
+		"util.DistanceToLine\0"
+		"util.Effect\0"
+		"util.GetModelInfo\0"
+		"util.GetPixelVisibleHandle\0"
+		"util.GetPlayerTrace\0"
+		"util.GetSurfaceData\0"
+		"util.GetSurfaceIndex\0"
+		"util.IntersectRayWithOBB\0"
+		"util.IntersectRayWithPlane\0"
+		"util.IsInWorld\0"
+		"util.IsValidModel\0"
+		"util.IsValidProp\0"
+		"util.JSONToTable\0"
+		"util.KeyValuesToTable\0"
+		"util.LocalToWorld\0"
+		"util.NetworkIDToString\0"
+		"util.NetworkStringToID\0"
+		"util.PixelVisible\0"
+		"util.PointContents\0"
+		"util.PrecacheModel\0"
+		"util.PrecacheSound\0"
+		"util.QuickTrace\0"
+		"util.SHA1\0"
+		"util.SHA256\0"
+		"util.SharedRandom\0"
+		"util.SpriteTrail\0"
+		"util.Stack\0"
+		"util.SteamIDFrom64\0"
+		"util.SteamIDTo64\0"
+		"util.TableToJSON\0"
+		"util.TableToKeyValues\0"
+		"util.Timer\0"
+		"util.TraceEntity\0"
+		"util.TraceHull\0"
+		"util.TraceLine\0"
+		"util.TypeToString\0"
+		"UTIL_IsUselessModel\0"
+		"ValidPanel\0"
+		"Vector\0"
+		"VectorRand\0"
+		"vgui\0"
+		"vgui.Create\0"
+		"vgui.CreateFromTable\0"
+		"vgui.CursorVisible\0"
+		"vgui.Exists\0"
+		"vgui.FocusedHasParent\0"
+		"vgui.GetAll\0"
+		"vgui.GetControlTable\0"
+		"vgui.GetHoveredPanel\0"
+		"vgui.GetKeyboardFocus\0"
+		"vgui.GetWorldPanel\0"
+		"vgui.IsHoveringWorld\0"
+		"vgui.Register\0"
+		"VGUIFrameTime\0"
+		"VGUIRect\0"
+		"weapons\0"
+		"weapons.Get\0"
+		"weapons.GetList\0"
+		"weapons.GetStored\0"
+		"weapons.IsBasedOn\0"
+		"weapons.Register\0"
+		"WorldToLocal\0"
+		"xpcall\0"
+		;
+
+	const char Details[] =
+		"table\0"
+		"(table target, string key, string name, number forceType = nil)\0"
+		"(string name, string helpText, number flags)\0"
+		"(string file = current file)\0"
+		"(number pitch = 0, number yaw = 0, number roll = 0) -> Angle\0"
+		"(number min = -360, number max = 360) -> Angle\0"
+		"(any expression, string errorMessage = \"assertion failed!\", ...) -> any\0"
+		"library\0"
+		"(number value, number shiftCount) -> number\0"
+		"(number value, ...) -> number\0"
+		"(number value) -> number\0"
+		"(number value1, ...) -> number\0"
+		"(number value, number digits = 8) -> string\0"
+		"(string code)\0"
+		"() -> table\0"
+		"(Vector pos, Angle angles, number factor)\0"
+		"()\0"
+		"() -> VMatrix\0"
+		"(boolean ignoreZ)\0"
+		"(VMatrix matrix, boolean multiply = false)\0"
+		"(table dataTbl)\0"
+		"(Vector pos = EyePos(), Angle angles = EyeAngles(), number fov = nil, number x = 0, number y = 0, number w = ScrW(), number h = ScrH(), number zNear = nil, number zFar = nil)\0"
+		"(Vector pos, Angle angles, number scale)\0"
+		"(number leftOffset, number topOffset, number rightOffset, number bottomOffset)\0"
+		"(Panel panel)\0"
+		"(...)\0"
+		"() -> number, number\0"
+		"(number mode = 1)\0"
+		"(string model, number renderGroup = RENDERGROUP_OTHER) -> CSEnt\0"
+		"(string model, number renderGroup = RENDERGROUP_OPAQUE) -> CSEnt\0"
+		"(string name, Entity targetEnt) -> CSEnt\0"
+		"(number r, number g, number b, number a = 255) -> Color\0"
+		"(table color, number alpha) -> table\0"
+		"(boolean randomAlpha = false) -> table\0"
+		"(table color) -> number, number, number\0"
+		"(string path) -> function\0"
+		"(string code, string identifier, boolean handleError = true) -> function\0"
+		"(string name, function callback, function autoComplete = nil, string helpText = nil, number flags = 0)\0"
+		"(string command, string arguments) -> table\0"
+		"() -> table, table\0"
+		"(string name)\0"
+		"(Player ply, string cmd, any args, string argumentString) -> boolean\0"
+		"(string name) -> boolean\0"
+		"(string name, any default = nil) -> number\0"
+		"(string name, any default = nil) -> string\0"
+		"(string key, string value)\0"
+		"(function func) -> thread\0"
+		"(thread coroutine, ...) -> boolean, ...\0"
+		"() -> thread\0"
+		"(thread coroutine) -> string\0"
+		"(number duration)\0"
+		"(function coroutine) -> function\0"
+		"(...) -> any\0"
+		"(string name, string default, boolean shouldsave = true, boolean userinfo = false, string helptext = \"\", number min = nil, number max = nil) -> ConVar\0"
+		"(string name, string value, number flags = FCVAR_NONE, string helptext, number min = nil, number max = nil) -> ConVar\0"
+		"(string name, string shader, table materialData) -> IMaterial\0"
+		"(Entity targetEnt, string soundName, CRecipientFilter filter = nil) -> CSoundPatch\0"
+		"() -> number\0"
+		"(string name, function callback, string identifier = nil)\0"
+		"(string cvar, boolean default = false) -> boolean\0"
+		"(string name, boolean createIfNotFound = false) -> table\0"
+		"(string cvar, any default = nil) -> number\0"
+		"(string name, string oldVal, string newVal)\0"
+		"(string name, string identifier)\0"
+		"(string cvar, any default = nil) -> string\0"
+		"() -> CTakeDamageInfo\0"
+		"(any object) -> table\0"
+		"(thread thread = nil) -> function, string, number\0"
+		"(function funcOrStackLevel, string fields = \"flnSu\", function func = nil) -> table\0"
+		"(thread thread = Current thread, number level, number index) -> string, any\0"
+		"(function func, number index) -> string, any\0"
+		"(thread thread, function hook, string mask, number count)\0"
+		"(thread thread = Current Thread, number level, number index, any value = nil) -> string\0"
+		"(any object, table metatable) -> boolean\0"
+		"(function func, number index, any val = nil) -> string\0"
+		"(thread thread = current thread, string message = nil, number level = 1) -> string\0"
+		"(function func, number index) -> number\0"
+		"(function f1, number n1, function f2, number n2)\0"
+		"(number slot, string info)\0"
+		"(string base)\0"
+		"(Panel panel, number startTime)\0"
+		"(string text, string title, string buttonText) -> Panel\0"
+		"(string text = \"Message Text (Second Parameter)\", string title = \"Message Title (First Parameter)\", string btn1text, function btn1func = nil, ...) -> Panel\0"
+		"(string title, string subtitle, string default, function confirm, function cancel = nil, string confirmText = \"OK\", string cancelText = \"Cancel\") -> Panel\0"
+		"(boolean keepOpen = nil, Panel parent = nil) -> DMenu\0"
+		"(boolean disable) -> boolean\0"
+		"(string text, string font = \"DermaDefault\", number x = 0, number y = 0, table color = Color(255, 255, 255, 255), number xAlign = TEXT_ALIGN_LEFT)\0"
+		"(string font) -> number\0"
+		"(number cornerRadius, number x, number y, number width, number height, table color)\0"
+		"(number cornerRadius, number x, number y, number width, number height, table color, boolean roundTopLeft = false, boolean roundTopRight = false, boolean roundBottomLeft = false, boolean roundBottomRight = false)\0"
+		"(string text, string font = \"DermaDefault\", number x = 0, number y = 0, table color = Color(255, 255, 255, 255), number xAlign = TEXT_ALIGN_LEFT, number yAlign = TEXT_ALIGN_TOP) -> number, number\0"
+		"(string text, string font = \"DermaDefault\", number x = 0, number y = 0, table color = Color(255, 255, 255, 255), number xAlign = TEXT_ALIGN_LEFT, number yAlign = TEXT_ALIGN_TOP, number outlinewidth, table outlinecolor = Color(255, 255, 255, 255)) -> number, number\0"
+		"(table textdata) -> number, number\0"
+		"(table textdata, number distance, number alpha = 200) -> number, number\0"
+		"(table texturedata)\0"
+		"(number bordersize, number x, number y, string text, string font, table boxcolor, table textcolor, number xalign = TEXT_ALIGN_LEFT, number yalign = TEXT_ALIGN_TOP) -> number, number\0"
+		"(number darken, number multiply, number sizeX, number sizeY, number passes, number colorMultiply, number red, number green, number blue)\0"
+		"(table modifyParameters)\0"
+		"(string material, number refractAmount)\0"
+		"(number addAlpha, number drawAlpha, number delay)\0"
+		"(number contrast, number distance)\0"
+		"(number threshold)\0"
+		"(number darken, number multiplier, number sunSize, number sunX, number sunY)\0"
+		"(number scale, IMaterial baseTexture)\0"
+		"(number passes, number height)\0"
+		"(number index, boolean elight = false) -> table\0"
+		"() -> CEffectData\0"
+		"(Vector pos, number lifetime, number startRad, number endRad, number width, number amplitude, table color, table extra)\0"
+		"(Vector mins, Vector maxs, number count, number height, number speed = 0, number delay = 0)\0"
+		"(Vector startPos, Vector endPos, number count, number height, number speed = 0, number delay = 0)\0"
+		"(string name, table effectTable)\0"
+		"(string soundName, Vector position, number entity, number channel = CHAN_AUTO, number volume = 1, number soundLevel = 75, number soundFlags = 0, number pitch = 100)\0"
+		"(string soundName, Vector position, number entity = 0, number channel = CHAN_AUTO, number volume = 1, number soundLevel = 75, number soundFlags = 0, number pitch = 100, number dsp = 0)\0"
+		"() -> string\0"
+		"() -> boolean\0"
+		"(number entityIndex) -> Entity\0"
+		"(string class) -> Entity\0"
+		"(string model = \"models/error.mdl\") -> Entity\0"
+		"(Vector start, Vector end, Vector mins = nil, Vector maxs = nil) -> table\0"
+		"(string class) -> table\0"
+		"(string class, Entity parent) -> table\0"
+		"(string model) -> table\0"
+		"(string name) -> table\0"
+		"(Vector boxMins, Vector boxMaxs) -> table\0"
+		"(Vector origin, Vector normal, number range, number angleCos) -> table\0"
+		"(any viewPoint) -> table\0"
+		"(Vector origin, number radius) -> table\0"
+		"(number entIdx) -> Entity\0"
+		"(boolean includeKillMe = false) -> number\0"
+		"() -> function, table, number\0"
+		"(string message, number errorLevel = 1)\0"
+		"() -> Angle\0"
+		"() -> Vector\0"
+		"(string name, string content)\0"
+		"(string fileName, string gamePath, function callback, boolean sync = false) -> number\0"
+		"(string name, string gamePath) -> boolean\0"
+		"(string name, string path, string sorting = \"nameasc\") -> table, table\0"
+		"(string fileName, string gamePath) -> boolean\0"
+		"(string fileName, string fileMode, string gamePath = \"GAME\") -> File\0"
+		"(string fileName, string gamePath = \"DATA\") -> string\0"
+		"(string orignalFileName, string targetFileName) -> boolean\0"
+		"(string fileName, string gamePath) -> number\0"
+		"(string path, string gamePath) -> number\0"
+		"(string fileName, string content)\0"
+		"(string metaName) -> table\0"
+		"(table ammoData)\0"
+		"(string decalName, string materialName)\0"
+		"(string particleFileName)\0"
+		"(boolean dontSendToClients = false, table extraFilters = {})\0"
+		"(string name) -> number\0"
+		"(number id) -> string\0"
+		"() -> Entity\0"
+		"(string eventName)\0"
+		"(string name) -> ConVar\0"
+		"(string name) -> string\0"
+		"(function location = 1) -> table\0"
+		"(string index, Angle default = Angle(0, 0, 0)) -> Angle\0"
+		"(string index, boolean default = false) -> boolean\0"
+		"(string index, Entity default = NULL) -> Entity\0"
+		"(string index, number default = 0) -> number\0"
+		"(string index, string default = \"\") -> string\0"
+		"(string index, Vector default) -> Vector\0"
+		"() -> Panel\0"
+		"(any object) -> any\0"
+		"(string name, number width, number height) -> ITexture\0"
+		"(string name, number width, number height, number sizeMode, number depthMode, number textureFlags, number rtFlags, number imageFormat) -> ITexture\0"
+		"(boolean enabled)\0"
+		"(number x, number y)\0"
+		"(string url)\0"
+		"(number x, number y) -> Vector\0"
+		"(number mouseX, number mouseY)\0"
+		"(table entities, table color, number blurX = 2, number blurY = 2, number passes = 1, boolean additive = true, boolean ignoreZ = false)\0"
+		"(any eventName, any identifier, function func)\0"
+		"(string eventName, table gamemodeTable = nil, ...) -> ...\0"
+		"(string eventName, any identifier)\0"
+		"(string eventName, ...) -> ...\0"
+		"(number hue, number saturation, number lightness) -> table\0"
+		"(number hue, number saturation, number value) -> table\0"
+		"(table parameters) -> boolean\0"
+		"(string url, function onSuccess = nil, function onFailure = nil, table headers = {})\0"
+		"(string url, table parameters, function onSuccess = nil, function onFailure = nil, table headers = {})\0"
+		"(string fileName) -> ...\0"
+		"(string button) -> number\0"
+		"(number button) -> string\0"
+		"(number button) -> boolean\0"
+		"(number key) -> boolean\0"
+		"(number mouseKey) -> boolean\0"
+		"(string binding, boolean exact = false) -> string\0"
+		"(number key) -> string\0"
+		"(Weapon weapon)\0"
+		"(table tab) -> function, table, number\0"
+		"(any variable) -> boolean\0"
+		"(any object) -> boolean\0"
+		"(string className) -> boolean\0"
+		"(string game) -> boolean\0"
+		"(table table) -> boolean\0"
+		"(string modelName) -> boolean\0"
+		"(any toBeValidated) -> boolean\0"
+		"(any func = nil, boolean recursive = false)\0"
+		"() -> boolean, any\0"
+		"(string class, string material, table color)\0"
+		"(string class, string alias)\0"
+		"(string class, string font, string symbol, table color)\0"
+		"(number x, number y, string name, number alpha)\0"
+		"(string class) -> boolean\0"
+		"(string name) -> number, number\0"
+		"(string text, Panel parent = nil) -> Panel\0"
+		"(string placeholder, string fulltext)\0"
+		"(string phrase) -> string\0"
+		"(number t, number from, number to) -> number\0"
+		"(number ratio, Angle angleStart, Angle angleEnd) -> Angle\0"
+		"(number fraction, Vector from, Vector to) -> Vector\0"
+		"(string identifier, any item) -> number\0"
+		"(string list, any value) -> boolean\0"
+		"(string identifier) -> table\0"
+		"(string identifier, boolean dontCreate = false) -> table\0"
+		"(string list, any key) -> boolean\0"
+		"(string identifier, any key, any item)\0"
+		"() -> Player\0"
+		"(Vector localPos, Angle localAng, Vector originPos, Angle originAngle) -> Vector, Angle\0"
+		"(string text) -> string\0"
+		"(string markup, number maxWidth = nil) -> MarkupObject\0"
+		"(string materialName, string pngParameters = nil) -> IMaterial, number\0"
+		"(number x) -> number\0"
+		"(number cos) -> number\0"
+		"(number a, number b) -> number\0"
+		"(number current, number target, number change) -> number\0"
+		"(number currentAngle, number targetAngle, number rate) -> number\0"
+		"(number normal) -> number\0"
+		"(number y, number x) -> number\0"
+		"(string string) -> number\0"
+		"(number tDiff, table tPoints, number tMax) -> Vector\0"
+		"(number number) -> number\0"
+		"(number input, number min, number max) -> number\0"
+		"(number radians) -> number\0"
+		"(number x1, number y1, number x2, number y2) -> number\0"
+		"(number progress, number easeIn, number easeOut) -> number\0"
+		"(number exponent) -> number\0"
+		"(number base, number modulator) -> number\0"
+		"(number x) -> number, number\0"
+		"number\0"
+		"(number int) -> string\0"
+		"(number a, number b, number tolerance = 1e-8) -> boolean\0"
+		"(number normalizedFraction, number exponent) -> number\0"
+		"(number x, number base = e) -> number\0"
+		"(number numbers, ...) -> number\0"
+		"(number base) -> number, number\0"
+		"(number angle) -> number\0"
+		"(number x, number y) -> number\0"
+		"(number degrees) -> number\0"
+		"(number min, number max) -> number\0"
+		"(number m = nil, number n = nil) -> number\0"
+		"(number seed)\0"
+		"(number value, number inMin, number inMax, number outMin, number outMax) -> number\0"
+		"(number value, number decimals = 0) -> number\0"
+		"(number input, number snapTo) -> number\0"
+		"(number start, number end, number current) -> number\0"
+		"(number num, number digits = 0) -> number\0"
+		"(table data = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}) -> VMatrix\0"
+		"(IMaterial mat = nil) -> IMesh\0"
+		"(number primitiveType, number primiteCount)\0"
+		"(number r, number g, number b, number a)\0"
+		"(Vector normal)\0"
+		"(Vector position)\0"
+		"(Vector vertex1, Vector vertex2, Vector vertex3, Vector vertex4)\0"
+		"(Vector position, Vector normal, number sizeX, number sizeY)\0"
+		"(number set, number u, number v)\0"
+		"(string model) -> string\0"
+		"(Vector pos, number size, number downLimit, number upLimit) -> table\0"
+		"(Vector pos, number limit) -> CNavArea\0"
+		"(Vector position, boolean anyZ = false, number maxDist = 10000, boolean checkLOS = false, boolean checkGround = true, number team = TEAM_ANY) -> CNavArea\0"
+		"(number length, Player client)\0"
+		"(boolean hasAlpha = true) -> table\0"
+		"(number length) -> string\0"
+		"(number bitCount) -> number\0"
+		"(boolean sequential = false) -> table\0"
+		"(number typeID = net.ReadUInt(8)) -> any\0"
+		"(number numberOfBits) -> number\0"
+		"(string messageName, function callback)\0"
+		"(any ply)\0"
+		"(string messageName, boolean unreliable = false) -> boolean\0"
+		"(Angle angle)\0"
+		"(boolean boolean)\0"
+		"(table color, boolean writeAlpha = true)\0"
+		"(string binaryData, number length = #binaryData)\0"
+		"(number double)\0"
+		"(Entity entity)\0"
+		"(number float)\0"
+		"(number integer, number bitCount)\0"
+		"(VMatrix matrix)\0"
+		"(Player ply)\0"
+		"(string string)\0"
+		"(table table, boolean sequential = false)\0"
+		"(any data)\0"
+		"(number unsignedInteger, number numberOfBits)\0"
+		"(string uint64)\0"
+		"(Vector vector)\0"
+		"(table tab, any prevKey = nil) -> any, any\0"
+		"(string text, number type, number length)\0"
+		"(any id, string strText, number frac = nil)\0"
+		"(any uid)\0"
+		"(string modelName) -> number\0"
+		"(string modelName, number numPostParams, any asyncHandle)\0"
+		"(string format, number time = os.time()) -> string\0"
+		"(number timeA, number timeB) -> number\0"
+		"(string varname) -> string\0"
+		"(table dateData = nil) -> number\0"
+		"(table tab) -> function, table, any\0"
+		"(string file)\0"
+		"(string particleName, Vector position, Angle angles, Entity parent = NULL)\0"
+		"(string particleName, number attachType, Entity entity, number attachmentID)\0"
+		"(Vector position, boolean use3D = false) -> CLuaEmitter\0"
+		"(string type) -> PathFollower\0"
+		"(function func, ...) -> boolean, ...\0"
+		"(number playerIndex) -> Player\0"
+		"(string botName) -> Player\0"
+		"(number connectionID) -> Player\0"
+		"(string steamID) -> Player\0"
+		"(string steamID64) -> Player\0"
+		"(string name, string model)\0"
+		"(string shortName) -> string\0"
+		"(number type, string message)\0"
+		"(table tableToPrint, number indent = 0, table done = {})\0"
+		"() -> ProjectedTexture\0"
+		"(string name, table propertyData)\0"
+		"(Vector eyepos, Vector eyevec) -> Entity\0"
+		"(any value1, any value2) -> boolean\0"
+		"(table table, any index) -> any\0"
+		"(table table, any index, any value) -> table\0"
+		"(boolean unreliable = false) -> CRecipientFilter\0"
+		"(Panel menu)\0"
+		"(Vector startPos, number width, number textureEnd, table color)\0"
+		"(ITexture rendertarget, number blurx, number blury, number passes)\0"
+		"(table captureData) -> string\0"
+		"(number r, number g, number b, number a, boolean clearDepth = false, boolean clearStencil = false)\0"
+		"(boolean clearStencil = true)\0"
+		"(ITexture texture)\0"
+		"(number depthmin, number depthmax)\0"
+		"(Vector startPos, Vector endPos, number width, number textureStart, number textureEnd, table color = Color(255, 255, 255))\0"
+		"(Vector position, Angle angles, Vector mins, Vector maxs, table color = Color(255, 255, 255))\0"
+		"(Vector startPos, Vector endPos, table color = Color(255, 255, 255), boolean writeZ = false)\0"
+		"(Vector vert1, Vector vert2, Vector vert3, Vector vert4, table color = Color(255, 255, 255))\0"
+		"(Vector position, Vector normal, number width, number height, table color, number rotation = 0)\0"
+		"(boolean applyPoster = false)\0"
+		"(Vector position, number radius, number longitudeSteps, number latitudeSteps, table color = Color(255, 255, 255))\0"
+		"(Vector position, number width, number height, table color = Color(255, 255, 255))\0"
+		"(ITexture tex)\0"
+		"(Vector position, Angle angle, Vector mins, Vector maxs, table color = Color(255, 255, 255), boolean writeZ = false)\0"
+		"(Vector position, number radius, number longitudeSteps, number latitudeSteps, table color = Color(255, 255, 255), boolean writeZ = false)\0"
+		"(Vector position) -> Vector\0"
+		"() -> ITexture\0"
+		"(number textureIndex = 0) -> ITexture\0"
+		"(boolean noPlayer = false) -> table\0"
+		"(IMaterial material = nil)\0"
+		"(boolean enable, boolean shouldWrite)\0"
+		"(boolean enabled, number srcBlend, number destBlend, number blendFunc, number srcBlendAlpha = nil, number destBlendAlpha = nil, number blendFuncAlpha = nil)\0"
+		"(number texFilterType)\0"
+		"(ITexture texture, number x = 0, number y = 0, number width = texture:Width(), number height = texture:Height())\0"
+		"(number x, number y) -> number, number, number, number\0"
+		"(table view = nil)\0"
+		"(number blending)\0"
+		"(number r, number g, number b)\0"
+		"(number mode)\0"
+		"(IMaterial mat)\0"
+		"(number startX, number startY, number endX, number endY, boolean enable)\0"
+		"(number compareFunction)\0"
+		"(boolean newState)\0"
+		"(number failOperation)\0"
+		"(number passOperation)\0"
+		"(number referenceValue)\0"
+		"(number mask)\0"
+		"(number zFailOperation)\0"
+		"(number x, number y, number w, number h)\0"
+		"(boolean suppressLighting)\0"
+		"(number textureIndex = 0)\0"
+		"(Vector origin, Angle angle, Vector usableFocusPoint, number angleSize, number radialSteps, number passes, boolean spin, table inView, number fov)\0"
+		"(Vector viewOrigin, Angle viewAngles)\0"
+		"(Vector viewOrigin, Angle viewAngles, number viewFOV)\0"
+		"(string path)\0"
+		"(string workshopid)\0"
+		"(string command, ...)\0"
+		"(string code, string identifier = \"RunString\", boolean handleError = true) -> string\0"
+		"(Entity ent)\0"
+		"(Entity entity, number delay)\0"
+		"(number size) -> number\0"
+		"(string classname) -> table\0"
+		"(table ENT, string classname)\0"
+		"(any parameter, ...) -> any\0"
+		"(string text)\0"
+		"(function location, table environment) -> function\0"
+		"(any index, Angle angle)\0"
+		"(any index, boolean bool)\0"
+		"(any index, Entity ent)\0"
+		"(any index, number float)\0"
+		"(string index, number value)\0"
+		"(any index, string string)\0"
+		"(any index, Vector vec)\0"
+		"(table tab, table metatable) -> table\0"
+		"(table table, boolean desc = false) -> function, table\0"
+		"(table table, any memberKey, boolean descending = false) -> function, table\0"
+		"(table table, boolean descending = false) -> function, table\0"
+		"(string soundPath) -> string\0"
+		"(table soundData)\0"
+		"(string snd, Vector pos, number level = 75, number pitch = 100, number volume = 1, number dsp = 0)\0"
+		"(string path, string flags, function callback)\0"
+		"(string url, string flags, function callback)\0"
+		"(string soundName) -> number\0"
+		"(string tool, boolean menuInstant = false)\0"
+		"(string tab, string category, string class, string label, string command, string controls, function cpanelFunction, table tableData = nil)\0"
+		"(string query) -> table\0"
+		"(string query, number row = 1) -> table\0"
+		"(string query) -> string\0"
+		"(string string, boolean noQuotes = false) -> string\0"
+		"(string tableName) -> boolean\0"
+		"(string workshopID, function resultCallback)\0"
+		"(string workshopItemID, function resultCallback)\0"
+		"(string workshopItemID) -> boolean\0"
+		"(string workshopItemID)\0"
+		"(number number) -> string\0"
+		"(string string, number startPos = 1, number endPos = startPos) -> ...\0"
+		"(...) -> string\0"
+		"(number InputNumber, string separator = \",\") -> string\0"
+		"(string str, string end) -> boolean\0"
+		"(string separator, string str, boolean withpattern = false) -> table\0"
+		"(string haystack, string needle, number startPos = 1, boolean noPatterns = false) -> number, number, string\0"
+		"(string format, ...) -> string\0"
+		"(number float, string format = nil) -> string\0"
+		"(table color) -> string\0"
+		"(string file) -> string\0"
+		"(string pathString) -> string\0"
+		"(string Inputstring) -> string\0"
+		"(string data, string pattern) -> function\0"
+		"(string string, string pattern, string replacement, number maxReplaces = nil) -> string, number\0"
+		"(string separator = \"\", table pieces) -> string\0"
+		"(string str) -> string\0"
+		"(string str, number num) -> string\0"
+		"(string str) -> number\0"
+		"(string string, string pattern, number startPosition = 1) -> ...\0"
+		"(number bytes) -> string\0"
+		"(number num) -> string\0"
+		"(string str, number repetitions, string separator = \"\") -> string\0"
+		"(string str, string find, string replace) -> string\0"
+		"(string InputString, number Index, string ReplacementChar) -> string\0"
+		"(string Inputstring, string Separator) -> table\0"
+		"(string inputStr, string start) -> boolean\0"
+		"(string string, number StartPos, number EndPos = nil) -> string\0"
+		"(string Inputstring) -> table\0"
+		"(number time) -> string\0"
+		"(string str) -> table\0"
+		"(string Inputstring, string Char = \"\\s\") -> string\0"
+		"(string str, string char = \" \") -> string\0"
+		"(Player suppressPlayer)\0"
+		"(string fontName, table fontData)\0"
+		"(boolean disable)\0"
+		"(number originX, number originY, number radius, number r, number g = nil, number b = nil, number a = nil)\0"
+		"(number startX, number startY, number endX, number endY)\0"
+		"(number x, number y, number w, number h, number thickness = 1)\0"
+		"(table vertices)\0"
+		"(number x, number y, number width, number height)\0"
+		"(string text, boolean forceAdditive = nil)\0"
+		"(number x, number y, number width, number height, number rotation)\0"
+		"(number x, number y, number width, number height, number startU, number startV, number endU, number endV)\0"
+		"(string name) -> IMaterial\0"
+		"(string text) -> number, number\0"
+		"(string soundfile)\0"
+		"(number multiplier)\0"
+		"(number r, number g, number b, number a = 255)\0"
+		"(string fontName)\0"
+		"(IMaterial material)\0"
+		"(number textureID)\0"
+		"(table target, table source) -> table\0"
+		"(table table, boolean saveKeys = false) -> table\0"
+		"(table input) -> table\0"
+		"(table tbl, string concatenator = \"\", number startPos = 1, number endPos = #tbl) -> string\0"
+		"(table originalTable) -> table\0"
+		"(table source, table target)\0"
+		"(table tbl) -> number\0"
+		"(table tbl)\0"
+		"(table tab = {}, any value) -> table\0"
+		"(table tabl) -> table\0"
+		"(table tab) -> any\0"
+		"(table inputTable) -> any\0"
+		"(table tbl, any value) -> boolean\0"
+		"(table target, table base) -> table\0"
+		"(table tbl, number position, any value) -> number\0"
+		"(table tab) -> boolean\0"
+		"(table tab, any value) -> any\0"
+		"(table tab, any value) -> table\0"
+		"(table tbl) -> table\0"
+		"(table destination, table source, boolean forceOverride = false) -> table\0"
+		"(table haystack) -> any, any\0"
+		"(table tbl, number index = #tbl) -> any\0"
+		"(table tbl, any val) -> any\0"
+		"(table tbl, function sorter = nil)\0"
+		"(table tab, boolean descending = false) -> table\0"
+		"(table tab, any memberKey, boolean ascending = false)\0"
+		"(table tbl, string displayName, boolean niceFormatting) -> string\0"
+		"(number teamIndex) -> table\0"
+		"(number teamIndex) -> string\0"
+		"(number teamIndex) -> number\0"
+		"(number teamIndex, string teamName, table teamColor, boolean isJoinable = true)\0"
+		"(number index) -> boolean\0"
+		"(number frequency, number min, number max, number offset) -> number\0"
+		"(number frequency, number origin, number max, number offset) -> number\0"
+		"(any identifier, number delay, number repetitions = nil, function func = nil) -> boolean\0"
+		"(string identifier, number delay, number repetitions, function func)\0"
+		"(string identifier) -> boolean\0"
+		"(any identifier) -> boolean\0"
+		"(string identifier)\0"
+		"(any identifier) -> number\0"
+		"(number delay, function func)\0"
+		"(any input) -> boolean\0"
+		"(any value, number base = 10) -> number\0"
+		"(any value) -> string\0"
+		"(any var) -> string\0"
+		"(any variable) -> number\0"
+		"(string name = nil)\0"
+		"(table tbl, number startIndex = 1, number endIndex = #tbl) -> ...\0"
+		"(Angle ViewAngles, number ViewFOV, number x, number y, number scrWidth, number scrHeight) -> Vector\0"
+		"(string str, boolean inline = false) -> string\0"
+		"(Entity inflictor, Entity attacker, Vector damageOrigin, number damageRadius, number damage)\0"
+		"(string stringToHash) -> string\0"
+		"(string name, Vector start, Vector end, any filter = NULL)\0"
+		"(string compressedString, number maxSize = nil) -> string\0"
+		"(Vector lineStart, Vector lineEnd, Vector pointPos) -> number, Vector, number\0"
+		"(string effectName, CEffectData effectData, boolean allowOverride = true, any ignorePredictionOrRecipientFilter = nil)\0"
+		"(string mdl) -> table\0"
+		"() -> pixelvis_handle_t\0"
+		"(Player ply, Vector dir = ply:GetAimVector()) -> table\0"
+		"(number id) -> table\0"
+		"(string surfaceName) -> number\0"
+		"(Vector rayStart, Vector rayDelta, Vector boxOrigin, Angle boxAngles, Vector boxMins, Vector boxMaxs) -> Vector, Vector, number\0"
+		"(Vector rayOrigin, Vector rayDirection, Vector planePosition, Vector planeNormal) -> Vector\0"
+		"(Vector position) -> boolean\0"
+		"(string json, boolean ignoreLimits = false, boolean ignoreConversions = false) -> table\0"
+		"(string keyValues, boolean usesEscapeSequences = false, boolean preserveKeyCase = false) -> table\0"
+		"(Entity ent, Vector lpos, number bone) -> Vector\0"
+		"(number stringTableID) -> string\0"
+		"(string networkString) -> number\0"
+		"(Vector position, number radius, pixelvis_handle_t PixVis) -> number\0"
+		"(Vector position) -> number\0"
+		"(string modelName)\0"
+		"(string soundName)\0"
+		"(Vector origin, Vector dir, any filter = nil) -> table\0"
+		"(string value) -> string\0"
+		"(string uniqueName, number min, number max, number additionalSeed = 0) -> number\0"
+		"(Entity ent, number attachmentID, table color, boolean additive, number startWidth, number endWidth, number lifetime, number textureRes, string texture) -> Entity\0"
+		"() -> Stack\0"
+		"(string id) -> string\0"
+		"(table table, boolean prettyPrint = false) -> string\0"
+		"(table table, string parentKey = \"TableToKeyValues\") -> string\0"
+		"(number startdelay = 0) -> table\0"
+		"(table tracedata, Entity ent) -> table\0"
+		"(table TraceData) -> table\0"
+		"(any input) -> string\0"
+		"(Panel panel) -> boolean\0"
+		"(number x = 0, number y = 0, number z = 0) -> Vector\0"
+		"(number min = -1, number max = 1) -> Vector\0"
+		"(string classname, Panel parent = nil, string name = nil) -> Panel\0"
+		"(table metatable, Panel parent = nil, string name = nil) -> Panel\0"
+		"(string Panelname) -> boolean\0"
+		"(Panel parent) -> boolean\0"
+		"(string Panelname) -> table\0"
+		"(string classname, table panelTable, string baseName = \"Panel\") -> table\0"
+		"(string weapon_class) -> table\0"
+		"(string name, string base) -> boolean\0"
+		"(table swep_table, string classname)\0"
+		"(Vector position, Angle angle, Vector newSystemOrigin, Angle newSystemAngles) -> Vector, Angle\0"
+		"(function func, function errorCallback, ...) -> boolean, ...\0"
+		;
+}
\ No newline at end of file
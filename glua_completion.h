@@ -0,0 +1,61 @@
+#pragma once
+#include <imgui/TextEditor.h>
+#include "glua_api.h"
+
+// Prefix lookups in the generated GLua API table (glua_api.h), the editor's completion callback
+namespace GLuaApi {
+	unsigned char Fold(char c) {
+		return (unsigned char)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+	}
+
+	// Compares the first length characters of the entry's name with the prefix, ignoring case
+	int ComparePrefix(const Entry& entry, const char* prefix, size_t length) {
+		const char* name = Names + entry.name;
+		for (size_t i = 0; i < length; i++) {
+			if (i == entry.nameLength)
+				return -1;
+			unsigned char a = Fold(name[i]), b = Fold(prefix[i]);
+			if (a != b)
+				return a < b ? -1 : 1;
+		}
+		return 0;
+	}
+
+	// Names one level below the prefix come first ("net." lists net.Start before anything deeper), then the rest,
+	// each group in table order
+	int Complete(const char* prefix, size_t length, TextEditor::Completion* out, int max) {
+		const Entry* begin = Entries;
+		const Entry* end = Entries + EntryCount;
+		while (begin < end) {
+			const Entry* mid = begin + (end - begin) / 2;
+			if (ComparePrefix(*mid, prefix, length) < 0)
+				begin = mid + 1;
+			else
+				end = mid;
+		}
+		end = Entries + EntryCount;
+		for (const Entry* lo = begin; lo < end;) {
+			const Entry* mid = lo + (end - lo) / 2;
+			if (ComparePrefix(*mid, prefix, length) == 0)
+				lo = mid + 1;
+			else
+				end = mid;
+		}
+
+		int depth = 0;
+		for (size_t i = 0; i < length; i++)
+			depth += prefix[i] == '.';
+
+		int count = 0;
+		for (int pass = 0; pass < 2 && count < max; pass++) {
+			for (const Entry* entry = begin; entry < end && count < max; entry++) {
+				if ((entry->depth == depth) != (pass == 0))
+					continue;
+				out[count].mText = Names + entry->name;
+				out[count].mDetail = Details + entry->detail;
+				count++;
+			}
+		}
+		return count;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,913 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <imgui/TextEditor.h>
+
+// Syntax check of GLua source, the editor's diagnostics callback. A recursive descent parser for the Lua 5.1/LuaJIT grammar
+// plus the GMod extensions (// and /* */ comments, != && || !, continue) that builds nothing and keeps going after an error:
+// it skips to the next token that looks like the start of a statement or the end of a block and reports what follows too.
+// Messages read like the ones LuaJIT gives.
+namespace GLuaSyntax {
+	const int MaxErrors = 100;
+	const int MaxLevels = 200;      // LUAI_MAXCCALLS, LuaJIT refuses deeper nesting as well
+
+	// Single character tokens are the character itself
+	enum Token {
+		TkAnd = 257, TkBreak, TkContinue, TkDo, TkElse, TkElseif, TkEnd, TkFalse, TkFor, TkFunction, TkGoto, TkIf, TkIn,
+		TkLocal, TkNil, TkNot, TkOr, TkRepeat, TkReturn, TkThen, TkTrue, TkUntil, TkWhile,
+		TkConcat, TkDots, TkEq, TkGe, TkLe, TkNe, TkLabel, TkNumber, TkName, TkString, TkEof
+	};
+
+	const char* const Keywords[] = {
+		"and", "break", "continue", "do", "else", "elseif", "end", "false", "for", "function", "goto", "if", "in",
+		"local", "nil", "not", "or", "repeat", "return", "then", "true", "until", "while"
+	};
+
+	class Parser {
+	public:
+		Parser(const char* begin, const char* end, std::vector<TextEditor::Diagnostic>& out, const std::atomic<bool>& cancel)
+			: begin(begin), end(end), p(begin), lineStart(begin), out(out), cancel(cancel) {}
+
+		// Returns false when cancelled
+		bool Run() {
+			Next();
+			// A stray 'end' doesn't stop the check, the rest of the chunk is parsed as well
+			for (;;) {
+				Block(TkEof, 0, 0);
+				if (token.kind == TkEof)
+					break;
+				ErrorExpected(TkEof);
+				Next();
+				panic = false;
+			}
+			return !cancelled;
+		}
+
+	private:
+		struct Lexeme {
+			int kind;
+			const char* begin;
+			const char* end;
+			int line;
+			const char* lineStart;
+		};
+
+		const char* begin;
+		const char* end;
+		const char* p;
+		int line = 0;
+		const char* lineStart;
+		Lexeme token = {};
+		Lexeme ahead = {};
+		bool hasAhead = false;
+		int lastLine = 0;           // line of the previous token
+		std::vector<TextEditor::Diagnostic>& out;
+		const std::atomic<bool>& cancel;
+		unsigned tokenCount = 0;
+		bool cancelled = false;
+		bool abort = false;         // cancelled, nested too deep or too many errors, every token is <eof> from here
+		bool panic = false;         // an error was reported and the parser hasn't found its way back yet, errors are dropped until then
+		int levels = 0;
+		bool vararg = true;         // the main chunk is vararg
+		int loops = 0;              // loops around the statement in the current function
+
+		// Lexer
+
+		static bool IsNameStart(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (unsigned char)c >= 0x80; }
+		static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+		static bool IsHexDigit(char c) { return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+		static bool IsName(char c) { return IsNameStart(c) || IsDigit(c); }
+
+		void NewLine() {
+			line++;
+			lineStart = p;
+		}
+
+		// Returns the level of the long bracket opening at p ("[[", "[=[", ...), -1 if there is none
+		int LongBracketLevel(const char* at) const {
+			const char* q = at + 1;
+			while (q < end && *q == '=')
+				q++;
+			return (q < end && *q == '[') ? (int)(q - at - 1) : -1;
+		}
+
+		// Skips past the "]=*]" closing a long bracket of the given level, returns false at the end of the text
+		bool SkipLongBracket(int level) {
+			while (p < end) {
+				char c = *p++;
+				if (c == '\n')
+					NewLine();
+				else if (c == ']') {
+					const char* q = p;
+					while (q < end && *q == '=')
+						q++;
+					if (q < end && *q == ']' && q - p == level) {
+						p = q + 1;
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		void LexError(const Lexeme& at, const char* message) {
+			Report(at, std::string(message) + " near '" + Text(at) + "'");
+		}
+
+		// Lexical errors don't set panic, the token they are about is still usable
+		void Scan(Lexeme& lex) {
+			for (;;) {
+				while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\v' || *p == '\f')) {
+					if (*p++ == '\n')
+						NewLine();
+				}
+
+				lex.begin = p;
+				lex.line = line;
+				lex.lineStart = lineStart;
+				if (p == end || abort) {
+					lex.kind = TkEof;
+					lex.end = p;
+					return;
+				}
+
+				const char c = *p;
+				const char next = p + 1 < end ? p[1] : '\0';
+				if ((c == '-' && next == '-') || (c == '/' && next == '/')) {
+					p += 2;
+					int level;
+					if (c == '-' && p < end && *p == '[' && (level = LongBracketLevel(p)) >= 0) {
+						p += level + 2;
+						if (!SkipLongBracket(level)) {
+							lex.kind = TkEof;
+							lex.end = p;
+							LexError(lex, "unfinished long comment");
+							return;
+						}
+						continue;
+					}
+					while (p < end && *p != '\n')
+						p++;
+					continue;
+				}
+				if (c == '/' && next == '*') {
+					const char* close = nullptr;
+					for (const char* q = p + 2; q + 1 < end; q++) {
+						if (q[0] == '*' && q[1] == '/') {
+							close = q + 2;
+							break;
+						}
+					}
+					const char* stop = close ? close : end;
+					for (p += 2; p < stop; ) {
+						if (*p++ == '\n')
+							NewLine();
+					}
+					if (!close) {
+						lex.kind = TkEof;
+						lex.end = p;
+						LexError(lex, "unfinished long comment");
+						return;
+					}
+					continue;
+				}
+				break;
+			}
+
+			const char c = *p;
+			const char next = p + 1 < end ? p[1] : '\0';
+			lex.kind = (unsigned char)c;
+			if (IsNameStart(c)) {
+				while (p < end && IsName(*p))
+					p++;
+				lex.end = p;
+				lex.kind = TkName;
+				const size_t length = p - lex.begin;
+				for (int i = 0; i < (int)(sizeof(Keywords) / sizeof(Keywords[0])); i++) {
+					if (strlen(Keywords[i]) == length && memcmp(Keywords[i], lex.begin, length) == 0) {
+						lex.kind = TkAnd + i;
+						break;
+					}
+				}
+				return;
+			}
+			if (IsDigit(c) || (c == '.' && IsDigit(next))) {
+				ScanNumber(lex);
+				return;
+			}
+			if (c == '"' || c == '\'') {
+				ScanString(lex);
+				return;
+			}
+			if (c == '[') {
+				const int level = LongBracketLevel(p);
+				if (level >= 0) {
+					lex.kind = TkString;
+					p += level + 2;
+					if (!SkipLongBracket(level)) {
+						lex.end = p;
+						LexError(lex, "unfinished long string");
+					}
+					lex.end = p;
+					return;
+				}
+				if (next == '=') {
+					p += 2;
+					lex.end = p;
+					LexError(lex, "invalid long string delimiter");
+					lex.kind = TkString;
+					return;
+				}
+			}
+
+			struct Operator { const char* text; int kind; };
+			static const Operator operators[] = {
+				{ "...", TkDots }, { "..", TkConcat }, { "==", TkEq }, { "~=", TkNe }, { "!=", TkNe }, { "<=", TkLe }, { ">=", TkGe },
+				{ "::", TkLabel }, { "&&", TkAnd }, { "||", TkOr }, { "!", TkNot }
+			};
+			for (auto& op : operators) {
+				const size_t length = strlen(op.text);
+				if ((size_t)(end - p) >= length && memcmp(p, op.text, length) == 0) {
+					p += length;
+					lex.end = p;
+					lex.kind = op.kind;
+					return;
+				}
+			}
+			p++;
+			lex.end = p;
+		}
+
+		void ScanNumber(Lexeme& lex) {
+			// Everything LuaJIT reads as part of the number, then whether it makes one
+			const char exponent = *p == '0' && p + 1 < end && (p[1] == 'x' || p[1] == 'X') ? 'p' : 'e';
+			while (p < end && (IsName(*p) || *p == '.' || ((*p == '+' || *p == '-') && (p[-1] | 0x20) == exponent)))
+				p++;
+			lex.kind = TkNumber;
+			lex.end = p;
+
+			const char* q = lex.begin;
+			bool ok = false;
+			if (exponent == 'p') {
+				q += 2;
+				const char* digits = q;
+				while (q < p && IsHexDigit(*q))
+					q++;
+				bool any = q > digits;
+				if (q < p && *q == '.') {
+					for (digits = ++q; q < p && IsHexDigit(*q); q++);
+					any |= q > digits;
+				}
+				ok = any;
+			}
+			else {
+				const char* digits = q;
+				while (q < p && IsDigit(*q))
+					q++;
+				bool any = q > digits;
+				if (q < p && *q == '.') {
+					for (digits = ++q; q < p && IsDigit(*q); q++);
+					any |= q > digits;
+				}
+				ok = any;
+			}
+			if (ok && q < p && (*q | 0x20) == exponent) {
+				if (++q < p && (*q == '+' || *q == '-'))
+					q++;
+				const char* digits = q;
+				while (q < p && IsDigit(*q))
+					q++;
+				ok = q > digits;
+			}
+			// LuaJIT's 64 bit integer and imaginary suffixes: 1LL, 1ULL, 1i
+			if (ok && q < p) {
+				std::string suffix(q, p);
+				for (auto& ch : suffix)
+					ch |= 0x20;
+				ok = suffix == "ll" || suffix == "ull" || suffix == "i";
+			}
+			if (!ok)
+				LexError(lex, "malformed number");
+		}
+
+		void ScanString(Lexeme& lex) {
+			const char quote = *p++;
+			lex.kind = TkString;
+			while (p < end && *p != quote) {
+				if (*p == '\n')
+					break;
+				if (*p != '\\') {
+					p++;
+					continue;
+				}
+
+				const char* escape = p++;
+				if (p == end)
+					break;
+				const char c = *p++;
+				bool ok = true;
+				if (c == '\n')
+					NewLine();
+				else if (c == 'x') {
+					ok = p + 1 < end && IsHexDigit(p[0]) && IsHexDigit(p[1]);
+					if (ok)
+						p += 2;
+				}
+				else if (c == 'z') {
+					while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\v' || *p == '\f')) {
+						if (*p++ == '\n')
+							NewLine();
+					}
+				}
+				else if (c == 'u') {
+					ok = p < end && *p == '{';
+					if (ok) {
+						const char* digits = ++p;
+						while (p < end && IsHexDigit(*p))
+							p++;
+						ok = p > digits && p < end && *p == '}';
+						if (ok)
+							p++;
+					}
+				}
+				else if (IsDigit(c)) {
+					int value = c - '0';
+					for (int i = 0; i < 2 && p < end && IsDigit(*p); i++)
+						value = value * 10 + (*p++ - '0');
+					ok = value <= 255;
+				}
+				else
+					ok = strchr("abfnrtv\\\"'\r", c) != nullptr;
+
+				if (!ok) {
+					Lexeme at = lex;
+					at.begin = escape;
+					at.end = p;
+					at.line = line;
+					at.lineStart = lineStart;
+					LexError(at, "invalid escape sequence");
+				}
+			}
+
+			if (p < end && *p == quote) {
+				p++;
+				lex.end = p;
+				return;
+			}
+			lex.end = p;
+			LexError(lex, "unfinished string");
+		}
+
+		void Next() {
+			lastLine = token.line;
+			if (hasAhead) {
+				token = ahead;
+				hasAhead = false;
+			}
+			else
+				Scan(token);
+
+			if (++tokenCount % 256 == 0 && cancel.load(std::memory_order_relaxed)) {
+				cancelled = abort = true;
+				token.kind = TkEof;
+			}
+		}
+
+		int Peek() {
+			if (!hasAhead) {
+				Scan(ahead);
+				hasAhead = true;
+			}
+			return ahead.kind;
+		}
+
+		// Errors
+
+		static std::string TokenName(int kind) {
+			if (kind < 256)
+				return std::string(1, (char)kind);
+			switch (kind) {
+			case TkConcat: return "..";
+			case TkDots: return "...";
+			case TkEq: return "==";
+			case TkGe: return ">=";
+			case TkLe: return "<=";
+			case TkNe: return "~=";
+			case TkLabel: return "::";
+			case TkNumber: return "<number>";
+			case TkName: return "<name>";
+			case TkString: return "<string>";
+			case TkEof: return "<eof>";
+			default: return Keywords[kind - TkAnd];
+			}
+		}
+
+		std::string Text(const Lexeme& lex) const {
+			if (lex.kind == TkEof)
+				return "<eof>";
+			std::string text(lex.begin, lex.end);
+			const size_t lineBreak = text.find('\n');
+			if (lineBreak != std::string::npos || text.size() > 40)
+				text = text.substr(0, std::min<size_t>(lineBreak, 40)) + "...";
+			return text;
+		}
+
+		void Report(const Lexeme& at, const std::string& message) {
+			if (panic || abort)
+				return;
+			if ((int)out.size() == MaxErrors) {
+				abort = true;
+				return;
+			}
+
+			// Underline the part of the token on its first line
+			const char* lineEnd = (const char*)memchr(at.begin, '\n', end - at.begin);
+			if (lineEnd == nullptr)
+				lineEnd = end;
+			TextEditor::Diagnostic diagnostic;
+			diagnostic.mLine = at.line;
+			diagnostic.mStartIndex = (int)(at.begin - at.lineStart);
+			diagnostic.mEndIndex = (int)(std::min(at.end, lineEnd) - at.lineStart);
+			diagnostic.mMessage = message;
+			out.push_back(std::move(diagnostic));
+		}
+
+		void Error(const std::string& message) {
+			Report(token, message + " near '" + Text(token) + "'");
+			panic = true;
+		}
+
+		void ErrorExpected(int kind) {
+			Error("'" + TokenName(kind) + "' expected");
+		}
+
+		bool Accept(int kind) {
+			if (token.kind != kind)
+				return false;
+			Next();
+			return true;
+		}
+
+		void Expect(int kind) {
+			if (!Accept(kind))
+				ErrorExpected(kind);
+		}
+
+		// what closes the who opened at line, the message points there when it's on another line
+		void ExpectMatch(int what, int who, int whoLine) {
+			if (Accept(what))
+				return;
+			if (whoLine == token.line)
+				ErrorExpected(what);
+			else
+				Error("'" + TokenName(what) + "' expected (to close '" + TokenName(who) + "' at line " + std::to_string(whoLine + 1) + ")");
+		}
+
+		void ExpectName() {
+			if (!Accept(TkName))
+				ErrorExpected(TkName);
+		}
+
+		// Nesting of blocks and expressions, deep enough source would otherwise run the thread out of stack
+		bool Enter() {
+			if (++levels <= MaxLevels)
+				return true;
+			levels--;
+			Error("chunk has too many syntax levels");
+			abort = true;
+			token.kind = TkEof;
+			return false;
+		}
+
+		void Leave() { levels--; }
+
+		// Recovery: skips tokens until one a statement can start with at the same nesting level, or the end of a block.
+		// Whole nested blocks and brackets are skipped, a name first on its line is taken as the start of the next statement.
+		void Synchronize(const char* statementBegin) {
+			int blocks = 0, brackets = 0;
+			for (bool first = true; token.kind != TkEof; first = false) {
+				const bool skipped = !first || token.begin != statementBegin;
+				if (blocks == 0 && brackets == 0 && skipped) {
+					switch (token.kind) {
+					case TkEnd: case TkElse: case TkElseif: case TkUntil:
+					case TkLocal: case TkIf: case TkWhile: case TkFor: case TkRepeat: case TkDo: case TkReturn:
+					case TkBreak: case TkContinue: case TkGoto: case TkLabel: case ';':
+						panic = false;
+						return;
+					case TkName: case '(':
+						if (token.line != lastLine) {
+							panic = false;
+							return;
+						}
+						break;
+					}
+				}
+
+				switch (token.kind) {
+				case TkFunction: case TkDo: case TkIf: case TkRepeat: blocks++; break;
+				case TkEnd: case TkUntil: blocks = std::max(0, blocks - 1); break;
+				case '(': case '[': case '{': brackets++; break;
+				case ')': case ']': case '}': brackets = std::max(0, brackets - 1); break;
+				}
+				Next();
+			}
+			panic = false;
+		}
+
+		// Grammar, after lparser.c
+
+		static bool BlockFollow(int kind) {
+			return kind == TkElse || kind == TkElseif || kind == TkEnd || kind == TkUntil || kind == TkEof;
+		}
+
+		// Statements up to the end of the block. return, break and continue must come last, what follows them is reported as
+		// a missing closer (close/who/whoLine, like ExpectMatch) and parsed anyway.
+		void Block(int close, int who, int whoLine) {
+			if (!Enter())
+				return;
+			bool last = false;
+			while (!BlockFollow(token.kind)) {
+				if (last) {
+					if (close == TkEof || token.line == whoLine)
+						ErrorExpected(close);
+					else
+						Error("'" + TokenName(close) + "' expected (to close '" + TokenName(who) + "' at line " + std::to_string(whoLine + 1) + ")");
+					panic = false;
+					last = false;
+				}
+
+				const char* statementBegin = token.begin;
+				last = Statement();
+				if (panic)
+					Synchronize(statementBegin);
+			}
+			Leave();
+		}
+
+		bool Statement() {
+			const int statementLine = token.line;
+			switch (token.kind) {
+			case ';':
+				Next();
+				return false;
+			case TkIf:
+				IfStatement(statementLine);
+				return false;
+			case TkWhile:
+				Next();
+				Expression();
+				Expect(TkDo);
+				LoopBody(TkWhile, statementLine);
+				return false;
+			case TkDo:
+				Next();
+				Block(TkEnd, TkDo, statementLine);
+				ExpectMatch(TkEnd, TkDo, statementLine);
+				return false;
+			case TkFor:
+				ForStatement(statementLine);
+				return false;
+			case TkRepeat:
+				Next();
+				loops++;
+				Block(TkUntil, TkRepeat, statementLine);
+				loops--;
+				ExpectMatch(TkUntil, TkRepeat, statementLine);
+				Expression();
+				return false;
+			case TkFunction:
+				Next();
+				ExpectName();
+				while (Accept('.'))
+					ExpectName();
+				if (Accept(':'))
+					ExpectName();
+				FunctionBody(statementLine);
+				return false;
+			case TkLocal:
+				Next();
+				if (Accept(TkFunction)) {
+					ExpectName();
+					FunctionBody(statementLine);
+				}
+				else {
+					do
+						ExpectName();
+					while (!panic && Accept(','));
+					if (Accept('='))
+						ExpressionList();
+				}
+				return false;
+			case TkLabel:
+				Next();
+				ExpectName();
+				Expect(TkLabel);
+				return false;
+			case TkReturn:
+				Next();
+				if (!BlockFollow(token.kind) && token.kind != ';')
+					ExpressionList();
+				Accept(';');
+				return true;
+			case TkBreak:
+			case TkContinue:
+				if (loops == 0)
+					Report(token, token.kind == TkBreak ? "no loop to break" : "no loop to continue");
+				Next();
+				Accept(';');
+				return true;
+			case TkGoto:
+				Next();
+				ExpectName();
+				return false;
+			default:
+				ExpressionStatement();
+				return false;
+			}
+		}
+
+		void IfStatement(int ifLine) {
+			do {
+				Next();
+				Expression();
+				Expect(TkThen);
+				Block(TkEnd, TkIf, ifLine);
+			} while (token.kind == TkElseif);
+			if (Accept(TkElse))
+				Block(TkEnd, TkIf, ifLine);
+			ExpectMatch(TkEnd, TkIf, ifLine);
+		}
+
+		void ForStatement(int forLine) {
+			Next();
+			ExpectName();
+			if (Accept('=')) {
+				Expression();
+				Expect(',');
+				Expression();
+				if (Accept(','))
+					Expression();
+			}
+			else if (token.kind == ',' || token.kind == TkIn) {
+				while (Accept(','))
+					ExpectName();
+				Expect(TkIn);
+				ExpressionList();
+			}
+			else
+				Error("'=' or 'in' expected");
+			Expect(TkDo);
+			LoopBody(TkFor, forLine);
+		}
+
+		void LoopBody(int who, int whoLine) {
+			loops++;
+			Block(TkEnd, who, whoLine);
+			loops--;
+			ExpectMatch(TkEnd, who, whoLine);
+		}
+
+		// A call on its own, anything else has to be the start of an assignment
+		void ExpressionStatement() {
+			Suffixed kind = SuffixedExpression();
+			if (kind == Call || panic)
+				return;
+			for (;;) {
+				if (kind != Variable) {
+					Error("syntax error");
+					return;
+				}
+				if (!Accept(','))
+					break;
+				kind = SuffixedExpression();
+				if (panic)
+					return;
+			}
+			Expect('=');
+			ExpressionList();
+		}
+
+		void FunctionBody(int functionLine) {
+			const bool outerVararg = vararg;
+			const int outerLoops = loops;
+			vararg = false;
+			loops = 0;
+
+			Expect('(');
+			if (token.kind != ')') {
+				do {
+					if (Accept(TkDots)) {
+						vararg = true;
+						break;
+					}
+					ExpectName();
+				} while (!panic && Accept(','));
+			}
+			Expect(')');
+			Block(TkEnd, TkFunction, functionLine);
+			ExpectMatch(TkEnd, TkFunction, functionLine);
+
+			vararg = outerVararg;
+			loops = outerLoops;
+		}
+
+		void ExpressionList() {
+			do
+				Expression();
+			while (!panic && Accept(','));
+		}
+
+		enum Suffixed { Value, Variable, Call };
+
+		// prefixexp { '.' NAME | '[' exp ']' | ':' NAME args | args }, returns what the whole thing ends up as
+		Suffixed SuffixedExpression() {
+			Suffixed kind = Variable;
+			const int prefixLine = token.line;
+			if (token.kind == TkName)
+				Next();
+			else if (token.kind == '(') {
+				Next();
+				Expression();
+				ExpectMatch(')', '(', prefixLine);
+				kind = Value;
+			}
+			else {
+				Error("unexpected symbol");
+				return Value;
+			}
+
+			while (!panic) {
+				switch (token.kind) {
+				case '.':
+					Next();
+					ExpectName();
+					kind = Variable;
+					break;
+				case '[': {
+					const int bracketLine = token.line;
+					Next();
+					Expression();
+					ExpectMatch(']', '[', bracketLine);
+					kind = Variable;
+					break;
+				}
+				case ':':
+					Next();
+					ExpectName();
+					CallArguments();
+					kind = Call;
+					break;
+				case '(': case TkString: case '{':
+					CallArguments();
+					kind = Call;
+					break;
+				default:
+					return kind;
+				}
+			}
+			return kind;
+		}
+
+		void CallArguments() {
+			const int argumentsLine = token.line;
+			switch (token.kind) {
+			case '(':
+				if (token.line != lastLine) {
+					Error("ambiguous syntax (function call x new statement)");
+					return;
+				}
+				Next();
+				if (token.kind != ')')
+					ExpressionList();
+				ExpectMatch(')', '(', argumentsLine);
+				break;
+			case '{':
+				TableConstructor();
+				break;
+			case TkString:
+				Next();
+				break;
+			default:
+				Error("function arguments expected");
+			}
+		}
+
+		void TableConstructor() {
+			const int tableLine = token.line;
+			Next();
+			while (token.kind != '}') {
+				if (token.kind == '[') {
+					const int bracketLine = token.line;
+					Next();
+					Expression();
+					ExpectMatch(']', '[', bracketLine);
+					Expect('=');
+					Expression();
+				}
+				else if (token.kind == TkName && Peek() == '=') {
+					Next();
+					Next();
+					Expression();
+				}
+				else
+					Expression();
+
+				if (Accept(',') || Accept(';'))
+					continue;
+				if (token.kind == '}')
+					break;
+
+				// A missing separator, or garbage in a field: carry on with the next field of the same table. Something that
+				// can only be the end of a block or the next statement leaves recovery to Block().
+				ExpectMatch('}', '{', tableLine);
+				for (int nesting = 0; token.kind != TkEof; Next()) {
+					if (nesting == 0) {
+						if (token.kind == ',' || token.kind == ';' || token.kind == '}')
+							break;
+						if (BlockFollow(token.kind) || token.kind == TkLocal)
+							return;
+					}
+					switch (token.kind) {
+					case '(': case '[': case '{': case TkFunction: case TkDo: case TkIf: case TkRepeat: nesting++; break;
+					case ')': case ']': case '}': case TkEnd: case TkUntil: nesting = std::max(0, nesting - 1); break;
+					}
+				}
+				if (token.kind == TkEof)
+					return;
+				panic = false;
+				if (token.kind == '}')
+					break;
+				Next();
+			}
+			ExpectMatch('}', '{', tableLine);
+		}
+
+		void SimpleExpression() {
+			switch (token.kind) {
+			case TkNumber: case TkString: case TkNil: case TkTrue: case TkFalse:
+				Next();
+				break;
+			case TkDots:
+				if (!vararg)
+					Report(token, "cannot use '...' outside a vararg function near '...'");
+				Next();
+				break;
+			case '{':
+				TableConstructor();
+				break;
+			case TkFunction: {
+				const int functionLine = token.line;
+				Next();
+				FunctionBody(functionLine);
+				break;
+			}
+			default:
+				SuffixedExpression();
+			}
+		}
+
+		// Left and right priority of a binary operator, 0 if the token isn't one
+		static void BinaryPriority(int kind, int& left, int& right) {
+			switch (kind) {
+			case TkOr: left = right = 1; break;
+			case TkAnd: left = right = 2; break;
+			case '<': case '>': case TkLe: case TkGe: case TkNe: case TkEq: left = right = 3; break;
+			case TkConcat: left = 5; right = 4; break;
+			case '+': case '-': left = right = 6; break;
+			case '*': case '/': case '%': left = right = 7; break;
+			case '^': left = 10; right = 9; break;
+			default: left = right = 0;
+			}
+		}
+
+		static const int UnaryPriority = 8;
+
+		void Expression(int limit = 0) {
+			if (!Enter())
+				return;
+
+			if (token.kind == TkNot || token.kind == '-' || token.kind == '#') {
+				Next();
+				Expression(UnaryPriority);
+			}
+			else
+				SimpleExpression();
+
+			int left, right;
+			for (BinaryPriority(token.kind, left, right); !panic && left > limit; BinaryPriority(token.kind, left, right)) {
+				Next();
+				Expression(right);
+			}
+			Leave();
+		}
+	};
+
+	// TextEditor::LanguageDefinition::DiagnoseCallback
+	bool Diagnose(const char* begin, const char* end, std::vector<TextEditor::Diagnostic>& out, const std::atomic<bool>& cancel) {
+		Parser parser(begin, end, out, cancel);
+		return parser.Run();
+	}
+}
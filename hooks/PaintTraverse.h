@@ -4,20 +4,33 @@
 #include "../sdk/vgui2/VPanelWrapper.h"
 #include "../sdk/lua_shared/CLuaShared.h"
 #include "MakeHook.h"
+#include "../luaglobals.h"
+#include "../executor.h"
 
-void ParseError(std::string fullError) {
-	int firstColon = fullError.find(":");
-	int secondColon = fullError.find(":", firstColon + 1);
-	std::string lineSlice = fullError.substr(firstColon + 1, secondColon - firstColon - 1);
-	int errorLine = std::stoi(lineSlice);
-	std::string errorString = fullError.substr(secondColon + 2, strlen(fullError.c_str()) - (secondColon + 2));
+typedef int(*_luaL_loadbuffer)(lua_State* state, const char* buff, size_t sz, const char* name);
+
+// Compiles and runs a script in the client or menu realm, on failure error gets Lua's message
+bool runScript(const std::string& code, bool menuRealm, std::string& error) {
+	static HMODULE luaModule = GetModuleHandle("lua_shared.dll");
+	static _luaL_loadbuffer luaL_loadbuffer = (_luaL_loadbuffer)GetProcAddress(luaModule, "luaL_loadbuffer");
 
-	Globals::luaError.active = true;
-	Globals::luaError.line = errorLine;
-	Globals::luaError.error = errorString;
+	CLuaInterface* LUA = GetLuaInterface(menuRealm ? 2 : 0);
+	if (!LUA) {
+		error = menuRealm ? "The menu realm isn't running" : "The client realm isn't running";
+		return false;
+	}
+
+	lua_State* state = LUA->GetState();
+	luaL_loadbuffer(state, code.c_str(), code.size(), "@lua/includes/util.lua"); // Random file, to-do: dynamically spoof source
+	bool ok = !LUA->IsType(-1, LuaTypes::String) && LUA->PCall(0, 0, 0) == 0;
+	if (!ok) {
+		const char* message = LUA->GetString(-1);
+		error = message ? message : "Error object is not a string";
+		LUA->Pop();
+	}
+	return ok;
 }
 
-typedef int(*_luaL_loadbuffer)(lua_State* state, const char* buff, size_t sz, const char* name);
 typedef void(__thiscall* _PaintTraverse)(VPanelWrapper* _this, void* panel, bool force_repaint, bool allow_force);
 _PaintTraverse oPaintTraverse;
 void hkPaintTraverse(VPanelWrapper* _this, void* panel, bool force_repaint, bool allow_force) {
@@ -30,30 +43,21 @@ void hkPaintTraverse(VPanelWrapper* _this, void* panel, bool force_repaint, bool
 	}
 
 	if (panel == overlay) {
-		if (Globals::runLua) {
-			static HMODULE luaModule = GetModuleHandle("lua_shared.dll");
-			static _luaL_loadbuffer luaL_loadbuffer = (_luaL_loadbuffer)GetProcAddress(luaModule, "luaL_loadbuffer");
+		// Everything submitted since the last frame, in order
+		static std::vector<Executor::Job> jobs;
+		static std::string error;
+		Executor::Take(jobs);
+		for (const Executor::Job& job : jobs) {
+			bool ok = runScript(job.code, job.menuRealm, error);
+			if (job.done)
+				job.done(job, ok ? nullptr : error.c_str());
+		}
 
+		// Keeps the editor's completions up to date with the selected realm's globals while the menu is open
+		if (Globals::showMenu) {
 			CLuaInterface* LUA = GetLuaInterface(Globals::menuRealm ? 2 : 0);
-			lua_State* state = LUA->GetState();
-
-			if (LUA) {
-				luaL_loadbuffer(state, Globals::lua.c_str(), Globals::lua.size(), "@lua/includes/util.lua"); // Random file, to-do: dynamically spoof source
-				if (LUA->IsType(-1, LuaTypes::String)) {
-					const char* error = LUA->GetString(-1);
-					ParseError(error);
-					LUA->Pop();
-				}
-				else {
-					if (LUA->PCall(0, 0, 0)) {
-						const char* error = LUA->GetString(-1);
-						ParseError(error);
-						LUA->Pop();
-					}
-				}
-			}
-
-			Globals::runLua = false;
+			if (LUA)
+				LuaGlobals::Step(LUA->GetState());
 		}
 	}
 
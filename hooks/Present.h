@@ -3,6 +3,303 @@
 #include "../mem.h"
 #include "MakeHook.h"
 #include "../globals.h"
+#include "../fontcache.h"
+#include "../workspace.h"
+#include "../library.h"
+#include "../autosave.h"
+#include "../executor.h"
+#include "../watcher.h"
+
+// Runs on the loader thread right after injection so the render thread only has to upload the finished atlas
+void initImGui() {
+	ImGui::CreateContext();
+
+	// Remove ini file
+	ImGuiIO& io = ImGui::GetIO();
+	io.IniFilename = "";
+
+	// Reuse the atlas built by a previous injection, and convert it to the RGBA32 layout the DX9 backend uploads
+	FontCache::LoadOrBuild(io.Fonts, GetDataPath("fonts.bin"));
+	unsigned char* pixels;
+	int width, height;
+	io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+	// The editor's keyword/identifier tables are built once on first use, do it here as well
+	TextEditor::LanguageDefinition::GLua();
+
+	// Only the names and tags of saved scripts are read, texts are read when opened
+	Library::Load(GetDataPath("library.bin"));
+
+	// Reopen the tabs the last injection had, then keep journaling them
+	Autosave::Restore(GetDataPath("autosave.bin"));
+
+	// Start watching the files the last injection watched
+	Watcher::Start(GetDataPath("watchlist.txt"));
+
+	ImGuiStyle* style = &ImGui::GetStyle();
+	style->WindowTitleAlign = ImVec2(0.5, 0.5);
+	style->WindowMinSize = ImVec2(300, 150);
+}
+
+// Loads a script into a new tab (or the active one if it's blank) straight from a read-only mapping of the file
+bool openScript(std::string path, std::string& error) {
+	// Explorer's "Copy as path" wraps the path in quotes
+	if (path.size() >= 2 && path.front() == '"' && path.back() == '"')
+		path = path.substr(1, path.size() - 2);
+
+	MappedFile file;
+	if (!file.Open(path)) {
+		error = "Couldn't open " + path;
+		return false;
+	}
+
+	// Skip the UTF-8 byte order mark some editors write
+	const char* text = file.data;
+	size_t size = file.size;
+	if (size >= 3 && memcmp(text, "\xEF\xBB\xBF", 3) == 0) {
+		text += 3;
+		size -= 3;
+	}
+
+	Workspace::Open(path.substr(path.find_last_of("\\/") + 1))->editor.SetText(text, size);
+	error.clear();
+	return true;
+}
+
+// Saved scripts in a window of their own. Only the rows in view are submitted, and the search runs again only
+// when the query or the library changed.
+void drawLibrary(bool* open) {
+	static char query[128] = "";
+	static std::vector<int> results;
+	static int resultsVersion = -1;
+	static char saveName[128] = "";
+	static char saveTags[128] = "";
+	static std::string libraryError;
+
+	ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_Once);
+	if (!ImGui::Begin("Script library", open)) {
+		ImGui::End();
+		return;
+	}
+
+	ImGui::SetNextItemWidth(-1);
+	if (ImGui::InputTextWithHint("##query", "Search names and tags", query, sizeof(query)) || resultsVersion != Library::version) {
+		Library::Search(query, results);
+		resultsVersion = Library::version;
+	}
+
+	// Double click opens an entry, right click deletes it after the list is done with the results
+	std::string deleteName;
+	ImGui::BeginChild("##entries", ImVec2(0, -50), true);
+	ImGuiListClipper clipper;
+	clipper.Begin((int)results.size());
+	while (clipper.Step()) {
+		for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+			const Library::Entry& entry = Library::entries[results[i]];
+			ImGui::PushID(results[i]);
+			if (ImGui::Selectable(entry.name.c_str(), false, ImGuiSelectableFlags_AllowDoubleClick) && ImGui::IsMouseDoubleClicked(0)) {
+				std::string text;
+				if (Library::Read(entry, text)) {
+					Workspace::Open(entry.name)->editor.SetText(text.data(), text.size());
+					libraryError.clear();
+				}
+				else
+					libraryError = "Couldn't read " + entry.name;
+			}
+			if (ImGui::BeginPopupContextItem()) {
+				if (ImGui::MenuItem("Delete"))
+					deleteName = entry.name;
+				ImGui::EndPopup();
+			}
+			if (!entry.tags.empty()) {
+				ImGui::SameLine();
+				ImGui::TextDisabled("%s", entry.tags.c_str());
+			}
+			ImGui::PopID();
+		}
+	}
+	ImGui::EndChild();
+	if (!deleteName.empty() && !Library::Delete(deleteName))
+		libraryError = "Couldn't delete " + deleteName;
+
+	// Saves the active script, under its tab's name unless another one is given
+	ImGui::SetNextItemWidth(140);
+	ImGui::InputTextWithHint("##name", Workspace::active->name.c_str(), saveName, sizeof(saveName));
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(140);
+	ImGui::InputTextWithHint("##tags", "tags", saveTags, sizeof(saveTags));
+	ImGui::SameLine();
+	if (ImGui::Button("Save script")) {
+		std::string name = saveName[0] ? saveName : Workspace::active->name;
+		if (Library::Save(name, saveTags, Workspace::active->editor.GetText())) {
+			saveName[0] = saveTags[0] = '\0';
+			libraryError.clear();
+		}
+		else
+			libraryError = "Couldn't save " + name;
+	}
+	if (!libraryError.empty())
+		ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", libraryError.c_str());
+
+	ImGui::End();
+}
+
+// Find/replace row above the editor, refresh puts the pattern on an editor that was just switched to
+void drawFindBar(TextEditor& editor, bool focus, bool refresh) {
+	static char find[256] = "";
+	static char replace[256] = "";
+	static bool caseSensitive = false;
+	static bool regex = false;
+
+	ImGui::SetNextItemWidth(140);
+	if (focus)
+		ImGui::SetKeyboardFocusHere();
+	bool next = ImGui::InputTextWithHint("##find", "find", find, sizeof(find), ImGuiInputTextFlags_EnterReturnsTrue);
+	bool changed = ImGui::IsItemEdited() || focus || refresh;
+	// Enter drops the focus, keep it so Enter can be pressed again
+	if (next)
+		ImGui::SetKeyboardFocusHere(-1);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(140);
+	ImGui::InputTextWithHint("##replace", "replace", replace, sizeof(replace));
+	ImGui::SameLine();
+	changed |= ImGui::Checkbox("Aa", &caseSensitive);
+	ImGui::SameLine();
+	changed |= ImGui::Checkbox(".*", &regex);
+	if (changed)
+		editor.SetFindPattern(find, regex, caseSensitive);
+
+	ImGui::SameLine();
+	bool previous = ImGui::ArrowButton("##previous", ImGuiDir_Up);
+	ImGui::SameLine();
+	next |= ImGui::ArrowButton("##next", ImGuiDir_Down);
+	if (previous || (next && ImGui::GetIO().KeyShift))
+		editor.FindNext(true);
+	else if (next)
+		editor.FindNext();
+	ImGui::SameLine();
+	if (ImGui::Button("Replace"))
+		editor.ReplaceNext(replace);
+	ImGui::SameLine();
+	if (ImGui::Button("All"))
+		editor.ReplaceAll(replace);
+
+	ImGui::SameLine();
+	if (!editor.GetFindError().empty())
+		ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", editor.GetFindError().c_str());
+	else if (find[0]) {
+		int count = editor.GetFindMatchCount();
+		if (count < 0)
+			ImGui::TextDisabled("counting...");
+		else
+			ImGui::TextDisabled("%d found", count);
+	}
+}
+
+// Script files reloaded when saved elsewhere, each row shows what the last reload gave
+void drawWatcher(bool* open) {
+	static char watchPath[MAX_PATH] = "";
+
+	ImGui::SetNextWindowSize(ImVec2(460, 260), ImGuiCond_Once);
+	if (!ImGui::Begin("Watched files", open)) {
+		ImGui::End();
+		return;
+	}
+
+	ImGui::SetNextItemWidth(-68);
+	bool submit = ImGui::InputTextWithHint("##watchPath", "Path of a script to watch", watchPath, sizeof(watchPath), ImGuiInputTextFlags_EnterReturnsTrue);
+	ImGui::SameLine();
+	if ((ImGui::Button("Watch", ImVec2(60, 0)) || submit) && watchPath[0]) {
+		// Explorer's "Copy as path" wraps the path in quotes
+		std::string path = watchPath;
+		if (path.size() >= 2 && path.front() == '"' && path.back() == '"')
+			path = path.substr(1, path.size() - 2);
+		Watcher::Add(path, false);
+		watchPath[0] = '\0';
+	}
+
+	// The watcher thread updates the rows, changes to them are made after the list is done with them
+	int removeId = 0;
+	int runId = 0;
+	int toggleId = 0;
+	bool toggleValue = false;
+	ImGui::BeginChild("##files", ImVec2(0, 0), true);
+	{
+		std::lock_guard<std::mutex> lock(Watcher::mutex);
+		for (const Watcher::File& file : Watcher::files) {
+			ImGui::PushID(file.id);
+			bool autoRun = file.autoRun;
+			if (ImGui::Checkbox("##autoRun", &autoRun)) {
+				toggleId = file.id;
+				toggleValue = autoRun;
+			}
+			if (ImGui::IsItemHovered())
+				ImGui::SetTooltip("Run when saved");
+			ImGui::SameLine();
+			ImGui::TextUnformatted(Watcher::NameOf(file.path).c_str());
+			if (ImGui::IsItemHovered())
+				ImGui::SetTooltip("%s\nreloaded %d times", file.path.c_str(), file.loads);
+
+			ImGui::SameLine();
+			const ImVec4 red(1.0f, 0.3f, 0.3f, 1.0f);
+			switch (file.status) {
+			case Watcher::StatusWaiting: ImGui::TextDisabled("waiting"); break;
+			case Watcher::StatusLoaded: ImGui::TextDisabled("checked"); break;
+			case Watcher::StatusQueued: ImGui::TextDisabled("queued"); break;
+			case Watcher::StatusRan: ImGui::TextColored(ImVec4(0.4f, 0.9f, 0.4f, 1.0f), "ran"); break;
+			default: ImGui::TextColored(red, "%s", file.message.c_str()); break;
+			}
+
+			ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - 60);
+			if (ImGui::SmallButton("Run"))
+				runId = file.id;
+			ImGui::SameLine();
+			if (ImGui::SmallButton("X"))
+				removeId = file.id;
+			ImGui::PopID();
+		}
+	}
+	ImGui::EndChild();
+	if (toggleId)
+		Watcher::SetAutoRun(toggleId, toggleValue);
+	if (runId)
+		Watcher::RunNow(runId);
+	if (removeId)
+		Watcher::Remove(removeId);
+
+	ImGui::End();
+}
+
+// Editor minimap textures, in the same format the DX9 backend uses for the font atlas. Managed, so the runtime keeps
+// them across device resets and the game's Reset doesn't fail while one is alive.
+IDirect3DDevice9* minimapDevice = nullptr;
+
+ImTextureID createMinimapTexture(int width, int height) {
+	IDirect3DTexture9* texture = nullptr;
+	if (minimapDevice->CreateTexture(width, height, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &texture, nullptr) != D3D_OK)
+		return nullptr;
+	return (ImTextureID)texture;
+}
+
+// Copies only the rows that changed, swapping red and blue on the way
+void updateMinimapTexture(ImTextureID texture, int width, const ImU32* pixels, int rowStart, int rowEnd) {
+	IDirect3DTexture9* d3dTexture = (IDirect3DTexture9*)texture;
+	RECT rect = { 0, rowStart, width, rowEnd };
+	D3DLOCKED_RECT locked;
+	if (d3dTexture->LockRect(0, &locked, &rect, 0) != D3D_OK)
+		return;
+	for (int y = rowStart; y < rowEnd; y++) {
+		const ImU32* src = pixels + y * width;
+		DWORD* dst = (DWORD*)((unsigned char*)locked.pBits + (y - rowStart) * locked.Pitch);
+		for (int x = 0; x < width; x++)
+			dst[x] = (src[x] & 0xff00ff00) | ((src[x] & 0xff) << 16) | ((src[x] >> 16) & 0xff);
+	}
+	d3dTexture->UnlockRect(0);
+}
+
+void destroyMinimapTexture(ImTextureID texture) {
+	((IDirect3DTexture9*)texture)->Release();
+}
 
 typedef HRESULT(__stdcall* _Present)(IDirect3DDevice9*, CONST RECT*, CONST RECT*, HWND, CONST RGNDATA*);
 _Present oPresent;
@@ -10,18 +307,26 @@ HRESULT hkPresent(IDirect3DDevice9* pDevice, CONST RECT* x1, CONST RECT* x2, HWN
 	static bool init = false;
 	if (!init) {
 		init = true;
-		ImGui::CreateContext();
-
-		// Remove ini file
-		ImGuiIO& io = ImGui::GetIO();
-		io.IniFilename = "";
-
 		ImGui_ImplWin32_Init(FindWindow("Valve001", 0));
 		ImGui_ImplDX9_Init(pDevice);
 
-		ImGuiStyle* style = &ImGui::GetStyle();
-		style->WindowTitleAlign = ImVec2(0.5, 0.5);
-		style->WindowMinSize = ImVec2(300, 150);
+		// Upload the prebuilt atlas now instead of on the first frame the menu is shown
+		ImGui_ImplDX9_CreateDeviceObjects();
+
+		minimapDevice = pDevice;
+		TextEditor::SetTextureHandler({ createMinimapTexture, updateMinimapTexture, destroyMinimapTexture });
+	}
+
+	// Textures go on this thread while the device is certainly alive, not from the editors' destructors at unload
+	if (Globals::uninject) {
+		static bool released = false;
+		if (!released) {
+			released = true;
+			for (auto& tab : Workspace::tabs)
+				tab->editor.ReleaseMinimap();
+			TextEditor::SetTextureHandler({ nullptr, nullptr, nullptr });
+		}
+		return oPresent(pDevice, x1, x2, x3, x4);
 	}
 
 	if (!Globals::showMenu) return oPresent(pDevice, x1, x2, x3, x4);
@@ -41,34 +346,125 @@ HRESULT hkPresent(IDirect3DDevice9* pDevice, CONST RECT* x1, CONST RECT* x2, HWN
 	ImGui::SetNextWindowSize(ImVec2(600, 300), ImGuiCond_Once);
 	ImGui::Begin("glua executor - github.com/codabro", 0, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoScrollbar);
 
-	// Code editor
-	static TextEditor editor;
 	ImVec2 winSize = ImGui::GetWindowSize();
-	editor.Render("##Editor", ImVec2(winSize.x - 15, winSize.y - 55), false);
+	float top = ImGui::GetCursorPosY();
+
+	// Script tabs
+	if (Workspace::tabs.empty())
+		Workspace::Add();
+	bool tabChanged = false;
+	if (ImGui::BeginTabBar("##tabs", ImGuiTabBarFlags_AutoSelectNewTabs | ImGuiTabBarFlags_Reorderable | ImGuiTabBarFlags_FittingPolicyScroll)) {
+		Workspace::Tab* closed = nullptr;
+		for (auto& tab : Workspace::tabs) {
+			bool open = true;
+			std::string label = tab->name + "###tab" + std::to_string(tab->id);
+			if (ImGui::BeginTabItem(label.c_str(), &open)) {
+				tabChanged |= Workspace::Activate(tab.get());
+				ImGui::EndTabItem();
+			}
+			if (!open)
+				closed = tab.get();
+		}
+		if (ImGui::TabItemButton("+", ImGuiTabItemFlags_Trailing | ImGuiTabItemFlags_NoTooltip))
+			Workspace::Add();
+		ImGui::EndTabBar();
+
+		if (closed) {
+			Workspace::Close(closed);
+			tabChanged = true;
+		}
+	}
+
+	// Code editor
+	TextEditor& editor = Workspace::active->editor;
+
+	// Find bar, toggled with Ctrl+F
+	static bool showFind = false;
+	bool focusFind = false;
+	if (ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) && ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed('F', false)) {
+		showFind = !showFind;
+		focusFind = showFind;
+		if (!showFind)
+			editor.SetFindPattern("");
+	}
+	if (showFind)
+		drawFindBar(editor, focusFind, tabChanged);
+	else if (tabChanged)
+		editor.SetFindPattern("");
+
+	editor.Render("##Editor", ImVec2(winSize.x - 15, winSize.y - 55 - (ImGui::GetCursorPosY() - top)), false);
 
-	// Error markers
-	if (Globals::luaError.active) {
-		TextEditor::ErrorMarkers markers;
-		markers.insert(std::make_pair(Globals::luaError.line, Globals::luaError.error));
-		editor.SetErrorMarkers(markers);
-		Globals::luaError.active = false;
+	// Error markers, in whichever tab ran the script even if it isn't the one shown now
+	static std::vector<Executor::EditorError> errors;
+	Executor::TakeEditorErrors(errors);
+	for (const Executor::EditorError& error : errors) {
+		for (auto& tab : Workspace::tabs) {
+			if (tab->id != error.tab)
+				continue;
+			TextEditor::ErrorMarkers markers;
+			markers.insert(std::make_pair(error.line, error.message));
+			tab->editor.SetErrorMarkers(markers);
+		}
 	}
 
 	// Execute button
 	ImGui::SetCursorPosX(winSize.x - 67);
 	ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 3);
-	if (ImGui::Button("Execute", ImVec2(60, 20))) {
-		Globals::runLua = true;
-		Globals::lua = editor.GetText();
-	}
+	if (ImGui::Button("Execute", ImVec2(60, 20)))
+		Executor::Submit({ editor.GetText(), Globals::menuRealm, Workspace::active->id, Executor::MarkEditorError });
 
 	// Menu realm checkbox
 	ImGui::SetCursorPosX(winSize.x - 130);
 	ImGui::SetCursorPosY(ImGui::GetCursorPosY() - 23);
-	ImGui::Checkbox("menu", &Globals::menuRealm);
+	bool menuRealm = Globals::menuRealm;
+	if (ImGui::Checkbox("menu", &menuRealm))
+		Globals::menuRealm = menuRealm;
+
+	// Open button
+	ImGui::SetCursorPosX(8);
+	ImGui::SetCursorPosY(ImGui::GetCursorPosY() - 23);
+	if (ImGui::Button("Open", ImVec2(60, 20)))
+		ImGui::OpenPopup("Open script");
+
+	if (ImGui::BeginPopupModal("Open script", NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
+		static char openPath[MAX_PATH] = "";
+		static std::string openError;
+		ImGui::SetNextItemWidth(400);
+		bool submit = ImGui::InputText("##path", openPath, sizeof(openPath), ImGuiInputTextFlags_EnterReturnsTrue);
+		if (ImGui::Button("Open", ImVec2(60, 20)) || submit) {
+			if (openScript(openPath, openError))
+				ImGui::CloseCurrentPopup();
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Cancel", ImVec2(60, 20)))
+			ImGui::CloseCurrentPopup();
+		if (!openError.empty())
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", openError.c_str());
+		ImGui::EndPopup();
+	}
+
+	// Library button
+	static bool showLibrary = false;
+	ImGui::SameLine();
+	if (ImGui::Button("Library", ImVec2(60, 20)))
+		showLibrary = !showLibrary;
+
+	// Watched files button
+	static bool showWatcher = false;
+	ImGui::SameLine();
+	if (ImGui::Button("Watch", ImVec2(60, 20)))
+		showWatcher = !showWatcher;
 
 	ImGui::End();
 
+	if (showLibrary)
+		drawLibrary(&showLibrary);
+	if (showWatcher)
+		drawWatcher(&showWatcher);
+
+	// Hand this frame's edits to the journal
+	Autosave::Update();
+
 	// Finish up
 	ImGui::EndFrame();
 	ImGui::Render();
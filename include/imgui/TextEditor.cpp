@@ -3,11 +3,17 @@
 #include <string>
 #include <regex>
 #include <cmath>
+#include <cstring>
+#include <iterator>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "TextEditor.h"
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include "imgui.h" // for imGui::GetCurrentWindow()
+#include "imgui_internal.h" // for ImTextFindNonAscii()
 
 // TODO
 // - multiline comments vs single-line: latter is blocking start of a ML
@@ -24,9 +30,20 @@ bool equals(InputIt1 first1, InputIt1 last1,
 	return first1 == last1 && first2 == last2;
 }
 
+static bool IsSameLine(const std::vector<TextEditor::Char>& aCachedChars, const std::vector<uint8_t>& aCachedAttributes,
+	const TextEditor::Char* aChars, const uint8_t* aAttributes, int aSize)
+{
+	return aCachedChars.size() == (size_t)aSize && (aSize == 0 ||
+		(memcmp(aCachedChars.data(), aChars, aSize) == 0 && memcmp(aCachedAttributes.data(), aAttributes, aSize) == 0));
+}
+
 TextEditor::TextEditor()
 	: mLineSpacing(1.0f)
+	, mSuspended(false)
+	, mSuspendedLineCount(0)
+	, mUndoMemoryLimit(8 * 1024 * 1024)
 	, mUndoIndex(0)
+	, mRecordChanges(false)
 	, mTabSize(4)
 	, mOverwrite(false)
 	, mReadOnly(false)
@@ -47,24 +64,770 @@ TextEditor::TextEditor()
 	, mHandleMouseInputs(true)
 	, mIgnoreImGuiChild(false)
 	, mShowWhitespaces(false)
+	, mTextVersion(0)
+	, mColorizeBusy(false)
+	, mColorizeJobFrom(0)
+	, mColorizeJobCount(0)
+	, mColorizeThreadRunning(false)
+	, mColorizeStop(false)
 	, mStartTime(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count())
+	, mRenderCacheFirst(0)
+	, mRenderCacheFont(nullptr)
+	, mRenderCacheFontSize(0.0f)
+	, mRenderCacheTexture(nullptr)
+	, mRenderCacheTabSize(0)
+	, mRenderCacheWhitespaces(false)
+	, mGlyphPositionsFont(nullptr)
+	, mGlyphPositionsFontSize(0.0f)
+	, mGlyphPositionsTabSize(0)
+	, mBracketsVersion(0)
+	, mBracketHighlightsVersion(0)
+	, mFoldHidden(0)
+	, mShowMinimap(true)
+	, mMinimapTexture(nullptr)
+	, mMinimapLinesPerGroup(0)
+	, mMinimapRowsPerGroup(0)
+	, mMinimapGroups(0)
+	, mMinimapUploadStart(MinimapHeight)
+	, mMinimapUploadEnd(0)
+	, mMinimapPatternVersion(0)
+	, mMinimapFirstLine(0)
+	, mMinimapLastLine(0)
+	, mMinimapScrollLine(-1)
+	, mFindPatternVersion(0)
+	, mFindTextVersion(0)
+	, mFindCountTextVersion(0)
+	, mFindCountPatternVersion(0)
+	, mFindCount(0)
+	, mFindCountCancel(false)
+	, mDiagnoseVersion(0)
+	, mDiagnoseSeenVersion(0)
+	, mDiagnoseChangeTime(0.0)
+	, mDiagnoseBusy(false)
+	, mDiagnoseCancel(false)
+	, mDiagnoseThreadRunning(false)
+	, mDiagnoseStop(false)
 {
 	SetPalette(GetDarkPalette());
-	SetLanguageDefinition(LanguageDefinition::CPlusPlus());
-	mLines.push_back(Line());
+	// The keyword and identifier tables are large, every editor starts out on the same copy
+	static const std::shared_ptr<const LanguageDefinition> cplusplus = std::make_shared<const LanguageDefinition>(LanguageDefinition::CPlusPlus());
+	SetLanguageDefinition(cplusplus);
+	mLines.Insert(0, 1);
 }
 
 TextEditor::~TextEditor()
 {
+	{
+		std::lock_guard<std::mutex> lock(mColorizeMutex);
+		mColorizeStop = true;
+	}
+	mColorizeCondition.notify_one();
+	if (mColorizeThread.joinable())
+		mColorizeThread.join();
+	CancelFindCount();
+
+	mDiagnoseCancel = true;
+	{
+		std::lock_guard<std::mutex> lock(mDiagnoseMutex);
+		mDiagnoseStop = true;
+	}
+	mDiagnoseCondition.notify_one();
+	if (mDiagnoseThread.joinable())
+		mDiagnoseThread.join();
+
+	ReleaseMinimap();
+}
+
+// Set once by whoever owns the renderer, see SetTextureHandler()
+static TextEditor::TextureHandler sTextureHandler = { nullptr, nullptr, nullptr };
+
+// Number of '\n' in [aBegin, aEnd), 16 bytes at a time with SSE2
+static size_t CountLineBreaks(const char* aBegin, const char* aEnd)
+{
+	size_t count = 0;
+	const char* p = aBegin;
+#ifdef IMGUI_ENABLE_SSE
+	const __m128i newline = _mm_set1_epi8('\n');
+	while (aEnd - p >= 16)
+	{
+		// Each match subtracts -1 from its byte lane, which can take 255 blocks before the lanes are summed up
+		__m128i lanes = _mm_setzero_si128();
+		const char* blockEnd = p + std::min<size_t>((size_t)(aEnd - p) / 16, 255) * 16;
+		for (; p < blockEnd; p += 16)
+			lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+		const __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+		count += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+	}
+#endif
+	for (; p < aEnd; ++p)
+		count += *p == '\n';
+	return count;
+}
+
+struct TextEditor::Lines::Node
+{
+	Branch* mParent = nullptr;
+	bool mLeaf;
+	int mLineCount = 0;
+	size_t mCharCount = 0;
+
+	explicit Node(bool aLeaf) : mLeaf(aLeaf) {}
+};
+
+struct TextEditor::Lines::Leaf : Node
+{
+	std::vector<Line> mLines;
+	std::vector<Char> mChars;
+	std::vector<uint8_t> mAttributes;
+	Leaf* mPrev = nullptr;
+	Leaf* mNext = nullptr;
+
+	Leaf() : Node(true) {}
+};
+
+struct TextEditor::Lines::Branch : Node
+{
+	std::vector<Node*> mChildren;
+
+	Branch() : Node(false) {}
+};
+
+TextEditor::Lines::Lines()
+	: mRoot(new Leaf())
+	, mFinger(nullptr)
+	, mFingerFirst(0)
+{
+}
+
+TextEditor::Lines::~Lines()
+{
+	Free(mRoot);
+}
+
+void TextEditor::Lines::Free(Node* aNode)
+{
+	if (aNode->mLeaf)
+	{
+		delete static_cast<Leaf*>(aNode);
+		return;
+	}
+	for (auto child : static_cast<Branch*>(aNode)->mChildren)
+		Free(child);
+	delete static_cast<Branch*>(aNode);
+}
+
+int TextEditor::Lines::size() const
+{
+	return mRoot->mLineCount;
+}
+
+size_t TextEditor::Lines::GetCharCount() const
+{
+	return mRoot->mCharCount;
+}
+
+// The leaf holding line aIndex and the index of its first line, the last leaf for aIndex == size(). Lines next to the
+// one looked up last are found without going through the root, which makes walking over the lines O(1) per line.
+TextEditor::Lines::Leaf* TextEditor::Lines::FindLeaf(int aIndex, int& aFirst) const
+{
+	if (mFinger != nullptr)
+	{
+		if (aIndex >= mFingerFirst + mFinger->mLineCount && mFinger->mNext != nullptr && aIndex < mFingerFirst + mFinger->mLineCount + mFinger->mNext->mLineCount)
+		{
+			mFingerFirst += mFinger->mLineCount;
+			mFinger = mFinger->mNext;
+		}
+		else if (aIndex < mFingerFirst && mFinger->mPrev != nullptr && aIndex >= mFingerFirst - mFinger->mPrev->mLineCount)
+		{
+			mFinger = mFinger->mPrev;
+			mFingerFirst -= mFinger->mLineCount;
+		}
+		if (aIndex >= mFingerFirst && aIndex < mFingerFirst + mFinger->mLineCount)
+		{
+			aFirst = mFingerFirst;
+			return mFinger;
+		}
+	}
+
+	Node* node = mRoot;
+	int first = 0;
+	while (!node->mLeaf)
+	{
+		auto& children = static_cast<Branch*>(node)->mChildren;
+		size_t i = 0;
+		for (; i + 1 < children.size() && aIndex - first >= children[i]->mLineCount; ++i)
+			first += children[i]->mLineCount;
+		node = children[i];
+	}
+	mFinger = static_cast<Leaf*>(node);
+	mFingerFirst = first;
+	aFirst = first;
+	return mFinger;
+}
+
+TextEditor::Line& TextEditor::Lines::operator[](int aIndex)
+{
+	assert(aIndex >= 0 && aIndex < size());
+	int first;
+	Leaf* leaf = FindLeaf(aIndex, first);
+	return leaf->mLines[aIndex - first];
+}
+
+const TextEditor::Line& TextEditor::Lines::operator[](int aIndex) const
+{
+	assert(aIndex >= 0 && aIndex < size());
+	int first;
+	Leaf* leaf = FindLeaf(aIndex, first);
+	return leaf->mLines[aIndex - first];
+}
+
+// Every line before aIndex counts its chars and a line break
+size_t TextEditor::Lines::GetLineOffset(int aIndex) const
+{
+	size_t offset = 0;
+	int first = 0;
+	const Node* node = mRoot;
+	while (!node->mLeaf)
+	{
+		auto& children = static_cast<const Branch*>(node)->mChildren;
+		size_t i = 0;
+		for (; i + 1 < children.size() && aIndex - first >= children[i]->mLineCount; ++i)
+		{
+			first += children[i]->mLineCount;
+			offset += children[i]->mCharCount + children[i]->mLineCount;
+		}
+		node = children[i];
+	}
+	auto leaf = static_cast<const Leaf*>(node);
+	const int index = aIndex - first;
+	return offset + index + (index < (int)leaf->mLines.size() ? leaf->mLines[index].mStart : leaf->mChars.size());
+}
+
+int TextEditor::Lines::FindLine(size_t aOffset) const
+{
+	int first = 0;
+	const Node* node = mRoot;
+	while (!node->mLeaf)
+	{
+		auto& children = static_cast<const Branch*>(node)->mChildren;
+		size_t i = 0;
+		for (; i + 1 < children.size() && aOffset >= children[i]->mCharCount + children[i]->mLineCount; ++i)
+		{
+			first += children[i]->mLineCount;
+			aOffset -= children[i]->mCharCount + children[i]->mLineCount;
+		}
+		node = children[i];
+	}
+	auto& lines = static_cast<const Leaf*>(node)->mLines;
+	int index = 0;
+	while (index + 1 < (int)lines.size() && (size_t)(lines[index + 1].mStart + index + 1) <= aOffset)
+		++index;
+	return first + index;
+}
+
+void TextEditor::Lines::AddCounts(Node* aNode, int aLines, ptrdiff_t aChars)
+{
+	for (; aNode != nullptr; aNode = aNode->mParent)
+	{
+		aNode->mLineCount += aLines;
+		aNode->mCharCount += aChars;
+	}
+}
+
+void TextEditor::Lines::Insert(int aIndex, int aCount)
+{
+	assert(aIndex >= 0 && aIndex <= size());
+	if (aCount <= 0)
+		return;
+
+	int first;
+	Leaf* leaf = FindLeaf(aIndex, first);
+	auto& lines = leaf->mLines;
+	const int index = aIndex - first;
+	const int start = index < (int)lines.size() ? lines[index].mStart : (int)leaf->mChars.size();
+
+	// Lines only move, added at the end and rotated into place
+	const size_t oldSize = lines.size();
+	lines.resize(oldSize + aCount);
+	std::rotate(lines.begin() + index, lines.begin() + oldSize, lines.end());
+	for (int i = index; i < index + aCount; ++i)
+	{
+		lines[i].mLeaf = leaf;
+		lines[i].mStart = start;
+	}
+	AddCounts(leaf, aCount, 0);
+	mFinger = nullptr;
+	Split(leaf);
+}
+
+void TextEditor::Lines::Insert(int aIndex, const char* aText, const char* aTextEnd)
+{
+	assert(aIndex >= 0 && aIndex <= size());
+
+	int first;
+	Leaf* leaf = FindLeaf(aIndex, first);
+	auto& lines = leaf->mLines;
+	const int index = aIndex - first;
+	const int count = (int)CountLineBreaks(aText, aTextEnd) + 1;
+	const size_t charCount = (size_t)(aTextEnd - aText) - (count - 1);
+	const size_t start = index < (int)lines.size() ? lines[index].mStart : leaf->mChars.size();
+
+	// Everything goes into this leaf first, Split() cuts it into leaves of the usual size
+	leaf->mChars.insert(leaf->mChars.begin() + start, charCount, Char(0));
+	leaf->mAttributes.insert(leaf->mAttributes.begin() + start, charCount, uint8_t(0));
+	for (size_t i = index; i < lines.size(); ++i)
+		lines[i].mStart += (int)charCount;
+
+	const size_t oldSize = lines.size();
+	lines.resize(oldSize + count);
+	std::rotate(lines.begin() + index, lines.begin() + oldSize, lines.end());
+
+	Char* chars = leaf->mChars.data();
+	size_t at = start;
+	for (int i = index; i < index + count; ++i)
+	{
+		const char* lineEnd = (const char*)memchr(aText, '\n', aTextEnd - aText);
+		if (lineEnd == nullptr)
+			lineEnd = aTextEnd;
+		lines[i].mLeaf = leaf;
+		lines[i].mStart = (int)at;
+		lines[i].mSize = (int)(lineEnd - aText);
+		// An empty leaf has no buffer to copy into, memcpy wants a valid pointer even for nothing
+		if (lineEnd > aText)
+			memcpy(chars + at, aText, lineEnd - aText);
+		at += lineEnd - aText;
+		aText = lineEnd + 1;
+	}
+
+	AddCounts(leaf, count, (ptrdiff_t)charCount);
+	mFinger = nullptr;
+	Split(leaf);
+}
+
+void TextEditor::Lines::Erase(int aStart, int aEnd)
+{
+	assert(aStart >= 0 && aStart <= aEnd && aEnd <= size());
+
+	for (int remaining = aEnd - aStart; remaining > 0; )
+	{
+		int first;
+		Leaf* leaf = FindLeaf(aStart, first);
+		auto& lines = leaf->mLines;
+		const int index = aStart - first;
+		const int count = std::min(remaining, (int)lines.size() - index);
+		remaining -= count;
+		mFinger = nullptr;
+
+		// Whole leaves go at once, except the last one left
+		if (count == (int)lines.size() && (leaf->mPrev != nullptr || leaf->mNext != nullptr))
+		{
+			Remove(leaf);
+			continue;
+		}
+
+		const size_t from = lines[index].mStart;
+		const size_t to = index + count < (int)lines.size() ? lines[index + count].mStart : leaf->mChars.size();
+		leaf->mChars.erase(leaf->mChars.begin() + from, leaf->mChars.begin() + to);
+		leaf->mAttributes.erase(leaf->mAttributes.begin() + from, leaf->mAttributes.begin() + to);
+		lines.erase(lines.begin() + index, lines.begin() + index + count);
+		for (size_t i = index; i < lines.size(); ++i)
+			lines[i].mStart -= (int)(to - from);
+		AddCounts(leaf, -count, -(ptrdiff_t)(to - from));
+	}
+
+	if (!empty())
+	{
+		int first;
+		Merge(FindLeaf(std::min(aStart, size() - 1), first));
+	}
+
+	// A root left with a single child is replaced by it
+	while (!mRoot->mLeaf && static_cast<Branch*>(mRoot)->mChildren.size() == 1)
+	{
+		Branch* root = static_cast<Branch*>(mRoot);
+		mRoot = root->mChildren[0];
+		mRoot->mParent = nullptr;
+		root->mChildren.clear();
+		delete root;
+	}
+}
+
+void TextEditor::Lines::Clear()
+{
+	Free(mRoot);
+	mRoot = new Leaf();
+	mFinger = nullptr;
+}
+
+// Cuts a leaf that has grown past LeafLines lines or LeafChars chars into leaves filled halfway, all but the first
+// one new and put after it
+void TextEditor::Lines::Split(Leaf* aLeaf)
+{
+	auto& lines = aLeaf->mLines;
+	const int lineCount = (int)lines.size();
+	if (lineCount <= LeafLines && (aLeaf->mChars.size() <= (size_t)LeafChars || lineCount <= 1))
+		return;
+
+	auto pieceEnd = [&](int aBegin) {
+		int end = aBegin + 1;
+		int chars = lines[aBegin].mSize;
+		while (end < lineCount && end - aBegin < LeafLines / 2 && chars + lines[end].mSize <= LeafChars / 2)
+			chars += lines[end++].mSize;
+		return end;
+	};
+
+	const int kept = pieceEnd(0);
+	std::vector<Node*> pieces;
+	Leaf* previous = aLeaf;
+	for (int begin = kept; begin < lineCount; )
+	{
+		const int end = pieceEnd(begin);
+		const size_t from = lines[begin].mStart;
+		const size_t to = end < lineCount ? lines[end].mStart : aLeaf->mChars.size();
+
+		Leaf* leaf = new Leaf();
+		leaf->mChars.assign(aLeaf->mChars.begin() + from, aLeaf->mChars.begin() + to);
+		leaf->mAttributes.assign(aLeaf->mAttributes.begin() + from, aLeaf->mAttributes.begin() + to);
+		leaf->mLines.reserve(end - begin);
+		for (int i = begin; i < end; ++i)
+		{
+			leaf->mLines.push_back(std::move(lines[i]));
+			leaf->mLines.back().mLeaf = leaf;
+			leaf->mLines.back().mStart -= (int)from;
+		}
+		leaf->mLineCount = end - begin;
+		leaf->mCharCount = to - from;
+
+		leaf->mPrev = previous;
+		leaf->mNext = previous->mNext;
+		if (leaf->mNext != nullptr)
+			leaf->mNext->mPrev = leaf;
+		previous->mNext = leaf;
+		previous = leaf;
+
+		pieces.push_back(leaf);
+		begin = end;
+	}
+
+	// The counts of the branches above already include the new leaves
+	const size_t keptChars = lines[kept].mStart;
+	lines.erase(lines.begin() + kept, lines.end());
+	aLeaf->mChars.resize(keptChars);
+	aLeaf->mAttributes.resize(keptChars);
+	aLeaf->mChars.shrink_to_fit();
+	aLeaf->mAttributes.shrink_to_fit();
+	aLeaf->mLineCount = kept;
+	aLeaf->mCharCount = keptChars;
+
+	InsertAfter(aLeaf, pieces);
+	mFinger = nullptr;
+}
+
+// Puts aNodes after aNode in its parent, whose counts (and those above) already include them. A parent getting more
+// than BranchChildren children is split the same way as a leaf, a new root is added when the root is.
+void TextEditor::Lines::InsertAfter(Node* aNode, std::vector<Node*>& aNodes)
+{
+	Branch* parent = aNode->mParent;
+	if (parent == nullptr)
+	{
+		parent = new Branch();
+		parent->mChildren.push_back(aNode);
+		aNode->mParent = parent;
+		parent->mLineCount = aNode->mLineCount;
+		parent->mCharCount = aNode->mCharCount;
+		for (auto node : aNodes)
+		{
+			parent->mLineCount += node->mLineCount;
+			parent->mCharCount += node->mCharCount;
+		}
+		mRoot = parent;
+	}
+
+	auto& children = parent->mChildren;
+	for (auto node : aNodes)
+		node->mParent = parent;
+	children.insert(std::find(children.begin(), children.end(), aNode) + 1, aNodes.begin(), aNodes.end());
+	if ((int)children.size() <= BranchChildren)
+		return;
+
+	std::vector<Node*> pieces;
+	for (size_t begin = BranchChildren / 2; begin < children.size(); begin += BranchChildren / 2)
+	{
+		Branch* branch = new Branch();
+		const size_t end = std::min(children.size(), begin + BranchChildren / 2);
+		branch->mChildren.assign(children.begin() + begin, children.begin() + end);
+		for (auto child : branch->mChildren)
+		{
+			child->mParent = branch;
+			branch->mLineCount += child->mLineCount;
+			branch->mCharCount += child->mCharCount;
+		}
+		parent->mLineCount -= branch->mLineCount;
+		parent->mCharCount -= branch->mCharCount;
+		pieces.push_back(branch);
+	}
+	children.resize(BranchChildren / 2);
+	InsertAfter(parent, pieces);
+}
+
+// Takes a node out of the tree and frees it, along with the branches above left without children
+void TextEditor::Lines::Remove(Node* aNode)
+{
+	Branch* parent = aNode->mParent;
+	AddCounts(parent, -aNode->mLineCount, -(ptrdiff_t)aNode->mCharCount);
+	auto& children = parent->mChildren;
+	children.erase(std::find(children.begin(), children.end(), aNode));
+
+	if (aNode->mLeaf)
+	{
+		Leaf* leaf = static_cast<Leaf*>(aNode);
+		if (leaf->mPrev != nullptr)
+			leaf->mPrev->mNext = leaf->mNext;
+		if (leaf->mNext != nullptr)
+			leaf->mNext->mPrev = leaf->mPrev;
+	}
+	Free(aNode);
+	mFinger = nullptr;
+
+	if (children.empty() && parent != mRoot)
+		Remove(parent);
+}
+
+// Joins a leaf that lines were removed from with a neighbor under the same parent, when both together are still small
+void TextEditor::Lines::Merge(Leaf* aLeaf)
+{
+	auto fits = [](const Leaf* a, const Leaf* b) {
+		return a->mLineCount + b->mLineCount <= LeafLines / 2 && a->mCharCount + b->mCharCount <= (size_t)LeafChars / 2;
+	};
+
+	Leaf* into = aLeaf;
+	Leaf* from = aLeaf->mNext;
+	if (from == nullptr || from->mParent != aLeaf->mParent || !fits(into, from))
+	{
+		into = aLeaf->mPrev;
+		from = aLeaf;
+		if (into == nullptr || into->mParent != aLeaf->mParent || !fits(into, from))
+			return;
+	}
+
+	const int offset = (int)into->mChars.size();
+	into->mChars.insert(into->mChars.end(), from->mChars.begin(), from->mChars.end());
+	into->mAttributes.insert(into->mAttributes.end(), from->mAttributes.begin(), from->mAttributes.end());
+	for (auto& line : from->mLines)
+	{
+		into->mLines.push_back(std::move(line));
+		into->mLines.back().mLeaf = into;
+		into->mLines.back().mStart += offset;
+	}
+
+	// Only moved between siblings, the counts of the parent stay
+	into->mLineCount += from->mLineCount;
+	into->mCharCount += from->mCharCount;
+	from->mLineCount = 0;
+	from->mCharCount = 0;
+	Remove(from);
+}
+
+const TextEditor::Char* TextEditor::Line::Chars() const
+{
+	return mLeaf->mChars.data() + mStart;
+}
+
+const uint8_t* TextEditor::Line::Attributes() const
+{
+	return mLeaf->mAttributes.data() + mStart;
+}
+
+uint8_t* TextEditor::Line::Attributes()
+{
+	return mLeaf->mAttributes.data() + mStart;
+}
+
+// Makes room for aCount glyphs at aIndex, returns their offset in the leaf. The leaf's arrays may move.
+size_t TextEditor::Line::Grow(int aIndex, int aCount)
+{
+	assert(aIndex >= 0 && aIndex <= mSize);
+	Lines::Leaf* leaf = mLeaf;
+	const size_t at = mStart + aIndex;
+	leaf->mChars.insert(leaf->mChars.begin() + at, (size_t)aCount, Char(0));
+	leaf->mAttributes.insert(leaf->mAttributes.begin() + at, (size_t)aCount, uint8_t(0));
+	mSize += aCount;
+	for (Line* line = this + 1, *end = leaf->mLines.data() + leaf->mLines.size(); line != end; ++line)
+		line->mStart += aCount;
+	Lines::AddCounts(leaf, 0, aCount);
+	return at;
+}
+
+void TextEditor::Line::Insert(int aIndex, const Char* aChars, int aCount, uint8_t aAttributes)
+{
+	if (aCount <= 0)
+		return;
+
+	// Chars of a line in the same leaf (an indentation copied) would move under our feet
+	auto& chars = mLeaf->mChars;
+	if (aChars >= chars.data() && aChars < chars.data() + chars.size())
+	{
+		std::vector<Char> copy(aChars, aChars + aCount);
+		Insert(aIndex, copy.data(), aCount, aAttributes);
+		return;
+	}
+
+	const size_t at = Grow(aIndex, aCount);
+	memcpy(mLeaf->mChars.data() + at, aChars, aCount);
+	memset(mLeaf->mAttributes.data() + at, aAttributes, aCount);
+}
+
+void TextEditor::Line::Insert(int aIndex, const Line& aFrom, int aStart, int aEnd)
+{
+	const int count = aEnd - aStart;
+	if (count <= 0)
+		return;
+
+	if (aFrom.mLeaf == mLeaf)
+	{
+		std::vector<Char> chars(aFrom.Chars() + aStart, aFrom.Chars() + aEnd);
+		std::vector<uint8_t> attributes(aFrom.Attributes() + aStart, aFrom.Attributes() + aEnd);
+		const size_t at = Grow(aIndex, count);
+		memcpy(mLeaf->mChars.data() + at, chars.data(), count);
+		memcpy(mLeaf->mAttributes.data() + at, attributes.data(), count);
+		return;
+	}
+
+	const size_t at = Grow(aIndex, count);
+	memcpy(mLeaf->mChars.data() + at, aFrom.Chars() + aStart, count);
+	memcpy(mLeaf->mAttributes.data() + at, aFrom.Attributes() + aStart, count);
+}
+
+void TextEditor::Line::Erase(int aStart, int aEnd)
+{
+	assert(aStart >= 0 && aStart <= aEnd && aEnd <= mSize);
+	const int count = aEnd - aStart;
+	if (count <= 0)
+		return;
+
+	Lines::Leaf* leaf = mLeaf;
+	const size_t at = mStart + aStart;
+	leaf->mChars.erase(leaf->mChars.begin() + at, leaf->mChars.begin() + at + count);
+	leaf->mAttributes.erase(leaf->mAttributes.begin() + at, leaf->mAttributes.begin() + at + count);
+	mSize -= count;
+	for (Line* line = this + 1, *end = leaf->mLines.data() + leaf->mLines.size(); line != end; ++line)
+		line->mStart -= count;
+	Lines::AddCounts(leaf, 0, -(ptrdiff_t)count);
+}
+
+void TextEditor::Suspend()
+{
+	if (mSuspended)
+		return;
+
+	// Take the colors of a finished background pass first, a pass still running is applied after Resume()
+	if (mColorizeBusy)
+		ApplyFinishedColorizeJob();
+
+	mSuspendedText = GetText();
+	mSuspendedRuns.clear();
+	uint8_t attributes = 0;
+	int count = 0;
+	mSuspendedStates.resize(mLines.size());
+	for (int i = 0; i < mLines.size(); ++i)
+	{
+		auto& line = mLines[i];
+		const uint8_t* lineAttributes = line.Attributes();
+		for (int j = 0; j < line.size(); ++j)
+		{
+			if (count > 0 && (lineAttributes[j] != attributes || count == 255))
+			{
+				mSuspendedRuns.push_back(attributes);
+				mSuspendedRuns.push_back((uint8_t)count);
+				count = 0;
+			}
+			attributes = lineAttributes[j];
+			++count;
+		}
+		mSuspendedStates[i] = line.mState;
+	}
+	if (count > 0)
+	{
+		mSuspendedRuns.push_back(attributes);
+		mSuspendedRuns.push_back((uint8_t)count);
+	}
+	mSuspendedRuns.shrink_to_fit();
+	mSuspendedLineCount = mLines.size();
+	mSuspended = true;
+
+	mLines.Clear();
+	std::vector<BracketChunk>().swap(mBracketChunks);
+	std::vector<RenderCacheLine>().swap(mRenderCache);
+	ReleaseMinimap();
+
+	CancelFindCount();
+	mFindText.reset();
+	std::string().swap(mFindLineText);
+}
+
+void TextEditor::Resume()
+{
+	if (!mSuspended)
+		return;
+
+	// Same line split as GetText() joined them with, carriage returns in the text are glyphs like any other
+	mLines.Insert(0, mSuspendedText.data(), mSuspendedText.data() + mSuspendedText.size());
+	assert(mLines.size() == mSuspendedLineCount);
+
+	auto run = mSuspendedRuns.begin();
+	int runLeft = 0;
+	uint8_t runAttributes = 0;
+	for (int i = 0; i < mLines.size(); ++i)
+	{
+		auto& line = mLines[i];
+		uint8_t* attributes = line.Attributes();
+		for (int j = 0; j < line.size(); )
+		{
+			if (runLeft == 0)
+			{
+				runAttributes = *run++;
+				runLeft = *run++;
+			}
+			const int count = std::min(runLeft, line.size() - j);
+			memset(attributes + j, runAttributes, count);
+			runLeft -= count;
+			j += count;
+		}
+		line.mState = mSuspendedStates[i];
+	}
+	++mBracketsVersion;
+
+	DiscardSuspended();
+}
+
+void TextEditor::DiscardSuspended()
+{
+	mSuspended = false;
+	mSuspendedLineCount = 0;
+	std::string().swap(mSuspendedText);
+	std::vector<uint8_t>().swap(mSuspendedRuns);
+	std::vector<int>().swap(mSuspendedStates);
 }
 
 void TextEditor::SetLanguageDefinition(const LanguageDefinition& aLanguageDef)
 {
-	mLanguageDefinition = aLanguageDef;
+	SetLanguageDefinition(std::make_shared<const LanguageDefinition>(aLanguageDef));
+}
+
+void TextEditor::SetLanguageDefinition(std::shared_ptr<const LanguageDefinition> aLanguageDef)
+{
+	// Shared with the colorizer thread, jobs already queued keep the old one alive
+	mLanguageDefinition = std::move(aLanguageDef);
 	mRegexList.clear();
+	for (int i = 0; i < mLines.size(); ++i)
+		mLines[i].mState = -1;
+	mSuspendedStates.assign(mSuspendedStates.size(), -1);
+	mDiagnostics.clear();
 
-	for (auto& r : mLanguageDefinition.mTokenRegexStrings)
-		mRegexList.push_back(std::make_pair(std::regex(r.first, std::regex_constants::optimize), r.second));
+	// The stateful scanner never falls back to the regexes, don't pay for compiling them
+	if (mLanguageDefinition->mStatefulTokenize == nullptr)
+		for (auto& r : mLanguageDefinition->mTokenRegexStrings)
+			mRegexList.push_back(std::make_pair(std::regex(r.first, std::regex_constants::optimize), r.second));
 
 	Colorize();
 }
@@ -81,10 +844,10 @@ std::string TextEditor::GetText(const Coordinates& aStart, const Coordinates& aE
 	auto lstart = aStart.mLine;
 	auto lend = aEnd.mLine;
 	auto istart = GetCharacterIndex(aStart);
-	auto iend = GetCharacterIndex(aEnd)+1;
+	auto iend = GetCharacterIndex(aEnd);
 	size_t s = 0;
 
-	for (size_t i = lstart; i < lend; i++)
+	for (int i = lstart; i < lend; i++)
 		s += mLines[i].size();
 
 	result.reserve(s + s / 8);
@@ -97,8 +860,9 @@ std::string TextEditor::GetText(const Coordinates& aStart, const Coordinates& aE
 		auto& line = mLines[lstart];
 		if (istart < (int)line.size())
 		{
-			result += line[istart].mChar;
-			istart++;
+			const int to = lstart < lend ? line.size() : std::min(line.size(), iend);
+			result.append((const char*)line.Chars() + istart, to - istart);
+			istart = to;
 		}
 		else
 		{
@@ -108,7 +872,6 @@ std::string TextEditor::GetText(const Coordinates& aStart, const Coordinates& aE
 		}
 	}
 
-	result = result.substr(0, result.size() - 1);
 	return result;
 }
 
@@ -146,6 +909,8 @@ TextEditor::Coordinates TextEditor::SanitizeCoordinates(const Coordinates& aValu
 // We assume that the char is a standalone character (<128) or a leading byte of an UTF-8 code sequence (non-10xxxxxx code)
 static int UTF8CharLength(TextEditor::Char c)
 {
+	if (c < 0x80)
+		return 1;
 	if ((c & 0xFE) == 0xFC)
 		return 6;
 	if ((c & 0xFC) == 0xF8)
@@ -159,6 +924,21 @@ static int UTF8CharLength(TextEditor::Char c)
 	return 1;
 }
 
+static bool IsUTFSequence(char c)
+{
+	return (c & 0xC0) == 0x80;
+}
+
+static void SetGlyphColor(uint8_t& aAttributes, TextEditor::PaletteIndex aColor)
+{
+	aAttributes = (uint8_t)((aAttributes & ~TextEditor::Glyph::ColorMask) | (int)aColor);
+}
+
+static void SetGlyphFlag(uint8_t& aAttributes, uint8_t aFlag, bool aValue)
+{
+	aAttributes = (uint8_t)(aValue ? aAttributes | aFlag : aAttributes & ~aFlag);
+}
+
 // "Borrowed" from ImGui source
 static inline int ImTextCharToUtf8(char* buf, int buf_size, unsigned int c)
 {
@@ -236,25 +1016,24 @@ void TextEditor::DeleteRange(const Coordinates& aStart, const Coordinates& aEnd)
 		auto& line = mLines[aStart.mLine];
 		auto n = GetLineMaxColumn(aStart.mLine);
 		if (aEnd.mColumn >= n)
-			line.erase(line.begin() + start, line.end());
+			line.Erase(start, line.size());
 		else
-			line.erase(line.begin() + start, line.begin() + end);
+			line.Erase(start, end);
 	}
 	else
 	{
 		auto& firstLine = mLines[aStart.mLine];
 		auto& lastLine = mLines[aEnd.mLine];
 
-		firstLine.erase(firstLine.begin() + start, firstLine.end());
-		lastLine.erase(lastLine.begin(), lastLine.begin() + end);
-
+		firstLine.Erase(start, firstLine.size());
 		if (aStart.mLine < aEnd.mLine)
-			firstLine.insert(firstLine.end(), lastLine.begin(), lastLine.end());
+			firstLine.Insert(firstLine.size(), lastLine, end, lastLine.size());
 
 		if (aStart.mLine < aEnd.mLine)
 			RemoveLine(aStart.mLine + 1, aEnd.mLine + 1);
 	}
 
+	Colorize(aStart.mLine, 1);
 	mTextChanged = true;
 }
 
@@ -262,48 +1041,53 @@ int TextEditor::InsertTextAt(Coordinates& /* inout */ aWhere, const char* aValue
 {
 	assert(!mReadOnly);
 
-	int cindex = GetCharacterIndex(aWhere);
-	int totalLines = 0;
-	while (*aValue != '\0')
+	const int cindex = GetCharacterIndex(aWhere);
+	const int startLine = aWhere.mLine;
+	const char* valueEnd = aValue + strlen(aValue);
+
+	// Carriage returns are dropped
+	std::string stripped;
+	if (memchr(aValue, '\r', valueEnd - aValue) != nullptr)
 	{
-		assert(!mLines.empty());
+		stripped.assign(aValue, valueEnd);
+		stripped.erase(std::remove(stripped.begin(), stripped.end(), '\r'), stripped.end());
+		aValue = stripped.data();
+		valueEnd = aValue + stripped.size();
+	}
 
-		if (*aValue == '\r')
-		{
-			// skip
-			++aValue;
-		}
-		else if (*aValue == '\n')
-		{
-			if (cindex < (int)mLines[aWhere.mLine].size())
-			{
-				auto& newLine = InsertLine(aWhere.mLine + 1);
-				auto& line = mLines[aWhere.mLine];
-				newLine.insert(newLine.begin(), line.begin() + cindex, line.end());
-				line.erase(line.begin() + cindex, line.end());
-			}
-			else
-			{
-				InsertLine(aWhere.mLine + 1);
-			}
-			++aWhere.mLine;
-			aWhere.mColumn = 0;
-			cindex = 0;
-			++totalLines;
-			++aValue;
-		}
-		else
-		{
-			auto& line = mLines[aWhere.mLine];
-			auto d = UTF8CharLength(*aValue);
-			while (d-- > 0 && *aValue != '\0')
-				line.insert(line.begin() + cindex++, Glyph(*aValue++, PaletteIndex::Default));
-			++aWhere.mColumn;
-		}
+	// The text up to the first line break goes into the line, the lines after it are inserted in one go
+	const char* firstBreak = (const char*)memchr(aValue, '\n', valueEnd - aValue);
+	const char* firstEnd = firstBreak != nullptr ? firstBreak : valueEnd;
+	mLines[startLine].Insert(cindex, (const Char*)aValue, (int)(firstEnd - aValue));
 
-		mTextChanged = true;
+	int totalLines = 0;
+	if (firstBreak == nullptr)
+	{
+		aWhere.mColumn = GetCharacterColumn(startLine, cindex + (int)(valueEnd - aValue));
+	}
+	else
+	{
+		totalLines = InsertLines(startLine + 1, firstBreak + 1, valueEnd);
+
+		// What followed the insertion point ends up after the last inserted line
+		auto& firstLine = mLines[startLine];
+		auto& lastLine = mLines[startLine + totalLines];
+		const int tail = cindex + (int)(firstEnd - aValue);
+		lastLine.Insert(lastLine.size(), firstLine, tail, firstLine.size());
+		firstLine.Erase(tail, firstLine.size());
+
+		const char* lastBegin = valueEnd;
+		while (lastBegin[-1] != '\n')
+			--lastBegin;
+		aWhere.mLine = startLine + totalLines;
+		aWhere.mColumn = GetCharacterColumn(aWhere.mLine, (int)(valueEnd - lastBegin));
 	}
 
+	if (aValue < valueEnd)
+		mTextChanged = true;
+
+	// Callers pass their own ranges to Colorize, but undo/redo don't always cover every touched line
+	Colorize(startLine, totalLines + 1);
 	return totalLines;
 }
 
@@ -317,9 +1101,142 @@ void TextEditor::AddUndo(UndoRecord& aValue)
 	//	aValue.mAfter.mCursorPosition.mLine, aValue.mAfter.mCursorPosition.mColumn
 	//	);
 
-	mUndoBuffer.resize((size_t)(mUndoIndex + 1));
-	mUndoBuffer.back() = aValue;
+	// The edit is already applied and both ranges start at the same place, before anything that changed
+	if (mRecordChanges)
+	{
+		const auto& start = aValue.mRemoved.empty() ? aValue.mAddedStart : aValue.mRemovedStart;
+		RecordChange(start, aValue.mRemoved.size(), aValue.mAdded.data(), aValue.mAdded.size());
+	}
+
+	// Drop the undone records, their text is at the end of the log
+	if (mUndoIndex < (int)mUndoBuffer.size())
+	{
+		mUndoText.resize(mUndoBuffer[mUndoIndex].mText);
+		mUndoBuffer.resize((size_t)mUndoIndex);
+	}
+	else if (mUndoIndex > 0 && MergeUndo(mUndoBuffer.back(), aValue))
+	{
+		return;
+	}
+
+	UndoEntry entry;
+	entry.mText = mUndoText.size();
+	entry.mAddedLength = aValue.mAdded.size();
+	entry.mRemovedLength = aValue.mRemoved.size();
+	entry.mAddedStart = aValue.mAddedStart;
+	entry.mAddedEnd = aValue.mAddedEnd;
+	entry.mRemovedStart = aValue.mRemovedStart;
+	entry.mRemovedEnd = aValue.mRemovedEnd;
+	entry.mBefore = aValue.mBefore;
+	entry.mAfter = aValue.mAfter;
+
+	mUndoText.append(aValue.mAdded.c_str(), aValue.mAdded.size() + 1);
+	mUndoText.append(aValue.mRemoved.c_str(), aValue.mRemoved.size() + 1);
+	mUndoBuffer.push_back(entry);
 	++mUndoIndex;
+
+	TrimUndoBuffer();
+}
+
+void TextEditor::RecordChange(const Coordinates& aAt, size_t aRemoved, const char* aText, size_t aLength)
+{
+	if (!mRecordChanges)
+		return;
+
+	Change change;
+	change.mLine = aAt.mLine;
+	change.mIndex = GetCharacterIndex(aAt);
+	change.mRemoved = aRemoved;
+	// Carriage returns never make it into the lines, InsertTextAt drops them
+	change.mText.assign(aText, aLength);
+	change.mText.erase(std::remove(change.mText.begin(), change.mText.end(), '\r'), change.mText.end());
+	mChanges.push_back(std::move(change));
+}
+
+// Folds typing, backspacing or deleting within a line into the last record when it continues it
+bool TextEditor::MergeUndo(UndoEntry& aLast, const UndoRecord& aValue)
+{
+	const char* lastAdded = mUndoText.c_str() + aLast.mText;
+	const char* lastRemoved = lastAdded + aLast.mAddedLength + 1;
+	auto isSpace = [](char c) { return c == ' ' || c == '\t'; };
+
+	if (aValue.mRemoved.empty() && aLast.mRemovedLength == 0)
+	{
+		// Typing right after the last inserted text, a word following whitespace starts a new record
+		if (aValue.mAdded.empty() || aLast.mAddedLength == 0 || aValue.mAddedStart != aLast.mAddedEnd ||
+			aValue.mAdded.find('\n') != std::string::npos || memchr(lastAdded, '\n', aLast.mAddedLength) != nullptr ||
+			(isSpace(lastAdded[aLast.mAddedLength - 1]) && !isSpace(aValue.mAdded[0])))
+			return false;
+
+		// The record is the last one in the log, rewrite its tail
+		mUndoText.resize(aLast.mText + aLast.mAddedLength);
+		mUndoText.append(aValue.mAdded.c_str(), aValue.mAdded.size() + 1);
+		mUndoText.push_back('\0');
+		aLast.mAddedLength += aValue.mAdded.size();
+		aLast.mAddedEnd = aValue.mAddedEnd;
+		aLast.mAfter = aValue.mAfter;
+		return true;
+	}
+
+	if (aValue.mAdded.empty() && aLast.mAddedLength == 0)
+	{
+		if (aValue.mRemoved.empty() || aLast.mRemovedLength == 0 ||
+			aValue.mRemoved.find('\n') != std::string::npos || memchr(lastRemoved, '\n', aLast.mRemovedLength) != nullptr)
+			return false;
+
+		std::string removed;
+		if (aValue.mRemovedEnd == aLast.mRemovedStart)
+		{
+			// Backspace: the removed text ends where the last removal started
+			removed = aValue.mRemoved + lastRemoved;
+			aLast.mRemovedStart = aValue.mRemovedStart;
+		}
+		else if (aValue.mRemovedStart == aLast.mRemovedStart &&
+			aValue.mRemoved.find('\t') == std::string::npos && memchr(lastRemoved, '\t', aLast.mRemovedLength) == nullptr)
+		{
+			// Delete: the text after the last removal, the end column stays valid in the original text as long as there are no tabs
+			removed = lastRemoved + aValue.mRemoved;
+			aLast.mRemovedEnd.mColumn += aValue.mRemovedEnd.mColumn - aValue.mRemovedStart.mColumn;
+		}
+		else
+		{
+			return false;
+		}
+
+		mUndoText.resize(aLast.mText + 1);
+		mUndoText.append(removed.c_str(), removed.size() + 1);
+		aLast.mRemovedLength = removed.size();
+		aLast.mAfter = aValue.mAfter;
+		return true;
+	}
+
+	return false;
+}
+
+// Drops the oldest records once the history takes more than mUndoMemoryLimit bytes, the newest one is always kept
+void TextEditor::TrimUndoBuffer()
+{
+	auto usage = mUndoText.size() + mUndoBuffer.size() * sizeof(UndoEntry);
+	if (usage <= mUndoMemoryLimit)
+		return;
+
+	// Go well below the limit so the log isn't compacted again on the next edit
+	const size_t target = mUndoMemoryLimit / 4 * 3;
+	size_t dropped = 0;
+	while (dropped + 1 < mUndoBuffer.size() && usage > target)
+	{
+		usage -= (mUndoBuffer[dropped + 1].mText - mUndoBuffer[dropped].mText) + sizeof(UndoEntry);
+		++dropped;
+	}
+	if (dropped == 0)
+		return;
+
+	const size_t textStart = mUndoBuffer[dropped].mText;
+	mUndoText.erase(0, textStart);
+	mUndoBuffer.erase(mUndoBuffer.begin(), mUndoBuffer.begin() + dropped);
+	for (auto& entry : mUndoBuffer)
+		entry.mText -= textStart;
+	mUndoIndex = std::max(0, mUndoIndex - (int)dropped);
 }
 
 TextEditor::Coordinates TextEditor::ScreenPosToCoordinates(const ImVec2& aPosition) const
@@ -327,48 +1244,32 @@ TextEditor::Coordinates TextEditor::ScreenPosToCoordinates(const ImVec2& aPositi
 	ImVec2 origin = ImGui::GetCursorScreenPos();
 	ImVec2 local(aPosition.x - origin.x, aPosition.y - origin.y);
 
-	int lineNo = std::max(0, (int)floor(local.y / mCharAdvance.y));
+	const int row = std::max(0, (int)floor(local.y / mCharAdvance.y));
+	int lineNo = row < GetRowCount() ? RowToLine(row) : row + mFoldHidden;
 
 	int columnCoord = 0;
 
 	if (lineNo >= 0 && lineNo < (int)mLines.size())
 	{
-		auto& line = mLines.at(lineNo);
+		auto& line = mLines[lineNo];
+		auto& positions = GetGlyphPositions(lineNo);
 
-		int columnIndex = 0;
-		float columnX = 0.0f;
-
-		while ((size_t)columnIndex < line.size())
+		// Find the character under the position, the column is after it when its right half was hit
+		int columnIndex = (int)(std::upper_bound(positions.begin(), positions.end(), local.x - mTextStart) - positions.begin()) - 1;
+		if (columnIndex < 0)
 		{
-			float columnWidth = 0.0f;
-
-			if (line[columnIndex].mChar == '\t')
-			{
-				float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ").x;
-				float oldX = columnX;
-				float newColumnX = (1.0f + std::floor((1.0f + columnX) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-				columnWidth = newColumnX - oldX;
-				if (mTextStart + columnX + columnWidth * 0.5f > local.x)
-					break;
-				columnX = newColumnX;
-				columnCoord = (columnCoord / mTabSize) * mTabSize + mTabSize;
-				columnIndex++;
-			}
-			else
-			{
-				char buf[7];
-				auto d = UTF8CharLength(line[columnIndex].mChar);
-				int i = 0;
-				while (i < 6 && d-- > 0)
-					buf[i++] = line[columnIndex++].mChar;
-				buf[i] = '\0';
-				columnWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf).x;
-				if (mTextStart + columnX + columnWidth * 0.5f > local.x)
-					break;
-				columnX += columnWidth;
-				columnCoord++;
-			}
+			columnIndex = 0;
+		}
+		else if (columnIndex < (int)line.size())
+		{
+			while (columnIndex > 0 && (line[columnIndex].mChar & 0xC0) == 0x80)
+				--columnIndex;
+			int next = std::min((int)line.size(), columnIndex + UTF8CharLength(line[columnIndex].mChar));
+			float columnWidth = positions[next] - positions[columnIndex];
+			if (mTextStart + positions[columnIndex] + columnWidth * 0.5f <= local.x)
+				columnIndex = next;
 		}
+		columnCoord = GetCharacterColumn(lineNo, columnIndex);
 	}
 
 	return SanitizeCoordinates(Coordinates(lineNo, columnCoord));
@@ -534,7 +1435,7 @@ int TextEditor::GetLineCharacterCount(int aLine) const
 		return 0;
 	auto& line = mLines[aLine];
 	int c = 0;
-	for (unsigned i = 0; i < line.size(); c++)
+	for (int i = 0; i < line.size(); c++)
 		i += UTF8CharLength(line[i].mChar);
 	return c;
 }
@@ -545,7 +1446,7 @@ int TextEditor::GetLineMaxColumn(int aLine) const
 		return 0;
 	auto& line = mLines[aLine];
 	int col = 0;
-	for (unsigned i = 0; i < line.size(); )
+	for (int i = 0; i < line.size(); )
 	{
 		auto c = line[i].mChar;
 		if (c == '\t')
@@ -577,7 +1478,7 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
 {
 	assert(!mReadOnly);
 	assert(aEnd >= aStart);
-	assert(mLines.size() > (size_t)(aEnd - aStart));
+	assert(mLines.size() > aEnd - aStart);
 
 	ErrorMarkers etmp;
 	for (auto& i : mErrorMarkers)
@@ -598,8 +1499,14 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
 	}
 	mBreakpoints = std::move(btmp);
 
-	mLines.erase(mLines.begin() + aStart, mLines.begin() + aEnd);
+	mLines.Erase(aStart, aEnd);
 	assert(!mLines.empty());
+	ShiftColorizeJob(aStart, aStart - aEnd);
+	ShiftDiagnostics(aStart, aStart - aEnd);
+	ShiftBrackets(aStart);
+	ShiftMinimap(aStart, aStart - aEnd);
+	ShiftFolds(aStart, aStart - aEnd);
+	Colorize(aStart, 1);
 
 	mTextChanged = true;
 }
@@ -628,29 +1535,49 @@ void TextEditor::RemoveLine(int aIndex)
 	}
 	mBreakpoints = std::move(btmp);
 
-	mLines.erase(mLines.begin() + aIndex);
+	mLines.Erase(aIndex, aIndex + 1);
 	assert(!mLines.empty());
+	ShiftColorizeJob(aIndex, -1);
+	ShiftDiagnostics(aIndex, -1);
+	ShiftBrackets(aIndex);
+	ShiftMinimap(aIndex, -1);
+	ShiftFolds(aIndex, -1);
+	Colorize(aIndex, 1);
 
 	mTextChanged = true;
 }
 
 TextEditor::Line& TextEditor::InsertLine(int aIndex)
+{
+	InsertLines(aIndex, "", "");
+	return mLines[aIndex];
+}
+
+// A line per '\n' in the text and one more, returns how many that is
+int TextEditor::InsertLines(int aIndex, const char* aText, const char* aTextEnd)
 {
 	assert(!mReadOnly);
 
-	auto& result = *mLines.insert(mLines.begin() + aIndex, Line());
+	const int before = mLines.size();
+	mLines.Insert(aIndex, aText, aTextEnd);
+	const int count = mLines.size() - before;
+	ShiftColorizeJob(aIndex, count);
+	ShiftDiagnostics(aIndex, count);
+	ShiftBrackets(aIndex);
+	ShiftMinimap(aIndex, count);
+	ShiftFolds(aIndex, count);
+	Colorize(aIndex, count);
 
 	ErrorMarkers etmp;
 	for (auto& i : mErrorMarkers)
-		etmp.insert(ErrorMarkers::value_type(i.first >= aIndex ? i.first + 1 : i.first, i.second));
+		etmp.insert(ErrorMarkers::value_type(i.first >= aIndex ? i.first + count : i.first, i.second));
 	mErrorMarkers = std::move(etmp);
 
 	Breakpoints btmp;
 	for (auto i : mBreakpoints)
-		btmp.insert(i >= aIndex ? i + 1 : i);
+		btmp.insert(i >= aIndex ? i + count : i);
 	mBreakpoints = std::move(btmp);
-
-	return result;
+	return count;
 }
 
 std::string TextEditor::GetWordUnderCursor() const
@@ -715,7 +1642,18 @@ void TextEditor::HandleKeyboardInputs()
 		ErrorMarkers markers;
 		SetErrorMarkers(markers);
 
-		if (!IsReadOnly() && ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Z)))
+		// The completion popup takes the arrows, Tab, Enter and Escape while it is open
+		const bool completing = IsCompleting();
+		const int completionCount = (int)mCompletions.size();
+		if (completing && !ctrl && !alt && !shift && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_UpArrow)))
+			mCompletionIndex = (mCompletionIndex + completionCount - 1) % completionCount;
+		else if (completing && !ctrl && !alt && !shift && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow)))
+			mCompletionIndex = (mCompletionIndex + 1) % completionCount;
+		else if (completing && !ctrl && !alt && !shift && (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Tab)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Enter))))
+			AcceptCompletion();
+		else if (completing && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Escape)))
+			mCompletions.clear();
+		else if (!IsReadOnly() && ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Z)))
 			Undo();
 		else if (!IsReadOnly() && !ctrl && !shift && alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Backspace)))
 			Undo();
@@ -744,7 +1682,11 @@ void TextEditor::HandleKeyboardInputs()
 		else if (!IsReadOnly() && !ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Delete)))
 			Delete();
 		else if (!IsReadOnly() && !ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Backspace)))
+		{
 			Backspace();
+			if (completing)
+				UpdateCompletions();
+		}
 		//else if (!ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Insert)))
 			//mOverwrite ^= true;
 		//else if (ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Insert)))
@@ -761,6 +1703,13 @@ void TextEditor::HandleKeyboardInputs()
 			Cut();
 		else if (ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_A)))
 			SelectAll();
+		else if (ctrl && !alt && ImGui::IsKeyPressed(0xDD))  // Ctrl+], the key is VK_OEM_6 (US layout) with the Win32 backend
+			MoveToMatchingBracket(shift);
+		else if (ctrl && shift && !alt && ImGui::IsKeyPressed(0xDB))  // Ctrl+Shift+[, VK_OEM_4
+		{
+			if (!Unfold(mState.mCursorPosition.mLine))
+				Fold(mState.mCursorPosition.mLine);
+		}
 		else if (!IsReadOnly() && !ctrl && !shift && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Enter)))
 			EnterCharacter('\n', false);
 		else if (!IsReadOnly() && !ctrl && !alt && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Tab)))
@@ -775,6 +1724,7 @@ void TextEditor::HandleKeyboardInputs()
 					EnterCharacter(c, shift);
 			}
 			io.InputQueueCharacters.resize(0);
+			UpdateCompletions();
 		}
 	}
 }
@@ -855,6 +1805,85 @@ void TextEditor::HandleMouseInputs()
 	}
 }
 
+void TextEditor::RenderLineGlyphs(ImDrawList* aDrawList, const Line& aLine, const ImVec2& aTextScreenPos, float aSpaceSize, bool aClip)
+{
+	auto font = ImGui::GetFont();
+	const auto fontSize = ImGui::GetFontSize();
+	const ImVec4 noClip(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX);
+	auto drawBuffer = [&](const ImVec2& aPos, ImU32 aColor) {
+		if (aClip)
+			aDrawList->AddText(aPos, aColor, mLineBuffer.c_str());
+		else
+			font->RenderText(aDrawList, fontSize, aPos, aColor, noClip, mLineBuffer.c_str(), mLineBuffer.c_str() + mLineBuffer.size());
+	};
+
+	auto prevColor = aLine.empty() ? mPalette[(int)PaletteIndex::Default] : GetGlyphColor(aLine[0]);
+	ImVec2 bufferOffset;
+
+	for (int i = 0; i < (int)aLine.size();)
+	{
+		auto glyph = aLine[i];
+		auto color = GetGlyphColor(glyph);
+
+		if ((color != prevColor || glyph.mChar == '\t' || glyph.mChar == ' ') && !mLineBuffer.empty())
+		{
+			const ImVec2 newOffset(aTextScreenPos.x + bufferOffset.x, aTextScreenPos.y + bufferOffset.y);
+			drawBuffer(newOffset, prevColor);
+			auto textSize = font->CalcTextSizeA(fontSize, FLT_MAX, -1.0f, mLineBuffer.c_str(), nullptr, nullptr);
+			bufferOffset.x += textSize.x;
+			mLineBuffer.clear();
+		}
+		prevColor = color;
+
+		if (glyph.mChar == '\t')
+		{
+			auto oldX = bufferOffset.x;
+			bufferOffset.x = (1.0f + std::floor((1.0f + bufferOffset.x) / (float(mTabSize) * aSpaceSize))) * (float(mTabSize) * aSpaceSize);
+			++i;
+
+			if (mShowWhitespaces)
+			{
+				const auto s = fontSize;
+				const auto x1 = aTextScreenPos.x + oldX + 1.0f;
+				const auto x2 = aTextScreenPos.x + bufferOffset.x - 1.0f;
+				const auto y = aTextScreenPos.y + bufferOffset.y + s * 0.5f;
+				const ImVec2 p1(x1, y);
+				const ImVec2 p2(x2, y);
+				const ImVec2 p3(x2 - s * 0.2f, y - s * 0.2f);
+				const ImVec2 p4(x2 - s * 0.2f, y + s * 0.2f);
+				aDrawList->AddLine(p1, p2, 0x90909090);
+				aDrawList->AddLine(p2, p3, 0x90909090);
+				aDrawList->AddLine(p2, p4, 0x90909090);
+			}
+		}
+		else if (glyph.mChar == ' ')
+		{
+			if (mShowWhitespaces)
+			{
+				const auto s = fontSize;
+				const auto x = aTextScreenPos.x + bufferOffset.x + aSpaceSize * 0.5f;
+				const auto y = aTextScreenPos.y + bufferOffset.y + s * 0.5f;
+				aDrawList->AddCircleFilled(ImVec2(x, y), 1.5f, 0x80808080, 4);
+			}
+			bufferOffset.x += aSpaceSize;
+			i++;
+		}
+		else
+		{
+			auto l = UTF8CharLength(glyph.mChar);
+			while (l-- > 0)
+				mLineBuffer.push_back(aLine[i++].mChar);
+		}
+	}
+
+	if (!mLineBuffer.empty())
+	{
+		const ImVec2 newOffset(aTextScreenPos.x + bufferOffset.x, aTextScreenPos.y + bufferOffset.y);
+		drawBuffer(newOffset, prevColor);
+		mLineBuffer.clear();
+	}
+}
+
 void TextEditor::Render()
 {
 	/* Compute mCharAdvance regarding to scaled font size (Ctrl + mouse wheel)*/
@@ -881,31 +1910,77 @@ void TextEditor::Render()
 		ImGui::SetScrollY(0.f);
 	}
 
+	// Clicked or dragged on the minimap, center that line
+	if (mMinimapScrollLine >= 0)
+	{
+		const int row = LineToRow(std::min(mMinimapScrollLine, (int)mLines.size() - 1));
+		ImGui::SetScrollY(std::max(0.0f, (row + 0.5f) * mCharAdvance.y - ImGui::GetWindowHeight() * 0.5f));
+		mMinimapScrollLine = -1;
+	}
+
 	ImVec2 cursorScreenPos = ImGui::GetCursorScreenPos();
 	auto scrollX = ImGui::GetScrollX();
 	auto scrollY = ImGui::GetScrollY();
 
-	auto lineNo = (int)floor(scrollY / mCharAdvance.y);
+	auto rowNo = (int)floor(scrollY / mCharAdvance.y);
 	auto globalLineMax = (int)mLines.size();
-	auto lineMax = std::max(0, std::min((int)mLines.size() - 1, lineNo + (int)floor((scrollY + contentSize.y) / mCharAdvance.y)));
+	auto rowMax = std::max(0, std::min(GetRowCount() - 1, rowNo + (int)floor((scrollY + contentSize.y) / mCharAdvance.y)));
+	mMinimapFirstLine = RowToLine(std::min(rowNo, rowMax));
+	mMinimapLastLine = RowToLine(rowMax);
 
 	// Deduce mTextStart by evaluating mLines size (global lineMax) plus two spaces as text width
 	char buf[16];
 	snprintf(buf, 16, " %d ", globalLineMax);
 	mTextStart = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x + mLeftMargin;
 
+	// The cached geometry depends on all of this, drop it when any of it changes
+	if (mRenderCacheFont != ImGui::GetFont() || mRenderCacheFontSize != ImGui::GetFontSize() || mRenderCacheTexture != drawList->_CmdHeader.TextureId ||
+		mRenderCacheTabSize != mTabSize || mRenderCacheWhitespaces != mShowWhitespaces || mRenderCachePalette != mPalette)
+	{
+		mRenderCache.clear();
+		mRenderCacheFont = ImGui::GetFont();
+		mRenderCacheFontSize = ImGui::GetFontSize();
+		mRenderCacheTexture = drawList->_CmdHeader.TextureId;
+		mRenderCacheTabSize = mTabSize;
+		mRenderCacheWhitespaces = mShowWhitespaces;
+		mRenderCachePalette = mPalette;
+	}
+
+	// Follow the visible range, keeping the entries of the rows still on screen
+	const int visibleRows = std::max(0, rowMax - rowNo + 1);
+	if (mRenderCacheFirst != rowNo || (int)mRenderCache.size() != visibleRows)
+	{
+		std::vector<RenderCacheLine> cache(visibleRows);
+		for (int i = 0; i < (int)mRenderCache.size(); ++i)
+		{
+			const int cachedRow = mRenderCacheFirst + i;
+			if (cachedRow >= rowNo && cachedRow <= rowMax)
+				cache[cachedRow - rowNo] = std::move(mRenderCache[i]);
+		}
+		mRenderCache = std::move(cache);
+		mRenderCacheFirst = rowNo;
+	}
+
+	UpdateBracketHighlights();
+
 	if (!mLines.empty())
 	{
 		float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
 
-		while (lineNo <= lineMax)
+		// Fold markers of foldable lines only show while the mouse is over the line numbers, those of folded lines always
+		const ImVec2 mousePos = ImGui::GetMousePos();
+		const bool gutterHovered = ImGui::IsWindowHovered() && mousePos.x >= cursorScreenPos.x && mousePos.x < cursorScreenPos.x + mTextStart;
+		int foldToggle = -1;
+
+		while (rowNo <= rowMax)
 		{
-			ImVec2 lineStartScreenPos = ImVec2(cursorScreenPos.x, cursorScreenPos.y + lineNo * mCharAdvance.y);
+			auto& cached = mRenderCache[rowNo - mRenderCacheFirst];
+			const int lineNo = RowToLine(rowNo);
+			ImVec2 lineStartScreenPos = ImVec2(cursorScreenPos.x, cursorScreenPos.y + rowNo * mCharAdvance.y);
 			ImVec2 textScreenPos = ImVec2(lineStartScreenPos.x + mTextStart, lineStartScreenPos.y);
 
 			auto& line = mLines[lineNo];
-			longest = std::max(mTextStart + TextDistanceToLineStart(Coordinates(lineNo, GetLineMaxColumn(lineNo))), longest);
-			auto columnNo = 0;
+			longest = std::max(mTextStart + GetGlyphPositions(lineNo).back(), longest);
 			Coordinates lineStartCoord(lineNo, 0);
 			Coordinates lineEndCoord(lineNo, GetLineMaxColumn(lineNo));
 
@@ -929,6 +2004,44 @@ void TextEditor::Render()
 				drawList->AddRectFilled(vstart, vend, mPalette[(int)PaletteIndex::Selection]);
 			}
 
+			// Highlight the find matches, only ever searched for on visible lines and again once the text or the pattern changed
+			if (!mFindPattern.IsEmpty())
+			{
+				if (cached.mFindTextVersion != mTextVersion || cached.mFindPatternVersion != mFindPatternVersion)
+				{
+					mFindLineText.assign((const char*)line.Chars(), line.size());
+
+					const char* text = mFindLineText.data();
+					const char* textEnd = text + mFindLineText.size();
+					const char* matchBegin;
+					const char* matchEnd;
+					cached.mFindMatches.clear();
+					for (const char* from = text; mFindPattern.Search(text, textEnd, from, matchBegin, matchEnd); from = matchEnd)
+						cached.mFindMatches.emplace_back((int)(matchBegin - text), (int)(matchEnd - text));
+					cached.mFindTextVersion = mTextVersion;
+					cached.mFindPatternVersion = mFindPatternVersion;
+				}
+
+				auto& positions = GetGlyphPositions(lineNo);
+				for (auto& match : cached.mFindMatches)
+				{
+					ImVec2 vstart(textScreenPos.x + positions[match.first], lineStartScreenPos.y);
+					ImVec2 vend(textScreenPos.x + positions[match.second], lineStartScreenPos.y + mCharAdvance.y);
+					drawList->AddRectFilled(vstart, vend, mPalette[(int)PaletteIndex::FindMatch]);
+				}
+			}
+
+			// Highlight the bracket or block keyword at the cursor and its match
+			for (auto& highlight : mBracketHighlights)
+			{
+				if (highlight.first != lineNo)
+					continue;
+				auto& positions = GetGlyphPositions(lineNo);
+				ImVec2 vstart(textScreenPos.x + positions[highlight.second.first], lineStartScreenPos.y);
+				ImVec2 vend(textScreenPos.x + positions[highlight.second.second], lineStartScreenPos.y + mCharAdvance.y);
+				drawList->AddRectFilled(vstart, vend, mPalette[(int)PaletteIndex::MatchingBracket]);
+			}
+
 			// Draw breakpoints
 			auto start = ImVec2(lineStartScreenPos.x + scrollX, lineStartScreenPos.y);
 
@@ -959,11 +2072,73 @@ void TextEditor::Render()
 				}
 			}
 
+			// Underline diagnostics with a zigzag. Ranges that stayed on this line through an edit may point past its end now.
+			auto diagnostic = std::lower_bound(mDiagnostics.begin(), mDiagnostics.end(), lineNo, [](const Diagnostic& a, int aLine) { return a.mLine < aLine; });
+			for (; diagnostic != mDiagnostics.end() && diagnostic->mLine == lineNo; ++diagnostic)
+			{
+				auto& positions = GetGlyphPositions(lineNo);
+				const int lineEnd = (int)positions.size() - 1;
+				const int startIndex = std::max(0, std::min(diagnostic->mStartIndex, lineEnd));
+				const int endIndex = std::max(startIndex, std::min(diagnostic->mEndIndex, lineEnd));
+				const float x0 = textScreenPos.x + positions[startIndex];
+				const float x1 = std::max(textScreenPos.x + positions[endIndex], x0 + mCharAdvance.x);
+				const float y = lineStartScreenPos.y + mCharAdvance.y - 2.0f;
+
+				for (float x = x0; x < x1; x += 2.0f)
+					drawList->PathLineTo(ImVec2(x, ((int)((x - x0) / 2.0f) & 1) ? y - 1.5f : y));
+				drawList->PathStroke(mPalette[(int)PaletteIndex::ErrorMarker] | IM_COL32_A_MASK, false, 1.0f);
+
+				if (ImGui::IsMouseHoveringRect(ImVec2(x0, lineStartScreenPos.y), ImVec2(x1, lineStartScreenPos.y + mCharAdvance.y)))
+				{
+					ImGui::BeginTooltip();
+					ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.2f, 0.2f, 1.0f));
+					ImGui::Text("Syntax error at line %d:", lineNo + 1);
+					ImGui::PopStyleColor();
+					ImGui::Separator();
+					ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.2f, 1.0f));
+					ImGui::Text("%s", diagnostic->mMessage.c_str());
+					ImGui::PopStyleColor();
+					ImGui::EndTooltip();
+				}
+			}
+
 			// Draw line number (right aligned)
 			snprintf(buf, 16, "%d  ", lineNo + 1);
 
-			auto lineNoWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x;
-			drawList->AddText(ImVec2(lineStartScreenPos.x + mTextStart - lineNoWidth, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], buf);
+			if (cached.mLineNumberWidth < 0.0f)
+				cached.mLineNumberWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x;
+			drawList->AddText(ImVec2(lineStartScreenPos.x + mTextStart - cached.mLineNumberWidth, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], buf);
+
+			// Fold marker in the gap after the line number, and a box standing in for the hidden lines
+			const bool folded = IsFolded(lineNo);
+			if (folded || gutterHovered)
+			{
+				if (!folded && cached.mFoldEndVersion != mBracketsVersion)
+				{
+					cached.mFoldEnd = GetFoldEnd(lineNo);
+					cached.mFoldEndVersion = mBracketsVersion;
+				}
+				if (folded || cached.mFoldEnd >= 0)
+				{
+					const float size = mCharAdvance.y * 0.25f;
+					const ImVec2 center(lineStartScreenPos.x + mTextStart - spaceSize * 1.5f, lineStartScreenPos.y + mCharAdvance.y * 0.5f);
+					if (folded)
+						drawList->AddTriangleFilled(ImVec2(center.x - size * 0.5f, center.y - size), ImVec2(center.x + size * 0.5f, center.y), ImVec2(center.x - size * 0.5f, center.y + size), mPalette[(int)PaletteIndex::LineNumber]);
+					else
+						drawList->AddTriangleFilled(ImVec2(center.x - size, center.y - size * 0.5f), ImVec2(center.x + size, center.y - size * 0.5f), ImVec2(center.x, center.y + size * 0.5f), mPalette[(int)PaletteIndex::LineNumber]);
+					if (ImGui::IsMouseClicked(0) && ImGui::IsWindowHovered() && ImGui::IsMouseHoveringRect(ImVec2(center.x - spaceSize, lineStartScreenPos.y), ImVec2(center.x + spaceSize, lineStartScreenPos.y + mCharAdvance.y)))
+						foldToggle = lineNo;
+				}
+			}
+			if (folded)
+			{
+				const ImVec2 boxStart(textScreenPos.x + GetGlyphPositions(lineNo).back() + spaceSize, lineStartScreenPos.y + 1.0f);
+				const ImVec2 boxEnd(boxStart.x + spaceSize * 4.0f, lineStartScreenPos.y + mCharAdvance.y - 1.0f);
+				drawList->AddRect(boxStart, boxEnd, mPalette[(int)PaletteIndex::LineNumber], 2.0f);
+				drawList->AddText(ImVec2(boxStart.x + spaceSize * 0.5f, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], "...");
+				if (ImGui::IsMouseClicked(0) && ImGui::IsWindowHovered() && ImGui::IsMouseHoveringRect(boxStart, boxEnd))
+					foldToggle = lineNo;
+			}
 
 			if (mState.mCursorPosition.mLine == lineNo)
 			{
@@ -1013,85 +2188,80 @@ void TextEditor::Render()
 				}
 			}
 
-			// Render colorized text
-			auto prevColor = line.empty() ? mPalette[(int)PaletteIndex::Default] : GetGlyphColor(line[0]);
-			ImVec2 bufferOffset;
-
-			for (int i = 0; i < line.size();)
+			// Render colorized text, replaying the geometry cached for the line when it's unchanged
+			const ImVec2 originFraction(textScreenPos.x - std::floor(textScreenPos.x), textScreenPos.y - std::floor(textScreenPos.y));
+			if (cached.mValid && cached.mOriginFraction.x == originFraction.x && cached.mOriginFraction.y == originFraction.y && IsSameLine(cached.mChars, cached.mAttributes, line.Chars(), line.Attributes(), line.size()))
 			{
-				auto& glyph = line[i];
-				auto color = GetGlyphColor(glyph);
-
-				if ((color != prevColor || glyph.mChar == '\t' || glyph.mChar == ' ') && !mLineBuffer.empty())
-				{
-					const ImVec2 newOffset(textScreenPos.x + bufferOffset.x, textScreenPos.y + bufferOffset.y);
-					drawList->AddText(newOffset, prevColor, mLineBuffer.c_str());
-					auto textSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, mLineBuffer.c_str(), nullptr, nullptr);
-					bufferOffset.x += textSize.x;
-					mLineBuffer.clear();
-				}
-				prevColor = color;
-
-				if (glyph.mChar == '\t')
+				const int vtxCount = (int)cached.mVertices.size();
+				const int idxCount = (int)cached.mIndices.size();
+				if (idxCount > 0)
 				{
-					auto oldX = bufferOffset.x;
-					bufferOffset.x = (1.0f + std::floor((1.0f + bufferOffset.x) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-					++i;
-
-					if (mShowWhitespaces)
+					drawList->PrimReserve(idxCount, vtxCount);
+					const unsigned int vtxBase = drawList->_VtxCurrentIdx;
+					ImDrawVert* vtx = drawList->_VtxWritePtr;
+					for (auto& v : cached.mVertices)
 					{
-						const auto s = ImGui::GetFontSize();
-						const auto x1 = textScreenPos.x + oldX + 1.0f;
-						const auto x2 = textScreenPos.x + bufferOffset.x - 1.0f;
-						const auto y = textScreenPos.y + bufferOffset.y + s * 0.5f;
-						const ImVec2 p1(x1, y);
-						const ImVec2 p2(x2, y);
-						const ImVec2 p3(x2 - s * 0.2f, y - s * 0.2f);
-						const ImVec2 p4(x2 - s * 0.2f, y + s * 0.2f);
-						drawList->AddLine(p1, p2, 0x90909090);
-						drawList->AddLine(p2, p3, 0x90909090);
-						drawList->AddLine(p2, p4, 0x90909090);
+						*vtx = v;
+						vtx->pos.x += textScreenPos.x;
+						vtx->pos.y += textScreenPos.y;
+						++vtx;
 					}
+					ImDrawIdx* idx = drawList->_IdxWritePtr;
+					for (auto i : cached.mIndices)
+						*idx++ = (ImDrawIdx)(vtxBase + i);
+					drawList->_VtxWritePtr = vtx;
+					drawList->_IdxWritePtr = idx;
+					drawList->_VtxCurrentIdx += vtxCount;
 				}
-				else if (glyph.mChar == ' ')
+			}
+			else if ((int)line.size() <= 2048)
+			{
+				// Built without clipping so the geometry stays valid when scrolling horizontally
+				const int vtxStart = drawList->VtxBuffer.Size;
+				const int idxStart = drawList->IdxBuffer.Size;
+				const unsigned int vtxBase = drawList->_VtxCurrentIdx;
+				const unsigned int vtxOffset = drawList->_CmdHeader.VtxOffset;
+				RenderLineGlyphs(drawList, line, textScreenPos, spaceSize, false);
+
+				// Geometry split over a new vertex offset can't be replayed as one block, it's built again next frame
+				cached.mValid = drawList->_CmdHeader.VtxOffset == vtxOffset;
+				if (cached.mValid)
 				{
-					if (mShowWhitespaces)
+					cached.mChars.assign(line.Chars(), line.Chars() + line.size());
+					cached.mAttributes.assign(line.Attributes(), line.Attributes() + line.size());
+					cached.mOriginFraction = originFraction;
+					cached.mVertices.assign(drawList->VtxBuffer.Data + vtxStart, drawList->VtxBuffer.Data + drawList->VtxBuffer.Size);
+					for (auto& v : cached.mVertices)
 					{
-						const auto s = ImGui::GetFontSize();
-						const auto x = textScreenPos.x + bufferOffset.x + spaceSize * 0.5f;
-						const auto y = textScreenPos.y + bufferOffset.y + s * 0.5f;
-						drawList->AddCircleFilled(ImVec2(x, y), 1.5f, 0x80808080, 4);
+						v.pos.x -= textScreenPos.x;
+						v.pos.y -= textScreenPos.y;
 					}
-					bufferOffset.x += spaceSize;
-					i++;
-				}
-				else
-				{
-					auto l = UTF8CharLength(glyph.mChar);
-					while (l-- > 0)
-						mLineBuffer.push_back(line[i++].mChar);
+					cached.mIndices.assign(drawList->IdxBuffer.Data + idxStart, drawList->IdxBuffer.Data + drawList->IdxBuffer.Size);
+					for (auto& i : cached.mIndices)
+						i = (ImDrawIdx)(i - vtxBase);
 				}
-				++columnNo;
 			}
-
-			if (!mLineBuffer.empty())
+			else
 			{
-				const ImVec2 newOffset(textScreenPos.x + bufferOffset.x, textScreenPos.y + bufferOffset.y);
-				drawList->AddText(newOffset, prevColor, mLineBuffer.c_str());
-				mLineBuffer.clear();
+				// Very long lines are drawn clipped to the visible part every frame
+				cached.mValid = false;
+				RenderLineGlyphs(drawList, line, textScreenPos, spaceSize, true);
 			}
 
-			++lineNo;
+			++rowNo;
 		}
 
+		if (foldToggle >= 0 && !Unfold(foldToggle))
+			Fold(foldToggle);
+
 		// Draw a tooltip on known identifiers/preprocessor symbols
 		if (ImGui::IsMousePosValid() && ImGui::IsWindowHovered())
 		{
 			auto id = GetWordAt(ScreenPosToCoordinates(ImGui::GetMousePos()));
 			if (!id.empty())
 			{
-				auto it = mLanguageDefinition.mIdentifiers.find(id);
-				if (it != mLanguageDefinition.mIdentifiers.end())
+				auto it = mLanguageDefinition->mIdentifiers.find(id);
+				if (it != mLanguageDefinition->mIdentifiers.end())
 				{
 					ImGui::BeginTooltip();
 					ImGui::TextUnformatted(it->second.mDeclaration.c_str());
@@ -1099,8 +2269,8 @@ void TextEditor::Render()
 				}
 				else
 				{
-					auto pi = mLanguageDefinition.mPreprocIdentifiers.find(id);
-					if (pi != mLanguageDefinition.mPreprocIdentifiers.end())
+					auto pi = mLanguageDefinition->mPreprocIdentifiers.find(id);
+					if (pi != mLanguageDefinition->mPreprocIdentifiers.end())
 					{
 						ImGui::BeginTooltip();
 						ImGui::TextUnformatted(pi->second.mDeclaration.c_str());
@@ -1112,7 +2282,10 @@ void TextEditor::Render()
 	}
 
 
-	ImGui::Dummy(ImVec2((longest + 2), mLines.size() * mCharAdvance.y));
+	ImGui::Dummy(ImVec2((longest + 2), GetRowCount() * mCharAdvance.y));
+
+	if (IsCompleting())
+		RenderCompletions(cursorScreenPos);
 
 	if (mScrollToCursor)
 	{
@@ -1124,14 +2297,25 @@ void TextEditor::Render()
 
 void TextEditor::Render(const char* aTitle, const ImVec2& aSize, bool aBorder)
 {
+	Resume();
 	mWithinRender = true;
 	mTextChanged = false;
 	mCursorPositionChanged = false;
 
+	// The minimap takes its width out of the size asked for, which like BeginChild's counts from the available space when not positive
+	const bool minimap = mShowMinimap && !mIgnoreImGuiChild && sTextureHandler.mCreate != nullptr;
+	ImVec2 size = aSize;
+	if (minimap)
+	{
+		if (size.x <= 0.0f)
+			size.x += ImGui::GetContentRegionAvail().x;
+		size.x = std::max(1.0f, size.x - MinimapWidth);
+	}
+
 	ImGui::PushStyleColor(ImGuiCol_ChildBg, ImGui::ColorConvertU32ToFloat4(mPalette[(int)PaletteIndex::Background]));
 	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0.0f, 0.0f));
 	if (!mIgnoreImGuiChild)
-		ImGui::BeginChild(aTitle, aSize, aBorder, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_HorizontalScrollbar);
+		ImGui::BeginChild(aTitle, size, aBorder, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_HorizontalScrollbar);
 
 	if (mHandleKeyboardInputs)
 	{
@@ -1143,6 +2327,7 @@ void TextEditor::Render(const char* aTitle, const ImVec2& aSize, bool aBorder)
 		HandleMouseInputs();
 
 	ColorizeInternal();
+	UpdateDiagnostics();
 	Render();
 
 	if (mHandleKeyboardInputs)
@@ -1151,6 +2336,13 @@ void TextEditor::Render(const char* aTitle, const ImVec2& aSize, bool aBorder)
 	if (!mIgnoreImGuiChild)
 		ImGui::EndChild();
 
+	if (minimap)
+	{
+		UpdateMinimap();
+		ImGui::SameLine();
+		RenderMinimap(ImVec2((float)MinimapWidth, ImGui::GetItemRectSize().y));
+	}
+
 	ImGui::PopStyleVar();
 	ImGui::PopStyleColor();
 
@@ -1159,58 +2351,84 @@ void TextEditor::Render(const char* aTitle, const ImVec2& aSize, bool aBorder)
 
 void TextEditor::SetText(const std::string& aText)
 {
-	mLines.clear();
-	mLines.emplace_back(Line());
-	for (auto chr : aText)
+	SetText(aText.data(), aText.size());
+}
+
+void TextEditor::SetText(const char* aText, size_t aLength)
+{
+	const char* text = aText;
+	const char* textEnd = text + aLength;
+
+	// ignore the carriage return character
+	std::string stripped;
+	if (aLength > 0 && memchr(text, '\r', aLength) != nullptr)
 	{
-		if (chr == '\r')
-		{
-			// ignore the carriage return character
-		}
-		else if (chr == '\n')
-			mLines.emplace_back(Line());
-		else
-		{
-			mLines.back().emplace_back(Glyph(chr, PaletteIndex::Default));
-		}
+		stripped.assign(text, textEnd);
+		stripped.erase(std::remove(stripped.begin(), stripped.end(), '\r'), stripped.end());
+		text = stripped.data();
+		textEnd = text + stripped.size();
 	}
 
+	DiscardSuspended();
+	mLines.Clear();
+	mLines.Insert(0, text, textEnd);
+	mBracketChunks.clear();
+	mFolds.clear();
+	UpdateFoldRanges();
+
 	mTextChanged = true;
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
+	mUndoText.clear();
 	mUndoIndex = 0;
+	mDiagnostics.clear();
+
+	if (mRecordChanges)
+	{
+		Change change;
+		change.mReset = true;
+		change.mText.assign(text, textEnd);
+		mChanges.clear();
+		mChanges.push_back(std::move(change));
+	}
 
 	Colorize();
 }
 
 void TextEditor::SetTextLines(const std::vector<std::string>& aLines)
 {
-	mLines.clear();
-
-	if (aLines.empty())
+	std::string text;
+	for (size_t i = 0; i < aLines.size(); ++i)
 	{
-		mLines.emplace_back(Line());
+		if (i > 0)
+			text += '\n';
+		text += aLines[i];
 	}
-	else
-	{
-		mLines.resize(aLines.size());
 
-		for (size_t i = 0; i < aLines.size(); ++i)
-		{
-			const std::string& aLine = aLines[i];
-
-			mLines[i].reserve(aLine.size());
-			for (size_t j = 0; j < aLine.size(); ++j)
-				mLines[i].emplace_back(Glyph(aLine[j], PaletteIndex::Default));
-		}
-	}
+	DiscardSuspended();
+	mLines.Clear();
+	mLines.Insert(0, text.data(), text.data() + text.size());
+	mBracketChunks.clear();
+	mFolds.clear();
+	UpdateFoldRanges();
 
 	mTextChanged = true;
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
+	mUndoText.clear();
 	mUndoIndex = 0;
+	mDiagnostics.clear();
+
+	if (mRecordChanges)
+	{
+		Change change;
+		change.mReset = true;
+		change.mText = GetText();
+		mChanges.clear();
+		mChanges.push_back(std::move(change));
+	}
 
 	Colorize();
 }
@@ -1258,16 +2476,16 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				{
 					if (!line.empty())
 					{
-						if (line.front().mChar == '\t')
+						if (line[0].mChar == '\t')
 						{
-							line.erase(line.begin());
+							line.Erase(0, 1);
 							modified = true;
 						}
 						else
 						{
-							for (int j = 0; j < mTabSize && !line.empty() && line.front().mChar == ' '; j++)
+							for (int j = 0; j < mTabSize && !line.empty() && line[0].mChar == ' '; j++)
 							{
-								line.erase(line.begin());
+								line.Erase(0, 1);
 								modified = true;
 							}
 						}
@@ -1275,13 +2493,14 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				}
 				else
 				{
-					line.insert(line.begin(), Glyph('\t', TextEditor::PaletteIndex::Background));
+					line.Insert(0, Glyph('\t', TextEditor::PaletteIndex::Background));
 					modified = true;
 				}
 			}
 
 			if (modified)
 			{
+				Colorize(start.mLine, end.mLine - start.mLine + 1);
 				start = Coordinates(start.mLine, GetCharacterColumn(start.mLine, 0));
 				Coordinates rangeEnd;
 				if (originalEnd.mColumn != 0)
@@ -1299,10 +2518,10 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 
 				u.mAddedStart = start;
 				u.mAddedEnd = rangeEnd;
-				u.mAfter = mState;
 
 				mState.mSelectionStart = start;
 				mState.mSelectionEnd = end;
+				u.mAfter = mState;
 				AddUndo(u);
 
 				mTextChanged = true;
@@ -1332,16 +2551,22 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 		auto& line = mLines[coord.mLine];
 		auto& newLine = mLines[coord.mLine + 1];
 
-		if (mLanguageDefinition.mAutoIndentation)
-			for (size_t it = 0; it < line.size() && isascii(line[it].mChar) && isblank(line[it].mChar); ++it)
-				newLine.push_back(line[it]);
+		// The copied indentation is part of what was added
+		u.mAdded = (char)aChar;
+		if (mLanguageDefinition->mAutoIndentation)
+		{
+			int it = 0;
+			while (it < line.size() && isascii(line[it].mChar) && isblank(line[it].mChar))
+				++it;
+			newLine.Insert(0, line, 0, it);
+			u.mAdded.append((const char*)line.Chars(), it);
+		}
 
 		const size_t whitespaceSize = newLine.size();
 		auto cindex = GetCharacterIndex(coord);
-		newLine.insert(newLine.end(), line.begin() + cindex, line.end());
-		line.erase(line.begin() + cindex, line.begin() + line.size());
+		newLine.Insert(newLine.size(), line, cindex, line.size());
+		line.Erase(cindex, line.size());
 		SetCursorPosition(Coordinates(coord.mLine + 1, GetCharacterColumn(coord.mLine + 1, (int)whitespaceSize)));
-		u.mAdded = (char)aChar;
 	}
 	else
 	{
@@ -1363,12 +2588,12 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				while (d-- > 0 && cindex < (int)line.size())
 				{
 					u.mRemoved += line[cindex].mChar;
-					line.erase(line.begin() + cindex);
+					line.Erase(cindex, cindex + 1);
 				}
 			}
 
-			for (auto p = buf; *p != '\0'; p++, ++cindex)
-				line.insert(line.begin() + cindex, Glyph(*p, PaletteIndex::Default));
+			line.Insert(cindex, (const Char*)buf, e);
+			cindex += e;
 			u.mAdded = buf;
 
 			SetCursorPosition(Coordinates(coord.mLine, GetCharacterColumn(coord.mLine, cindex)));
@@ -1446,7 +2671,7 @@ void TextEditor::SetSelection(const Coordinates& aStart, const Coordinates& aEnd
 	case TextEditor::SelectionMode::Line:
 	{
 		const auto lineNo = mState.mSelectionEnd.mLine;
-		const auto lineSize = (size_t)lineNo < mLines.size() ? mLines[lineNo].size() : 0;
+		const auto lineSize = lineNo < mLines.size() ? mLines[lineNo].size() : 0;
 		mState.mSelectionStart = Coordinates(mState.mSelectionStart.mLine, 0);
 		mState.mSelectionEnd = Coordinates(lineNo, GetLineMaxColumn(lineNo));
 		break;
@@ -1503,7 +2728,7 @@ void TextEditor::DeleteSelection()
 void TextEditor::MoveUp(int aAmount, bool aSelect)
 {
 	auto oldPos = mState.mCursorPosition;
-	mState.mCursorPosition.mLine = std::max(0, mState.mCursorPosition.mLine - aAmount);
+	mState.mCursorPosition.mLine = RowToLine(std::max(0, LineToRow(mState.mCursorPosition.mLine) - aAmount));
 	if (oldPos != mState.mCursorPosition)
 	{
 		if (aSelect)
@@ -1530,7 +2755,7 @@ void TextEditor::MoveDown(int aAmount, bool aSelect)
 {
 	assert(mState.mCursorPosition.mColumn >= 0);
 	auto oldPos = mState.mCursorPosition;
-	mState.mCursorPosition.mLine = std::max(0, std::min((int)mLines.size() - 1, mState.mCursorPosition.mLine + aAmount));
+	mState.mCursorPosition.mLine = RowToLine(std::max(0, std::min(GetRowCount() - 1, LineToRow(mState.mCursorPosition.mLine) + aAmount)));
 
 	if (mState.mCursorPosition != oldPos)
 	{
@@ -1554,11 +2779,6 @@ void TextEditor::MoveDown(int aAmount, bool aSelect)
 	}
 }
 
-static bool IsUTFSequence(char c)
-{
-	return (c & 0xC0) == 0x80;
-}
-
 void TextEditor::MoveLeft(int aAmount, bool aSelect, bool aWordMode)
 {
 	if (mLines.empty())
@@ -1575,7 +2795,7 @@ void TextEditor::MoveLeft(int aAmount, bool aSelect, bool aWordMode)
 		{
 			if (line > 0)
 			{
-				--line;
+				line = std::max(0, RowToLine(LineToRow(line) - 1));
 				if ((int)mLines.size() > line)
 					cindex = (int)mLines[line].size();
 				else
@@ -1642,7 +2862,7 @@ void TextEditor::MoveRight(int aAmount, bool aSelect, bool aWordMode)
 		{
 			if (mState.mCursorPosition.mLine < mLines.size() - 1)
 			{
-				mState.mCursorPosition.mLine = std::max(0, std::min((int)mLines.size() - 1, mState.mCursorPosition.mLine + 1));
+				mState.mCursorPosition.mLine = std::max(0, std::min((int)mLines.size() - 1, RowToLine(LineToRow(mState.mCursorPosition.mLine) + 1)));
 				mState.mCursorPosition.mColumn = 0;
 			}
 			else
@@ -1782,8 +3002,9 @@ void TextEditor::Delete()
 		auto pos = GetActualCursorCoordinates();
 		SetCursorPosition(pos);
 		auto& line = mLines[pos.mLine];
+		auto cindex = GetCharacterIndex(pos);
 
-		if (pos.mColumn == GetLineMaxColumn(pos.mLine))
+		if (cindex >= (int)line.size())
 		{
 			if (pos.mLine == (int)mLines.size() - 1)
 				return;
@@ -1793,19 +3014,17 @@ void TextEditor::Delete()
 			Advance(u.mRemovedEnd);
 
 			auto& nextLine = mLines[pos.mLine + 1];
-			line.insert(line.end(), nextLine.begin(), nextLine.end());
+			line.Insert(line.size(), nextLine, 0, nextLine.size());
 			RemoveLine(pos.mLine + 1);
 		}
 		else
 		{
-			auto cindex = GetCharacterIndex(pos);
-			u.mRemovedStart = u.mRemovedEnd = GetActualCursorCoordinates();
-			u.mRemovedEnd.mColumn++;
-			u.mRemoved = GetText(u.mRemovedStart, u.mRemovedEnd);
+			auto d = std::min(UTF8CharLength(line[cindex].mChar), line.size() - cindex);
+			u.mRemovedStart = pos;
+			u.mRemovedEnd = Coordinates(pos.mLine, GetCharacterColumn(pos.mLine, cindex + d));
+			u.mRemoved.assign((const char*)line.Chars() + cindex, d);
 
-			auto d = UTF8CharLength(line[cindex].mChar);
-			while (d-- > 0 && cindex < (int)line.size())
-				line.erase(line.begin() + cindex);
+			line.Erase(cindex, cindex + d);
 		}
 
 		mTextChanged = true;
@@ -1852,7 +3071,7 @@ void TextEditor::Backspace()
 			auto& line = mLines[mState.mCursorPosition.mLine];
 			auto& prevLine = mLines[mState.mCursorPosition.mLine - 1];
 			auto prevSize = GetLineMaxColumn(mState.mCursorPosition.mLine - 1);
-			prevLine.insert(prevLine.end(), line.begin(), line.end());
+			prevLine.Insert(prevLine.size(), line, 0, line.size());
 
 			ErrorMarkers etmp;
 			for (auto& i : mErrorMarkers)
@@ -1874,14 +3093,15 @@ void TextEditor::Backspace()
 			//if (cindex > 0 && UTF8CharLength(line[cindex].mChar) > 1)
 			//	--cindex;
 
-			u.mRemovedStart = u.mRemovedEnd = GetActualCursorCoordinates();
-			--u.mRemovedStart.mColumn;
-			--mState.mCursorPosition.mColumn;
+			// A tab spans several columns, the start is wherever the removed character begins
+			u.mRemovedEnd = pos;
+			u.mRemovedStart = Coordinates(pos.mLine, GetCharacterColumn(pos.mLine, cindex));
+			mState.mCursorPosition.mColumn = u.mRemovedStart.mColumn;
 
 			while (cindex < line.size() && cend-- > cindex)
 			{
 				u.mRemoved += line[cindex].mChar;
-				line.erase(line.begin() + cindex);
+				line.Erase(cindex, cindex + 1);
 			}
 		}
 
@@ -1921,10 +3141,8 @@ void TextEditor::Copy()
 	{
 		if (!mLines.empty())
 		{
-			std::string str;
 			auto& line = mLines[GetActualCursorCoordinates().mLine];
-			for (auto& g : line)
-				str.push_back(g.mChar);
+			std::string str((const char*)line.Chars(), line.size());
 			ImGui::SetClipboardText(str.c_str());
 		}
 	}
@@ -1985,26 +3203,1940 @@ void TextEditor::Paste()
 	}
 }
 
-bool TextEditor::CanUndo() const
+static bool IsNameChar(TextEditor::Char aChar)
+{
+	return isalnum(aChar) || aChar == '_' || aChar == '.';
+}
+
+bool TextEditor::IsCompleting() const
+{
+	return !mCompletions.empty() && mState.mCursorPosition == mCompletionCursor && !HasSelection();
+}
+
+void TextEditor::UpdateCompletions()
+{
+	static const int MaxCompletions = 12;
+
+	mCompletions.clear();
+	if (mLanguageDefinition->mComplete == nullptr || HasSelection())
+		return;
+
+	// The dotted name left of the cursor, e.g. "net.Wri"
+	auto cursor = GetActualCursorCoordinates();
+	auto& line = mLines[cursor.mLine];
+	const int end = GetCharacterIndex(cursor);
+	int start = end;
+	while (start > 0 && IsNameChar(line[start - 1].mChar))
+		--start;
+	while (start < end && (isdigit(line[start].mChar) || line[start].mChar == '.'))
+		++start;
+
+	std::string prefix;
+	for (int i = start; i < end; ++i)
+		prefix += (char)line[i].mChar;
+	if (prefix.size() < 2 && prefix.find('.') == std::string::npos)
+		return;
+
+	// Not after a method call colon, and not in comments or strings
+	if (start > 0 && line[start - 1].mChar == ':')
+		return;
+	PaletteIndex color = PaletteIndex::Default;
+	if (mLanguageDefinition->mStatefulTokenize != nullptr)
+	{
+		// What was just typed isn't colored yet, lex the line up to the name from the state the previous one ended in
+		std::string text;
+		for (int i = 0; i <= start && i < end; ++i)
+			text += (char)line[i].mChar;
+		int state = cursor.mLine > 0 ? std::max(0, mLines[cursor.mLine - 1].mState) : 0;
+		for (const char* first = text.data(), *last = first + text.size(); first < last; )
+		{
+			const char* tokenBegin = nullptr;
+			const char* tokenEnd = nullptr;
+			if (!mLanguageDefinition->mStatefulTokenize(first, last, tokenBegin, tokenEnd, color, state))
+			{
+				color = PaletteIndex::Default;
+				++first;
+				continue;
+			}
+			if (tokenEnd == last)
+				break;
+			first = std::max(tokenEnd, first + 1);
+		}
+	}
+	else if (start > 0)
+	{
+		color = line[start - 1].mComment || line[start - 1].mMultiLineComment ? PaletteIndex::Comment : line[start - 1].mColorIndex;
+	}
+	if (color == PaletteIndex::Comment || color == PaletteIndex::MultiLineComment || color == PaletteIndex::String)
+		return;
+
+	Completion results[MaxCompletions];
+	int count = mLanguageDefinition->mComplete(prefix.data(), prefix.size(), results, MaxCompletions);
+	// Nothing left to complete
+	if (count == 1 && prefix == results[0].mText)
+		count = 0;
+
+	for (int i = 0; i < count; ++i)
+		mCompletions.emplace_back(results[i].mText, results[i].mDetail != nullptr ? results[i].mDetail : "");
+	mCompletionIndex = 0;
+	mCompletionStart = Coordinates(cursor.mLine, GetCharacterColumn(cursor.mLine, start));
+	mCompletionCursor = mState.mCursorPosition;
+}
+
+void TextEditor::AcceptCompletion()
+{
+	std::string text = std::move(mCompletions[mCompletionIndex].first);
+	mCompletions.clear();
+	if (mReadOnly)
+		return;
+
+	UndoRecord u;
+	u.mBefore = mState;
+
+	SetSelection(mCompletionStart, GetActualCursorCoordinates());
+	u.mRemovedStart = mState.mSelectionStart;
+	u.mRemovedEnd = mState.mSelectionEnd;
+	u.mRemoved = GetText(u.mRemovedStart, u.mRemovedEnd);
+	DeleteSelection();
+
+	u.mAdded = text;
+	u.mAddedStart = GetActualCursorCoordinates();
+	InsertText(text);
+	u.mAddedEnd = GetActualCursorCoordinates();
+	u.mAfter = mState;
+	AddUndo(u);
+}
+
+void TextEditor::RenderCompletions(const ImVec2& aOrigin)
+{
+	// Below the start of the name, on top of everything and without taking focus from the editor
+	ImGuiWindow* editorWindow = ImGui::GetCurrentWindow();
+	ImVec2 pos(aOrigin.x + mTextStart + TextDistanceToLineStart(mCompletionStart), aOrigin.y + (LineToRow(mCompletionStart.mLine) + 1) * mCharAdvance.y);
+	ImGui::SetNextWindowPos(pos);
+	ImGui::Begin("##completions", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+		ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+	ImGui::BringWindowToDisplayFront(ImGui::GetCurrentWindow());
+
+	int clicked = -1;
+	for (int i = 0; i < (int)mCompletions.size(); ++i)
+	{
+		ImGui::PushID(i);
+		if (ImGui::Selectable(mCompletions[i].first.c_str(), i == mCompletionIndex))
+			clicked = i;
+		ImGui::PopID();
+	}
+
+	auto& detail = mCompletions[mCompletionIndex].second;
+	if (!detail.empty())
+	{
+		ImGui::Separator();
+		ImGui::PushTextWrapPos(ImGui::GetFontSize() * 30.0f);
+		ImGui::TextDisabled("%s", detail.c_str());
+		ImGui::PopTextWrapPos();
+	}
+	ImGui::End();
+
+	if (clicked >= 0)
+	{
+		mCompletionIndex = clicked;
+		AcceptCompletion();
+		ImGui::FocusWindow(editorWindow);
+	}
+}
+
+bool TextEditor::CanUndo() const
+{
+	return !mReadOnly && mUndoIndex > 0;
+}
+
+bool TextEditor::CanRedo() const
+{
+	return !mReadOnly && mUndoIndex < (int)mUndoBuffer.size();
+}
+
+void TextEditor::Undo(int aSteps)
+{
+	while (CanUndo() && aSteps-- > 0)
+		mUndoBuffer[--mUndoIndex].Undo(this);
+}
+
+void TextEditor::Redo(int aSteps)
+{
+	while (CanRedo() && aSteps-- > 0)
+		mUndoBuffer[mUndoIndex++].Redo(this);
+}
+
+static inline char ToLowerAscii(char aChar)
+{
+	return aChar >= 'A' && aChar <= 'Z' ? (char)(aChar - 'A' + 'a') : aChar;
+}
+
+static inline bool IsWordByte(char aChar)
+{
+	return (aChar >= 'a' && aChar <= 'z') || (aChar >= 'A' && aChar <= 'Z') || (aChar >= '0' && aChar <= '9') || aChar == '_';
+}
+
+static inline int CountTrailingZeros(unsigned aValue)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, aValue);
+	return (int)index;
+#else
+	return __builtin_ctz(aValue);
+#endif
+}
+
+// Syntax tree of a regular expression, compiled to FindPattern::mProgram
+struct TextEditor::FindPattern::Node
+{
+	enum class Type { Empty, Char, Set, Any, LineStart, LineEnd, WordBoundary, NotWordBoundary, Concat, Alternate, Repeat };
+
+	Type mType = Type::Empty;
+	int mValue = 0;                         // the char or the index in mSets
+	int mMin = 0, mMax = 0;                 // repeat count, mMax is -1 when unbounded
+	bool mGreedy = true;
+	std::vector<Node> mChildren;
+};
+
+// Recursive descent parser of the usual syntax: | * + ? {n,m} and their lazy variants, (...) (?:...) [...] . ^ $ \b \B \d \w \s \D \W \S
+class TextEditor::FindPattern::Parser
+{
+public:
+	Parser(const std::string& aPattern, bool aCaseSensitive, std::vector<CharSet>& aSets)
+		: mCur(aPattern.c_str()), mEnd(aPattern.c_str() + aPattern.size()), mCaseSensitive(aCaseSensitive), mSets(aSets)
+	{}
+
+	bool Parse(Node& aRoot, std::string& aError)
+	{
+		ParseAlternation(aRoot, 0);
+		if (mError.empty() && mCur < mEnd)
+			mError = "Unmatched )";
+		aError = mError;
+		return mError.empty();
+	}
+
+private:
+	void ParseAlternation(Node& aNode, int aDepth)
+	{
+		if (aDepth > 100)
+		{
+			mError = "Too many nested groups";
+			return;
+		}
+
+		Node branch;
+		ParseConcat(branch, aDepth);
+		if (mCur == mEnd || *mCur != '|')
+		{
+			aNode = std::move(branch);
+			return;
+		}
+
+		aNode.mType = Node::Type::Alternate;
+		aNode.mChildren.push_back(std::move(branch));
+		while (mError.empty() && mCur < mEnd && *mCur == '|')
+		{
+			++mCur;
+			aNode.mChildren.emplace_back();
+			ParseConcat(aNode.mChildren.back(), aDepth);
+		}
+	}
+
+	void ParseConcat(Node& aNode, int aDepth)
+	{
+		aNode.mType = Node::Type::Concat;
+		while (mError.empty() && mCur < mEnd && *mCur != '|' && *mCur != ')')
+		{
+			aNode.mChildren.emplace_back();
+			ParseRepeat(aNode.mChildren.back(), aDepth);
+		}
+	}
+
+	void ParseRepeat(Node& aNode, int aDepth)
+	{
+		Node atom;
+		ParseAtom(atom, aDepth);
+		while (mError.empty() && mCur < mEnd)
+		{
+			int min, max;
+			if (*mCur == '*')
+				min = 0, max = -1;
+			else if (*mCur == '+')
+				min = 1, max = -1;
+			else if (*mCur == '?')
+				min = 0, max = 1;
+			else if (*mCur != '{' || !ParseCount(min, max))
+				break;
+			++mCur;
+
+			if (atom.mType == Node::Type::LineStart || atom.mType == Node::Type::LineEnd ||
+				atom.mType == Node::Type::WordBoundary || atom.mType == Node::Type::NotWordBoundary)
+			{
+				mError = "Nothing to repeat";
+				return;
+			}
+
+			Node repeat;
+			repeat.mType = Node::Type::Repeat;
+			repeat.mMin = min;
+			repeat.mMax = max;
+			if (mCur < mEnd && *mCur == '?')
+			{
+				repeat.mGreedy = false;
+				++mCur;
+			}
+			repeat.mChildren.push_back(std::move(atom));
+			atom = std::move(repeat);
+		}
+		aNode = std::move(atom);
+	}
+
+	// {n}, {n,} or {n,m}, leaves mCur on the closing brace. Anything else is taken literally.
+	bool ParseCount(int& aMin, int& aMax)
+	{
+		const char* p = mCur + 1;
+		auto number = [&](int& aValue) {
+			const char* start = p;
+			aValue = 0;
+			while (p < mEnd && *p >= '0' && *p <= '9' && aValue <= 100000)
+				aValue = aValue * 10 + (*p++ - '0');
+			return p > start;
+		};
+
+		if (!number(aMin))
+			return false;
+		aMax = aMin;
+		if (p < mEnd && *p == ',')
+		{
+			++p;
+			if (!number(aMax))
+				aMax = -1;
+		}
+		if (p == mEnd || *p != '}')
+			return false;
+
+		if (aMin > 1000 || aMax > 1000 || (aMax != -1 && aMax < aMin))
+			mError = "Invalid repeat count";
+		mCur = p;
+		return true;
+	}
+
+	void ParseAtom(Node& aNode, int aDepth)
+	{
+		if (mCur == mEnd)
+		{
+			mError = "Unexpected end of pattern";
+			return;
+		}
+
+		const char c = *mCur++;
+		switch (c)
+		{
+		case '(':
+			if (mEnd - mCur >= 2 && mCur[0] == '?' && mCur[1] == ':')
+				mCur += 2;
+			ParseAlternation(aNode, aDepth + 1);
+			if (mError.empty() && (mCur == mEnd || *mCur != ')'))
+				mError = "Missing )";
+			if (mError.empty())
+				++mCur;
+			break;
+		case '*': case '+': case '?':
+			mError = "Nothing to repeat";
+			break;
+		case '.':
+			aNode.mType = Node::Type::Any;
+			break;
+		case '^':
+			aNode.mType = Node::Type::LineStart;
+			break;
+		case '$':
+			aNode.mType = Node::Type::LineEnd;
+			break;
+		case '[':
+			ParseSet(aNode);
+			break;
+		case '\\':
+			ParseEscape(aNode);
+			break;
+		default:
+			SetChar(aNode, c);
+			break;
+		}
+	}
+
+	void ParseEscape(Node& aNode)
+	{
+		if (mCur == mEnd)
+		{
+			mError = "Trailing \\";
+			return;
+		}
+
+		const char c = *mCur++;
+		CharSet set = {};
+		if (c == 'b')
+			aNode.mType = Node::Type::WordBoundary;
+		else if (c == 'B')
+			aNode.mType = Node::Type::NotWordBoundary;
+		else if (AddClass(set, c))
+			SetSet(aNode, set);
+		else
+			SetChar(aNode, EscapedChar(c));
+	}
+
+	void ParseSet(Node& aNode)
+	{
+		CharSet set = {};
+		bool negate = false;
+		if (mCur < mEnd && *mCur == '^')
+		{
+			negate = true;
+			++mCur;
+		}
+
+		// A ] right after the opening bracket is literal
+		bool first = true;
+		while (mCur < mEnd && (*mCur != ']' || first))
+		{
+			first = false;
+			char from = *mCur++;
+			if (from == '\\' && mCur < mEnd)
+			{
+				const char c = *mCur++;
+				if (AddClass(set, c))
+					continue;
+				from = EscapedChar(c);
+			}
+
+			char to = from;
+			if (mEnd - mCur >= 2 && mCur[0] == '-' && mCur[1] != ']')
+			{
+				++mCur;
+				to = *mCur++;
+				if (to == '\\' && mCur < mEnd)
+					to = EscapedChar(*mCur++);
+				if ((unsigned char)to < (unsigned char)from)
+				{
+					mError = "Invalid range in []";
+					return;
+				}
+			}
+			for (int i = (unsigned char)from; i <= (unsigned char)to; ++i)
+				AddChar(set, (char)i);
+		}
+
+		if (mCur == mEnd)
+		{
+			mError = "Missing ]";
+			return;
+		}
+		++mCur;
+
+		if (negate)
+		{
+			for (auto& word : set)
+				word = ~word;
+		}
+		SetSet(aNode, set);
+	}
+
+	static char EscapedChar(char aChar)
+	{
+		switch (aChar)
+		{
+		case 't': return '\t';
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 'f': return '\f';
+		case 'v': return '\v';
+		case '0': return '\0';
+		default: return aChar;
+		}
+	}
+
+	// \d \w \s and their complements
+	bool AddClass(CharSet& aSet, char aClass)
+	{
+		CharSet set = {};
+		switch (ToLowerAscii(aClass))
+		{
+		case 'd':
+			for (char c = '0'; c <= '9'; ++c)
+				Add(set, c);
+			break;
+		case 'w':
+			for (int c = 0; c < 128; ++c)
+				if (IsWordByte((char)c))
+					Add(set, (char)c);
+			break;
+		case 's':
+			for (char c : { ' ', '\t', '\r', '\n', '\f', '\v' })
+				Add(set, c);
+			break;
+		default:
+			return false;
+		}
+
+		const bool negate = aClass >= 'A' && aClass <= 'Z';
+		for (size_t i = 0; i < set.size(); ++i)
+			aSet[i] |= negate ? ~set[i] : set[i];
+		return true;
+	}
+
+	static void Add(CharSet& aSet, char aChar)
+	{
+		aSet[(unsigned char)aChar >> 5] |= 1u << ((unsigned char)aChar & 31);
+	}
+
+	void AddChar(CharSet& aSet, char aChar)
+	{
+		Add(aSet, aChar);
+		if (!mCaseSensitive)
+		{
+			const char lower = ToLowerAscii(aChar);
+			Add(aSet, lower);
+			if (lower >= 'a' && lower <= 'z')
+				Add(aSet, (char)(lower - 'a' + 'A'));
+		}
+	}
+
+	void SetChar(Node& aNode, char aChar)
+	{
+		const char lower = ToLowerAscii(aChar);
+		if (mCaseSensitive || lower < 'a' || lower > 'z')
+		{
+			aNode.mType = Node::Type::Char;
+			aNode.mValue = (unsigned char)aChar;
+			return;
+		}
+
+		CharSet set = {};
+		AddChar(set, aChar);
+		SetSet(aNode, set);
+	}
+
+	void SetSet(Node& aNode, const CharSet& aSet)
+	{
+		aNode.mType = Node::Type::Set;
+		aNode.mValue = (int)mSets.size();
+		mSets.push_back(aSet);
+	}
+
+	const char* mCur;
+	const char* mEnd;
+	bool mCaseSensitive;
+	std::vector<CharSet>& mSets;
+	std::string mError;
+};
+
+bool TextEditor::FindPattern::Compile(const std::string& aPattern, bool aRegex, bool aCaseSensitive, std::string& aError)
+{
+	*this = FindPattern();
+	mCaseSensitive = aCaseSensitive;
+	if (aPattern.empty())
+		return true;
+
+	if (!aRegex)
+	{
+		if (aPattern.find('\n') != std::string::npos)
+		{
+			aError = "The pattern can't span lines";
+			return false;
+		}
+		mLiteral = aPattern;
+		if (!aCaseSensitive)
+			std::transform(mLiteral.begin(), mLiteral.end(), mLiteral.begin(), ToLowerAscii);
+		return true;
+	}
+
+	Node root;
+	Parser parser(aPattern, aCaseSensitive, mSets);
+	if (!parser.Parse(root, aError) || !Emit(root))
+	{
+		if (aError.empty())
+			aError = "The pattern is too complex";
+		*this = FindPattern();
+		return false;
+	}
+	mProgram.push_back({ Op::Match, 0, 0 });
+
+	// The bytes a match can start with, to skip ahead while no match is in progress
+	mHasFirstBytes = true;
+	mFirstBytes = {};
+	std::vector<bool> visited(mProgram.size());
+	std::vector<int> stack(1, 0);
+	while (!stack.empty() && mHasFirstBytes)
+	{
+		const int pc = stack.back();
+		stack.pop_back();
+		if (visited[pc])
+			continue;
+		visited[pc] = true;
+
+		const auto& inst = mProgram[pc];
+		switch (inst.mOp)
+		{
+		case Op::Char:
+			mFirstBytes[inst.mX >> 5] |= 1u << (inst.mX & 31);
+			break;
+		case Op::Set:
+			for (size_t i = 0; i < mFirstBytes.size(); ++i)
+				mFirstBytes[i] |= mSets[inst.mX][i];
+			break;
+		case Op::Split:
+			stack.push_back(inst.mY);
+			stack.push_back(inst.mX);
+			break;
+		case Op::Jump:
+			stack.push_back(inst.mX);
+			break;
+		default:
+			// Anything, or an assertion that depends on where the match starts
+			mHasFirstBytes = false;
+			break;
+		}
+	}
+
+	mMarks.assign(mProgram.size(), 0);
+	return true;
+}
+
+bool TextEditor::FindPattern::Emit(const Node& aNode)
+{
+	// Bounded repeats copy their operand, keep the program (and the per byte cost of the VM) reasonable
+	if (mProgram.size() > 20000)
+		return false;
+
+	auto emit = [this](Op aOp, int aX = 0, int aY = 0) {
+		mProgram.push_back({ aOp, aX, aY });
+		return (int)mProgram.size() - 1;
+	};
+
+	switch (aNode.mType)
+	{
+	case Node::Type::Empty:
+		break;
+	case Node::Type::Char:
+		emit(Op::Char, aNode.mValue);
+		break;
+	case Node::Type::Set:
+		emit(Op::Set, aNode.mValue);
+		break;
+	case Node::Type::Any:
+		emit(Op::Any);
+		break;
+	case Node::Type::LineStart:
+		emit(Op::LineStart);
+		break;
+	case Node::Type::LineEnd:
+		emit(Op::LineEnd);
+		break;
+	case Node::Type::WordBoundary:
+		emit(Op::WordBoundary);
+		break;
+	case Node::Type::NotWordBoundary:
+		emit(Op::NotWordBoundary);
+		break;
+	case Node::Type::Concat:
+		for (auto& child : aNode.mChildren)
+			if (!Emit(child))
+				return false;
+		break;
+	case Node::Type::Alternate:
+	{
+		std::vector<int> jumps;
+		for (size_t i = 0; i + 1 < aNode.mChildren.size(); ++i)
+		{
+			const int split = emit(Op::Split);
+			mProgram[split].mX = split + 1;
+			if (!Emit(aNode.mChildren[i]))
+				return false;
+			jumps.push_back(emit(Op::Jump));
+			mProgram[split].mY = (int)mProgram.size();
+		}
+		if (!Emit(aNode.mChildren.back()))
+			return false;
+		for (int jump : jumps)
+			mProgram[jump].mX = (int)mProgram.size();
+		break;
+	}
+	case Node::Type::Repeat:
+	{
+		auto& child = aNode.mChildren[0];
+		for (int i = 0; i < aNode.mMin; ++i)
+			if (!Emit(child))
+				return false;
+
+		// Split to the body (mX) or past it (mY), swapped when lazy
+		auto setTargets = [&](int aSplit, int aBody, int aExit) {
+			mProgram[aSplit].mX = aNode.mGreedy ? aBody : aExit;
+			mProgram[aSplit].mY = aNode.mGreedy ? aExit : aBody;
+		};
+
+		if (aNode.mMax == -1)
+		{
+			const int split = emit(Op::Split);
+			if (!Emit(child))
+				return false;
+			emit(Op::Jump, split);
+			setTargets(split, split + 1, (int)mProgram.size());
+		}
+		else
+		{
+			std::vector<int> splits;
+			for (int i = aNode.mMin; i < aNode.mMax; ++i)
+			{
+				splits.push_back(emit(Op::Split));
+				if (!Emit(child))
+					return false;
+			}
+			for (int split : splits)
+				setTargets(split, split + 1, (int)mProgram.size());
+		}
+		break;
+	}
+	}
+	return mProgram.size() <= 20000;
+}
+
+// Adds the thread at aPc and everything reachable from it without consuming a byte, in priority order
+void TextEditor::FindPattern::AddThread(std::vector<Thread>& aList, int aPc, const char* aStart, const char* aAt, const char* aBegin, const char* aLineEnd) const
+{
+	mStack.push_back(aPc);
+	while (!mStack.empty())
+	{
+		const int pc = mStack.back();
+		mStack.pop_back();
+		if (mMarks[pc] == mGeneration)
+			continue;
+		mMarks[pc] = mGeneration;
+
+		const auto& inst = mProgram[pc];
+		bool pass;
+		switch (inst.mOp)
+		{
+		case Op::Split:
+			mStack.push_back(inst.mY);
+			mStack.push_back(inst.mX);
+			continue;
+		case Op::Jump:
+			mStack.push_back(inst.mX);
+			continue;
+		case Op::LineStart:
+			pass = aAt == aBegin || aAt[-1] == '\n';
+			break;
+		case Op::LineEnd:
+			pass = aAt == aLineEnd;
+			break;
+		case Op::WordBoundary:
+		case Op::NotWordBoundary:
+			pass = ((aAt > aBegin && IsWordByte(aAt[-1])) != (aAt < aLineEnd && IsWordByte(*aAt))) == (inst.mOp == Op::WordBoundary);
+			break;
+		default:
+			aList.push_back({ pc, aStart });
+			continue;
+		}
+		if (pass)
+			mStack.push_back(pc + 1);
+	}
+}
+
+// Leftmost match within one line, preferring alternatives and repeats the way backtracking engines do
+bool TextEditor::FindPattern::SearchLine(const char* aBegin, const char* aLineEnd, const char* aFrom, const char*& aMatchBegin, const char*& aMatchEnd) const
+{
+	// Every list of threads uses a new generation to mark the ones already added, start over before it wraps
+	if (mGeneration > 0x7fffffffu - 2 * (unsigned)(aLineEnd - aFrom) - 4)
+	{
+		std::fill(mMarks.begin(), mMarks.end(), 0u);
+		mGeneration = 0;
+	}
+
+	bool matched = false;
+	mThreads.clear();
+	++mGeneration;
+	for (const char* at = aFrom; ; ++at)
+	{
+		if (!matched)
+		{
+			// Nothing in progress, skip to a byte a match can start with
+			if (mThreads.empty())
+			{
+				++mGeneration;
+				while (mHasFirstBytes && at < aLineEnd && (mFirstBytes[(unsigned char)*at >> 5] & (1u << ((unsigned char)*at & 31))) == 0)
+					++at;
+				if (mHasFirstBytes && at == aLineEnd)
+					break;
+			}
+			AddThread(mThreads, 0, at, at, aBegin, aLineEnd);
+		}
+		if (mThreads.empty())
+		{
+			if (matched || at == aLineEnd)
+				break;
+			continue;
+		}
+
+		mNextThreads.clear();
+		++mGeneration;
+		for (auto& thread : mThreads)
+		{
+			const auto& inst = mProgram[thread.mPc];
+			bool pass = false;
+			switch (inst.mOp)
+			{
+			case Op::Match:
+				// Lower priority threads are dropped, higher priority ones may still find a better match
+				if (thread.mStart < at)
+				{
+					matched = true;
+					aMatchBegin = thread.mStart;
+					aMatchEnd = at;
+				}
+				break;
+			case Op::Char:
+				pass = at < aLineEnd && (unsigned char)*at == inst.mX;
+				break;
+			case Op::Set:
+				pass = at < aLineEnd && (mSets[inst.mX][(unsigned char)*at >> 5] & (1u << ((unsigned char)*at & 31))) != 0;
+				break;
+			case Op::Any:
+				pass = at < aLineEnd;
+				break;
+			default:
+				break;
+			}
+			if (matched && inst.mOp == Op::Match && thread.mStart < at)
+				break;
+			if (pass)
+				AddThread(mNextThreads, thread.mPc + 1, thread.mStart, at + 1, aBegin, aLineEnd);
+		}
+		mThreads.swap(mNextThreads);
+		if (at == aLineEnd)
+			break;
+	}
+	return matched;
+}
+
+bool TextEditor::FindPattern::IsLiteralAt(const char* aAt) const
+{
+	if (mCaseSensitive)
+		return memcmp(aAt, mLiteral.data(), mLiteral.size()) == 0;
+	for (size_t i = 0; i < mLiteral.size(); ++i)
+		if (ToLowerAscii(aAt[i]) != mLiteral[i])
+			return false;
+	return true;
+}
+
+bool TextEditor::FindPattern::SearchLiteral(const char* aFrom, const char* aEnd, const char*& aMatchBegin, const char*& aMatchEnd) const
+{
+	const size_t length = mLiteral.size();
+	if ((size_t)(aEnd - aFrom) < length)
+		return false;
+
+	const char* last = aEnd - length;
+	const char* p = aFrom;
+#ifdef IMGUI_ENABLE_SSE
+	// Compare the first and the last byte of the literal at 16 positions at once, only candidates get compared in full.
+	// Or-ing 0x20 folds the case of letters, the few other bytes it confuses are filtered out by IsLiteralAt().
+	auto fold = [this](char aChar) { return (char)(!mCaseSensitive && aChar >= 'a' && aChar <= 'z' ? 0x20 : 0); };
+	const __m128i first = _mm_set1_epi8(mLiteral[0]);
+	const __m128i lastChar = _mm_set1_epi8(mLiteral[length - 1]);
+	const __m128i firstFold = _mm_set1_epi8(fold(mLiteral[0]));
+	const __m128i lastFold = _mm_set1_epi8(fold(mLiteral[length - 1]));
+	for (; last - p >= 15; p += 16)
+	{
+		const __m128i a = _mm_or_si128(_mm_loadu_si128((const __m128i*)p), firstFold);
+		const __m128i b = _mm_or_si128(_mm_loadu_si128((const __m128i*)(p + length - 1)), lastFold);
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, lastChar)));
+		for (; mask != 0; mask &= mask - 1)
+		{
+			const char* candidate = p + CountTrailingZeros(mask);
+			if (IsLiteralAt(candidate))
+			{
+				aMatchBegin = candidate;
+				aMatchEnd = candidate + length;
+				return true;
+			}
+		}
+	}
+#endif
+	for (; p <= last; ++p)
+	{
+		if (mCaseSensitive)
+		{
+			p = (const char*)memchr(p, mLiteral[0], (size_t)(last - p) + 1);
+			if (p == nullptr)
+				return false;
+		}
+		if (IsLiteralAt(p))
+		{
+			aMatchBegin = p;
+			aMatchEnd = p + length;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TextEditor::FindPattern::Search(const char* aBegin, const char* aEnd, const char* aFrom, const char*& aMatchBegin, const char*& aMatchEnd) const
+{
+	if (mProgram.empty())
+		return !mLiteral.empty() && SearchLiteral(aFrom, aEnd, aMatchBegin, aMatchEnd);
+
+	for (const char* lineBegin = aFrom; ; )
+	{
+		const char* lineEnd = (const char*)memchr(lineBegin, '\n', (size_t)(aEnd - lineBegin));
+		if (lineEnd == nullptr)
+			lineEnd = aEnd;
+		if (SearchLine(aBegin, lineEnd, lineBegin, aMatchBegin, aMatchEnd))
+			return true;
+		if (lineEnd == aEnd)
+			return false;
+		lineBegin = lineEnd + 1;
+	}
+}
+
+int TextEditor::FindPattern::Count(const char* aBegin, const char* aEnd, const std::atomic<bool>* aCancel) const
+{
+	int count = 0;
+	const char* matchBegin;
+	const char* matchEnd;
+	for (const char* chunk = aBegin; chunk < aEnd; )
+	{
+		if (aCancel != nullptr && aCancel->load())
+			return -1;
+
+		// Whole lines of about 64KB between checks for cancellation
+		const char* chunkEnd = chunk + std::min<size_t>((size_t)(aEnd - chunk), 64 * 1024);
+		chunkEnd = chunkEnd < aEnd ? (const char*)memchr(chunkEnd, '\n', (size_t)(aEnd - chunkEnd)) : aEnd;
+		if (chunkEnd == nullptr)
+			chunkEnd = aEnd;
+
+		for (const char* from = chunk; Search(aBegin, chunkEnd, from, matchBegin, matchEnd); from = matchEnd)
+			++count;
+		chunk = chunkEnd + 1;
+	}
+	return count;
+}
+
+bool TextEditor::SetFindPattern(const std::string& aPattern, bool aRegex, bool aCaseSensitive)
+{
+	++mFindPatternVersion;
+	mFindError.clear();
+	return mFindPattern.Compile(aPattern, aRegex, aCaseSensitive, mFindError);
+}
+
+const TextEditor::FindText& TextEditor::GetFindText()
+{
+	if (mFindText != nullptr && mFindTextVersion == mTextVersion)
+		return *mFindText;
+
+	// A new snapshot rather than an update in place, the counting thread may still be reading the old one
+	std::shared_ptr<FindText> find = std::make_shared<FindText>();
+	find->mText = GetText();
+
+	mFindText = std::move(find);
+	mFindTextVersion = mTextVersion;
+	return *mFindText;
+}
+
+TextEditor::Coordinates TextEditor::OffsetToCoordinates(int aOffset) const
+{
+	const int line = mLines.FindLine(aOffset);
+	return Coordinates(line, GetCharacterColumn(line, aOffset - (int)mLines.GetLineOffset(line)));
+}
+
+int TextEditor::CoordinatesToOffset(const Coordinates& aCoordinates) const
+{
+	return (int)mLines.GetLineOffset(aCoordinates.mLine) + GetCharacterIndex(aCoordinates);
+}
+
+bool TextEditor::FindNext(bool aBackwards)
+{
+	if (mFindPattern.IsEmpty())
+		return false;
+
+	auto& find = GetFindText();
+	const char* begin = find.mText.data();
+	const char* end = begin + find.mText.size();
+	const char* matchBegin = nullptr;
+	const char* matchEnd = nullptr;
+
+	if (!aBackwards)
+	{
+		// Start after the current match, wrap around at the end
+		const char* from = begin + CoordinatesToOffset(HasSelection() ? mState.mSelectionEnd : GetActualCursorCoordinates());
+		if (!mFindPattern.Search(begin, end, from, matchBegin, matchEnd) && !mFindPattern.Search(begin, end, begin, matchBegin, matchEnd))
+			return false;
+	}
+	else
+	{
+		// Matches never span lines, look for the last one before the current match line by line
+		const auto limit = HasSelection() ? mState.mSelectionStart : GetActualCursorCoordinates();
+		const char* limitAt = begin + CoordinatesToOffset(limit);
+		const int lineCount = mLines.size();
+		for (int n = 0; n <= lineCount && matchBegin == nullptr; ++n)
+		{
+			const int line = (limit.mLine - n + lineCount) % lineCount;
+			const char* lineBegin = begin + mLines.GetLineOffset(line);
+			const char* lineEnd = lineBegin + mLines[line].size();
+			const char* lineLimit = n == 0 ? limitAt : lineEnd;
+			const char* candidateBegin;
+			const char* candidateEnd;
+			for (const char* from = lineBegin; mFindPattern.Search(begin, lineEnd, from, candidateBegin, candidateEnd) && candidateEnd <= lineLimit; from = candidateEnd)
+			{
+				matchBegin = candidateBegin;
+				matchEnd = candidateEnd;
+			}
+		}
+		if (matchBegin == nullptr)
+			return false;
+	}
+
+	const auto start = OffsetToCoordinates((int)(matchBegin - begin));
+	const auto stop = OffsetToCoordinates((int)(matchEnd - begin));
+	SetSelection(start, stop);
+	SetCursorPosition(stop);
+	return true;
+}
+
+bool TextEditor::ReplaceNext(const std::string& aReplacement)
+{
+	if (mReadOnly || mFindPattern.IsEmpty())
+		return false;
+
+	// Replace the selection if it is a match (as left by FindNext()), then move on to the next one
+	if (HasSelection() && mState.mSelectionStart.mLine == mState.mSelectionEnd.mLine)
+	{
+		auto& find = GetFindText();
+		const char* begin = find.mText.data();
+		const int line = mState.mSelectionStart.mLine;
+		const char* lineEnd = begin + mLines.GetLineOffset(line) + mLines[line].size();
+		const char* selectionBegin = begin + CoordinatesToOffset(mState.mSelectionStart);
+		const char* selectionEnd = begin + CoordinatesToOffset(mState.mSelectionEnd);
+		const char* matchBegin;
+		const char* matchEnd;
+		if (mFindPattern.Search(begin, lineEnd, selectionBegin, matchBegin, matchEnd) && matchBegin == selectionBegin && matchEnd == selectionEnd)
+		{
+			UndoRecord u;
+			u.mBefore = mState;
+			u.mRemoved.assign(matchBegin, matchEnd);
+			u.mRemovedStart = mState.mSelectionStart;
+			u.mRemovedEnd = mState.mSelectionEnd;
+			DeleteSelection();
+
+			u.mAdded = aReplacement;
+			u.mAddedStart = GetActualCursorCoordinates();
+			InsertText(aReplacement);
+			u.mAddedEnd = GetActualCursorCoordinates();
+			u.mAfter = mState;
+			AddUndo(u);
+		}
+	}
+	return FindNext();
+}
+
+int TextEditor::ReplaceAll(const std::string& aReplacement)
+{
+	if (mReadOnly || mFindPattern.IsEmpty())
+		return 0;
+
+	// Everything from the first to the last match is replaced at once, as a single undo step
+	auto& find = GetFindText();
+	const char* begin = find.mText.data();
+	const char* end = begin + find.mText.size();
+	const char* first = nullptr;
+	const char* last = nullptr;
+	const char* matchBegin;
+	const char* matchEnd;
+	std::string replaced;
+	int count = 0;
+	for (const char* from = begin; mFindPattern.Search(begin, end, from, matchBegin, matchEnd); from = matchEnd, ++count)
+	{
+		if (first == nullptr)
+			first = matchBegin;
+		else
+			replaced.append(last, matchBegin);
+		replaced += aReplacement;
+		last = matchEnd;
+	}
+	if (count == 0)
+		return 0;
+
+	UndoRecord u;
+	u.mBefore = mState;
+	u.mRemoved.assign(first, last);
+	u.mRemovedStart = OffsetToCoordinates((int)(first - begin));
+	u.mRemovedEnd = OffsetToCoordinates((int)(last - begin));
+	DeleteRange(u.mRemovedStart, u.mRemovedEnd);
+
+	auto pos = u.mRemovedStart;
+	const int totalLines = InsertTextAt(pos, replaced.c_str());
+	u.mAdded = std::move(replaced);
+	u.mAddedStart = u.mRemovedStart;
+	u.mAddedEnd = pos;
+
+	SetSelection(pos, pos);
+	SetCursorPosition(pos);
+	Colorize(u.mAddedStart.mLine - 1, totalLines + 2);
+	u.mAfter = mState;
+	AddUndo(u);
+	return count;
+}
+
+void TextEditor::CancelFindCount()
+{
+	mFindCountCancel = true;
+	if (mFindCountThread.joinable())
+		mFindCountThread.join();
+	mFindCountCancel = false;
+}
+
+int TextEditor::GetFindMatchCount()
+{
+	if (mFindPattern.IsEmpty())
+		return 0;
+	if (mFindCountTextVersion == mTextVersion && mFindCountPatternVersion == mFindPatternVersion)
+		return mFindCount;
+
+	CancelFindCount();
+	mFindCountTextVersion = mTextVersion;
+	mFindCountPatternVersion = mFindPatternVersion;
+
+	auto& find = GetFindText();
+	const char* begin = find.mText.data();
+	if (find.mText.size() < 256 * 1024)
+	{
+		mFindCount = mFindPattern.Count(begin, begin + find.mText.size(), nullptr);
+		return mFindCount;
+	}
+
+	// Large texts are counted on a thread that works on its own copy of the pattern and keeps the snapshot alive
+	mFindCount = -1;
+	std::shared_ptr<const FindText> text = mFindText;
+	FindPattern pattern = mFindPattern;
+	mFindCountThread = std::thread([this, text, pattern] {
+		const int count = pattern.Count(text->mText.data(), text->mText.data() + text->mText.size(), &mFindCountCancel);
+		if (count >= 0)
+			mFindCount = count;
+	});
+	return -1;
+}
+
+// Picks up a finished check and starts the next one. A change is only checked once the text stayed the same for a moment,
+// and a check still running on older text is cancelled as soon as the change is noticed, so typing never queues stale work.
+void TextEditor::UpdateDiagnostics()
+{
+	const double delay = 0.3;
+
+	if (mDiagnoseBusy)
+	{
+		std::unique_ptr<DiagnoseJob> done;
+		{
+			std::lock_guard<std::mutex> lock(mDiagnoseMutex);
+			done = std::move(mDiagnoseDone);
+		}
+		if (done)
+		{
+			mDiagnoseBusy = false;
+			if (done->mComplete && done->mVersion == mTextVersion)
+				mDiagnostics = std::move(done->mDiagnostics);
+		}
+	}
+
+	if (mLanguageDefinition->mDiagnose == nullptr || mDiagnoseVersion == mTextVersion)
+		return;
+
+	const double now = ImGui::GetTime();
+	if (mDiagnoseSeenVersion != mTextVersion)
+	{
+		mDiagnoseSeenVersion = mTextVersion;
+		mDiagnoseChangeTime = now;
+		if (mDiagnoseBusy)
+			mDiagnoseCancel = true;
+		return;
+	}
+	if (mDiagnoseBusy || now - mDiagnoseChangeTime < delay)
+		return;
+
+	std::unique_ptr<DiagnoseJob> job(new DiagnoseJob());
+	job->mVersion = mTextVersion;
+	job->mLanguage = mLanguageDefinition;
+	GetFindText();
+	job->mText = mFindText;
+
+	mDiagnoseVersion = mTextVersion;
+	mDiagnoseBusy = true;
+	mDiagnoseCancel = false;
+
+	std::lock_guard<std::mutex> lock(mDiagnoseMutex);
+	mDiagnoseJob = std::move(job);
+	if (mDiagnoseThreadRunning)
+	{
+		mDiagnoseCondition.notify_one();
+	}
+	else
+	{
+		if (mDiagnoseThread.joinable())
+			mDiagnoseThread.join();
+		mDiagnoseThreadRunning = true;
+		mDiagnoseThread = std::thread(&TextEditor::DiagnoseThread, this);
+	}
+}
+
+// Keeps the diagnostics on their lines when aCount lines are inserted (or removed if negative) at aIndex, the ones on removed lines go
+void TextEditor::ShiftDiagnostics(int aIndex, int aCount)
+{
+	if (mDiagnostics.empty())
+		return;
+
+	auto removed = std::remove_if(mDiagnostics.begin(), mDiagnostics.end(), [aIndex, aCount](const Diagnostic& aDiagnostic) {
+		return aCount < 0 && aDiagnostic.mLine >= aIndex && aDiagnostic.mLine < aIndex - aCount;
+	});
+	mDiagnostics.erase(removed, mDiagnostics.end());
+	for (auto& diagnostic : mDiagnostics)
+	{
+		if (diagnostic.mLine >= aIndex)
+			diagnostic.mLine += aCount;
+	}
+}
+
+void TextEditor::DiagnoseThread()
+{
+	std::unique_lock<std::mutex> lock(mDiagnoseMutex);
+	for (;;)
+	{
+		// Exits when idle, like ColorizerThread()
+		if (!mDiagnoseCondition.wait_for(lock, std::chrono::seconds(1), [this] { return mDiagnoseStop || mDiagnoseJob != nullptr; }))
+			break;
+		if (mDiagnoseStop)
+			break;
+
+		std::unique_ptr<DiagnoseJob> job = std::move(mDiagnoseJob);
+		lock.unlock();
+		const std::string& text = job->mText->mText;
+		job->mComplete = job->mLanguage->mDiagnose(text.data(), text.data() + text.size(), job->mDiagnostics, mDiagnoseCancel);
+		job->mText.reset();
+		std::stable_sort(job->mDiagnostics.begin(), job->mDiagnostics.end(), [](const Diagnostic& a, const Diagnostic& b) { return a.mLine < b.mLine; });
+		lock.lock();
+		mDiagnoseDone = std::move(job);
+	}
+	mDiagnoseThreadRunning = false;
+}
+
+// Brackets and block keywords of aLine in text order. Only glyphs the colorizer left as punctuation or keywords count, which
+// leaves out strings and comments. Dropped along with the colors, see InvalidateBrackets().
+const std::vector<TextEditor::Bracket>& TextEditor::GetLineBrackets(int aLine) const
+{
+	auto& entry = mLines[aLine].mBrackets;
+	if (entry.mValid)
+		return entry.mBrackets;
+	entry.mValid = true;
+	entry.mBrackets.clear();
+
+	static const char brackets[] = "()[]{}";
+	auto& lang = *mLanguageDefinition;
+	auto& line = mLines[aLine];
+	std::string word;
+	for (int i = 0; i < (int)line.size(); )
+	{
+		auto glyph = line[i];
+		if (glyph.mComment || glyph.mMultiLineComment)
+		{
+			++i;
+			continue;
+		}
+
+		if (glyph.mColorIndex == PaletteIndex::Punctuation)
+		{
+			const char* at = glyph.mChar != 0 ? strchr(brackets, glyph.mChar) : nullptr;
+			if (at != nullptr)
+			{
+				const int n = (int)(at - brackets);
+				entry.mBrackets.push_back({ i, 1, (BracketKind)(n / 2), (int8_t)(n % 2 == 0 ? 1 : -1) });
+			}
+			++i;
+		}
+		else if (glyph.mColorIndex == PaletteIndex::Keyword)
+		{
+			int end = i + 1;
+			while (end < (int)line.size() && line[end].mColorIndex == PaletteIndex::Keyword)
+				++end;
+
+			word.clear();
+			for (int j = i; j < end; ++j)
+				word.push_back(line[j].mChar);
+			if (!lang.mCaseSensitive)
+				std::transform(word.begin(), word.end(), word.begin(), ::toupper);
+
+			int delta = 2;
+			if (lang.mBlockOpeners.count(word) != 0)
+				delta = 1;
+			else if (lang.mBlockClosers.count(word) != 0)
+				delta = -1;
+			else if (lang.mBlockHeads.count(word) != 0)
+				delta = 0;
+			if (delta != 2 && end - i <= 255)
+				entry.mBrackets.push_back({ i, (uint8_t)(end - i), BracketBlock, (int8_t)delta });
+			i = end;
+		}
+		else
+			++i;
+	}
+	return entry.mBrackets;
+}
+
+const TextEditor::BracketChunk& TextEditor::GetBracketChunk(int aChunk) const
+{
+	if (aChunk >= (int)mBracketChunks.size())
+		mBracketChunks.resize(aChunk + 1);
+	auto& chunk = mBracketChunks[aChunk];
+	if (chunk.mValid)
+		return chunk;
+	chunk.mValid = true;
+
+	const int begin = aChunk * BracketChunkLines;
+	const int end = std::min((int)mLines.size(), begin + BracketChunkLines);
+	int depth[BracketKindCount] = {};
+	for (int k = 0; k < BracketKindCount; ++k)
+		chunk.mMin[k] = chunk.mMax[k] = 0;
+
+	for (int i = begin; i < end; ++i)
+	{
+		for (auto& bracket : GetLineBrackets(i))
+		{
+			depth[bracket.mKind] += bracket.mDelta;
+			chunk.mMin[bracket.mKind] = std::min(chunk.mMin[bracket.mKind], depth[bracket.mKind]);
+		}
+	}
+	for (int k = 0; k < BracketKindCount; ++k)
+	{
+		chunk.mDelta[k] = depth[k];
+		depth[k] = 0;
+	}
+
+	for (int i = end - 1; i >= begin; --i)
+	{
+		auto& brackets = GetLineBrackets(i);
+		for (auto bracket = brackets.rbegin(); bracket != brackets.rend(); ++bracket)
+		{
+			depth[bracket->mKind] += bracket->mDelta;
+			chunk.mMax[bracket->mKind] = std::max(chunk.mMax[bracket->mKind], depth[bracket->mKind]);
+		}
+	}
+	return chunk;
+}
+
+// The colors of lines [aFromLine, aToLine) changed
+void TextEditor::InvalidateBrackets(int aFromLine, int aToLine)
+{
+	aFromLine = std::max(0, aFromLine);
+	aToLine = std::min(mLines.size(), aToLine);
+	if (aFromLine >= aToLine)
+		return;
+
+	for (int i = aFromLine; i < aToLine; ++i)
+		mLines[i].mBrackets.mValid = false;
+	const int lastChunk = std::min((int)mBracketChunks.size() - 1, (aToLine - 1) / BracketChunkLines);
+	for (int i = aFromLine / BracketChunkLines; i <= lastChunk; ++i)
+		mBracketChunks[i].mValid = false;
+	++mBracketsVersion;
+}
+
+// Lines were inserted or removed at aIndex. Chunks are fixed runs of lines, so every one from there on is dropped.
+void TextEditor::ShiftBrackets(int aIndex)
+{
+	for (int i = aIndex / BracketChunkLines; i < (int)mBracketChunks.size(); ++i)
+		mBracketChunks[i].mValid = false;
+	++mBracketsVersion;
+}
+
+// The bracket under the cursor, or else the one ending right before it
+TextEditor::BracketRef TextEditor::FindBracketAt(const Coordinates& aAt) const
+{
+	BracketRef result;
+	if (aAt.mLine < 0 || aAt.mLine >= (int)mLines.size())
+		return result;
+
+	const int index = GetCharacterIndex(aAt);
+	auto& brackets = GetLineBrackets(aAt.mLine);
+	for (int i = 0; i < (int)brackets.size() && brackets[i].mIndex <= index; ++i)
+	{
+		auto& bracket = brackets[i];
+		if (index < bracket.mIndex + bracket.mLength)
+		{
+			result.mLine = aAt.mLine;
+			result.mIndex = i;
+			return result;
+		}
+		if (index == bracket.mIndex + bracket.mLength)
+		{
+			result.mLine = aAt.mLine;
+			result.mIndex = i;
+		}
+	}
+	return result;
+}
+
+// Searches forward from an opener and backward from a closer, for the first bracket of the same kind that takes the
+// depth below the one at aBracket. Chunks that can't get that low are skipped by their summary.
+TextEditor::BracketRef TextEditor::FindMatchingBracket(const BracketRef& aBracket) const
+{
+	const Bracket bracket = GetLineBrackets(aBracket.mLine)[aBracket.mIndex];
+	const int kind = bracket.mKind;
+	const int step = bracket.mDelta;
+	const int lineCount = (int)mLines.size();
+	BracketRef result;
+	if (step == 0)
+		return result;
+
+	int depth = 0;
+	int line = aBracket.mLine;
+	int index = aBracket.mIndex + step;
+	for (;;)
+	{
+		auto& brackets = GetLineBrackets(line);
+		for (; index >= 0 && index < (int)brackets.size(); index += step)
+		{
+			if (brackets[index].mKind != kind)
+				continue;
+			depth += brackets[index].mDelta * step;
+			if (depth < 0)
+			{
+				result.mLine = line;
+				result.mIndex = index;
+				return result;
+			}
+		}
+
+		line += step;
+		while (line >= 0 && line < lineCount && line % BracketChunkLines == (step > 0 ? 0 : BracketChunkLines - 1))
+		{
+			auto& chunk = GetBracketChunk(line / BracketChunkLines);
+			if ((step > 0 ? depth + chunk.mMin[kind] : depth - chunk.mMax[kind]) < 0)
+				break;
+			depth += chunk.mDelta[kind] * step;
+			line += step * BracketChunkLines;
+		}
+		if (line < 0 || line >= lineCount)
+			return result;
+		index = step > 0 ? 0 : (int)GetLineBrackets(line).size() - 1;
+	}
+}
+
+// A head belongs to the first block opener after it with nothing open in between ("while f(function() end) do"). Heads are
+// only looked for a few brackets away.
+TextEditor::BracketRef TextEditor::FindBlockHead(const BracketRef& aOpener) const
+{
+	int depth[BracketKindCount] = {};
+	int line = aOpener.mLine;
+	int index = aOpener.mIndex - 1;
+	for (int left = 64; left > 0; --left, --index)
+	{
+		while (index < 0)
+		{
+			if (--line < 0)
+				return BracketRef();
+			index = (int)GetLineBrackets(line).size() - 1;
+		}
+
+		auto& bracket = GetLineBrackets(line)[index];
+		const bool outside = depth[BracketParen] == 0 && depth[BracketSquare] == 0 && depth[BracketCurly] == 0 && depth[BracketBlock] == 0;
+		if (bracket.mDelta == 0)
+		{
+			if (!outside)
+				continue;
+			BracketRef result;
+			result.mLine = line;
+			result.mIndex = index;
+			return result;
+		}
+
+		// Stop at anything enclosing the opener, or a whole block before it that would own the head
+		depth[bracket.mKind] -= bracket.mDelta;
+		if (depth[bracket.mKind] < 0)
+			break;
+		if (bracket.mKind == BracketBlock && bracket.mDelta > 0 && !outside &&
+			depth[BracketParen] == 0 && depth[BracketSquare] == 0 && depth[BracketCurly] == 0 && depth[BracketBlock] == 0)
+			break;
+	}
+	return BracketRef();
+}
+
+TextEditor::BracketRef TextEditor::FindBlockBody(const BracketRef& aHead) const
+{
+	int depth[BracketKindCount] = {};
+	int line = aHead.mLine;
+	int index = aHead.mIndex + 1;
+	const int lineCount = (int)mLines.size();
+	for (int left = 64; left > 0; --left, ++index)
+	{
+		while (index >= (int)GetLineBrackets(line).size())
+		{
+			if (++line >= lineCount)
+				return BracketRef();
+			index = 0;
+		}
+
+		auto& bracket = GetLineBrackets(line)[index];
+		const bool outside = depth[BracketParen] == 0 && depth[BracketSquare] == 0 && depth[BracketCurly] == 0;
+		if (outside && bracket.mKind == BracketBlock && bracket.mDelta >= 0)
+		{
+			if (bracket.mDelta == 0)
+				break;
+			BracketRef result;
+			result.mLine = line;
+			result.mIndex = index;
+			return result;
+		}
+
+		depth[bracket.mKind] += bracket.mDelta;
+		if (depth[bracket.mKind] < 0)
+			break;
+	}
+	return BracketRef();
+}
+
+void TextEditor::UpdateBracketHighlights()
+{
+	const Coordinates cursor = GetActualCursorCoordinates();
+	if (mBracketHighlightsVersion == mBracketsVersion && mBracketHighlightsCursor == cursor)
+		return;
+	mBracketHighlightsVersion = mBracketsVersion;
+	mBracketHighlightsCursor = cursor;
+	mBracketHighlights.clear();
+
+	const BracketRef at = FindBracketAt(cursor);
+	if (at.mLine < 0)
+		return;
+
+	BracketRef head, opener, closer;
+	const int delta = GetLineBrackets(at.mLine)[at.mIndex].mDelta;
+	if (delta == 0)
+	{
+		head = at;
+		opener = FindBlockBody(head);
+		if (opener.mLine >= 0)
+			closer = FindMatchingBracket(opener);
+	}
+	else if (delta > 0)
+	{
+		opener = at;
+		closer = FindMatchingBracket(opener);
+	}
+	else
+	{
+		closer = at;
+		opener = FindMatchingBracket(closer);
+	}
+	if (opener.mLine < 0 || closer.mLine < 0)
+		return;
+	if (head.mLine < 0 && GetLineBrackets(opener.mLine)[opener.mIndex].mKind == BracketBlock)
+		head = FindBlockHead(opener);
+
+	for (auto& ref : { head, opener, closer })
+	{
+		if (ref.mLine < 0)
+			continue;
+		auto& bracket = GetLineBrackets(ref.mLine)[ref.mIndex];
+		mBracketHighlights.emplace_back(ref.mLine, std::make_pair(bracket.mIndex, bracket.mIndex + bracket.mLength));
+	}
+}
+
+// From an opener or a head to the closer, from a closer to the head of the block or else its opener
+bool TextEditor::MoveToMatchingBracket(bool aSelect)
+{
+	const BracketRef at = FindBracketAt(GetActualCursorCoordinates());
+	if (at.mLine < 0)
+		return false;
+
+	const Bracket bracket = GetLineBrackets(at.mLine)[at.mIndex];
+	BracketRef target;
+	if (bracket.mDelta == 0)
+	{
+		const BracketRef opener = FindBlockBody(at);
+		if (opener.mLine >= 0)
+			target = FindMatchingBracket(opener);
+	}
+	else
+	{
+		target = FindMatchingBracket(at);
+		if (target.mLine >= 0 && bracket.mDelta < 0 && bracket.mKind == BracketBlock)
+		{
+			const BracketRef head = FindBlockHead(target);
+			if (head.mLine >= 0)
+				target = head;
+		}
+	}
+	if (target.mLine < 0)
+		return false;
+
+	auto oldPos = mState.mCursorPosition;
+	const Coordinates newPos(target.mLine, GetCharacterColumn(target.mLine, GetLineBrackets(target.mLine)[target.mIndex].mIndex));
+	SetCursorPosition(newPos);
+	if (aSelect)
+	{
+		if (oldPos == mInteractiveStart)
+			mInteractiveStart = newPos;
+		else if (oldPos == mInteractiveEnd)
+			mInteractiveEnd = newPos;
+		else
+		{
+			mInteractiveStart = oldPos;
+			mInteractiveEnd = newPos;
+		}
+		if (mInteractiveStart > mInteractiveEnd)
+			std::swap(mInteractiveStart, mInteractiveEnd);
+	}
+	else
+		mInteractiveStart = mInteractiveEnd = newPos;
+	SetSelection(mInteractiveStart, mInteractiveEnd);
+	return true;
+}
+
+// The closer line of the first block opened on aLine that spans three lines or more, -1 if there is none
+int TextEditor::GetFoldEnd(int aLine) const
+{
+	auto& brackets = GetLineBrackets(aLine);
+	for (int i = 0; i < (int)brackets.size(); ++i)
+	{
+		if (brackets[i].mDelta <= 0)
+			continue;
+		BracketRef opener;
+		opener.mLine = aLine;
+		opener.mIndex = i;
+		const BracketRef closer = FindMatchingBracket(opener);
+		if (closer.mLine > aLine + 1)
+			return closer.mLine;
+	}
+	return -1;
+}
+
+bool TextEditor::Fold(int aLine)
+{
+	if (aLine < 0 || aLine >= (int)mLines.size() || IsFolded(aLine))
+		return false;
+	const int end = GetFoldEnd(aLine);
+	if (end < 0)
+		return false;
+
+	auto at = std::lower_bound(mFolds.begin(), mFolds.end(), aLine, [](const FoldedBlock& a, int aStart) { return a.mStart < aStart; });
+	mFolds.insert(at, FoldedBlock{ aLine, end });
+	UpdateFoldRanges();
+
+	// The cursor can't stay on a hidden line, it would open the fold again
+	if (!IsLineVisible(mState.mCursorPosition.mLine))
+	{
+		const Coordinates pos(aLine, GetLineMaxColumn(aLine));
+		SetSelection(pos, pos);
+		SetCursorPosition(pos);
+	}
+	return true;
+}
+
+bool TextEditor::Unfold(int aLine)
+{
+	auto at = std::lower_bound(mFolds.begin(), mFolds.end(), aLine, [](const FoldedBlock& a, int aStart) { return a.mStart < aStart; });
+	if (at == mFolds.end() || at->mStart != aLine)
+		return false;
+	mFolds.erase(at);
+	UpdateFoldRanges();
+	return true;
+}
+
+void TextEditor::UnfoldAll()
+{
+	mFolds.clear();
+	UpdateFoldRanges();
+}
+
+bool TextEditor::IsFolded(int aLine) const
+{
+	auto at = std::lower_bound(mFolds.begin(), mFolds.end(), aLine, [](const FoldedBlock& a, int aStart) { return a.mStart < aStart; });
+	return at != mFolds.end() && at->mStart == aLine;
+}
+
+bool TextEditor::IsLineVisible(int aLine) const
+{
+	auto range = std::upper_bound(mFoldRanges.begin(), mFoldRanges.end(), aLine, [](int aLine, const FoldRange& a) { return aLine < a.mFrom; });
+	return range == mFoldRanges.begin() || aLine >= (range - 1)->mTo;
+}
+
+// Opens every fold hiding aLine
+void TextEditor::UnfoldAround(int aLine)
+{
+	if (IsLineVisible(aLine))
+		return;
+	mFolds.erase(std::remove_if(mFolds.begin(), mFolds.end(), [aLine](const FoldedBlock& a) { return a.mStart < aLine && aLine < a.mEnd; }), mFolds.end());
+	UpdateFoldRanges();
+}
+
+// aCount lines were inserted at aIndex, or removed there when negative. Lines inserted into a fold are hidden with it,
+// a fold goes away with its first line or once it has nothing left to hide.
+void TextEditor::ShiftFolds(int aIndex, int aCount)
+{
+	if (mFolds.empty())
+		return;
+
+	const int removedEnd = aIndex - aCount;
+	auto shift = [&](int aLine) {
+		if (aCount > 0)
+			return aLine >= aIndex ? aLine + aCount : aLine;
+		return aLine < aIndex ? aLine : aLine >= removedEnd ? aLine + aCount : aIndex;
+	};
+
+	std::vector<FoldedBlock> folds;
+	folds.reserve(mFolds.size());
+	for (auto& fold : mFolds)
+	{
+		if (aCount < 0 && fold.mStart >= aIndex && fold.mStart < removedEnd)
+			continue;
+		// Inserting right at the closer line puts the new lines inside the fold
+		const FoldedBlock shifted{ shift(fold.mStart), aCount > 0 && fold.mEnd == aIndex ? fold.mEnd + aCount : shift(fold.mEnd) };
+		if (shifted.mEnd - shifted.mStart >= 2)
+			folds.push_back(shifted);
+	}
+	mFolds = std::move(folds);
+	UpdateFoldRanges();
+}
+
+void TextEditor::UpdateFoldRanges()
+{
+	std::vector<FoldRange> previous;
+	previous.swap(mFoldRanges);
+	for (auto& fold : mFolds)
+	{
+		if (!mFoldRanges.empty() && fold.mStart + 1 <= mFoldRanges.back().mTo)
+			mFoldRanges.back().mTo = std::max(mFoldRanges.back().mTo, fold.mEnd);
+		else
+			mFoldRanges.push_back(FoldRange{ fold.mStart + 1, fold.mEnd, 0 });
+	}
+
+	mFoldHidden = 0;
+	for (auto& range : mFoldRanges)
+	{
+		range.mHiddenBefore = mFoldHidden;
+		mFoldHidden += range.mTo - range.mFrom;
+	}
+
+	// Cached rows now show other lines
+	if (mFoldRanges.size() != previous.size() || !std::equal(mFoldRanges.begin(), mFoldRanges.end(), previous.begin(),
+		[](const FoldRange& a, const FoldRange& b) { return a.mFrom == b.mFrom && a.mTo == b.mTo; }))
+		mRenderCache.clear();
+}
+
+int TextEditor::LineToRow(int aLine) const
+{
+	auto range = std::upper_bound(mFoldRanges.begin(), mFoldRanges.end(), aLine, [](int aLine, const FoldRange& a) { return aLine < a.mFrom; });
+	if (range == mFoldRanges.begin())
+		return aLine;
+	--range;
+	if (aLine < range->mTo)
+		return range->mFrom - 1 - range->mHiddenBefore;
+	return aLine - range->mHiddenBefore - (range->mTo - range->mFrom);
+}
+
+int TextEditor::RowToLine(int aRow) const
+{
+	auto range = std::upper_bound(mFoldRanges.begin(), mFoldRanges.end(), aRow, [](int aRow, const FoldRange& a) { return aRow < a.mFrom - a.mHiddenBefore; });
+	if (range == mFoldRanges.begin())
+		return aRow;
+	--range;
+	return aRow + range->mHiddenBefore + (range->mTo - range->mFrom);
+}
+
+void TextEditor::SetTextureHandler(const TextureHandler& aHandler)
+{
+	sTextureHandler = aHandler;
+}
+
+// The colors of lines [aFromLine, aToLine) changed, their groups get redrawn
+void TextEditor::InvalidateMinimap(int aFromLine, int aToLine)
+{
+	if (mMinimapLinesPerGroup == 0 || aFromLine >= aToLine)
+		return;
+
+	const int from = std::max(0, aFromLine / mMinimapLinesPerGroup);
+	const int to = std::min((int)mMinimapDirty.size(), (aToLine - 1) / mMinimapLinesPerGroup + 1);
+	for (int i = from; i < to; ++i)
+		mMinimapDirty[i] = 1;
+}
+
+// aCount lines were inserted at aIndex, or removed there when negative. With a group per line the rows below are moved
+// along instead of drawn again.
+void TextEditor::ShiftMinimap(int aIndex, int aCount)
+{
+	if (mMinimapLinesPerGroup == 0)
+		return;
+
+	const int lines = (int)mLines.size();
+	const int rowsPerGroup = lines * 2 <= MinimapHeight ? 2 : 1;
+	if (mMinimapLinesPerGroup > 1 || lines > MinimapHeight || rowsPerGroup != mMinimapRowsPerGroup)
+	{
+		// The layout changes when a group of lines no longer fits, UpdateMinimap() starts over then anyway
+		InvalidateMinimap(aIndex, std::max(lines, lines - aCount));
+		return;
+	}
+
+	const int groups = MinimapHeight / mMinimapRowsPerGroup;
+	const int from = std::min(groups, aIndex - std::min(aCount, 0));
+	const int to = std::min(groups, aIndex + std::max(aCount, 0));
+	const int count = std::max(0, groups - std::max(from, to));
+	const int rowSize = mMinimapRowsPerGroup * MinimapWidth;
+	memmove(mMinimapPixels.data() + to * rowSize, mMinimapPixels.data() + from * rowSize, count * rowSize * sizeof(ImU32));
+	memmove(mMinimapDirty.data() + to, mMinimapDirty.data() + from, count);
+	InvalidateMinimap(aIndex, aIndex + std::max(aCount, 0));
+
+	mMinimapUploadStart = std::min(mMinimapUploadStart, aIndex * mMinimapRowsPerGroup);
+	mMinimapUploadEnd = std::max(mMinimapUploadEnd, std::min(lines, groups) * mMinimapRowsPerGroup);
+}
+
+// Redraws the dirty groups, starting at the one shown on top of the text so what's in view comes first on large files,
+// and uploads the rows that changed
+void TextEditor::UpdateMinimap()
+{
+	if (mMinimapTexture == nullptr)
+	{
+		mMinimapTexture = sTextureHandler.mCreate(MinimapWidth, MinimapHeight);
+		if (mMinimapTexture == nullptr)
+			return;
+		mMinimapPixels.assign(MinimapWidth * MinimapHeight, 0);
+		mMinimapLinesPerGroup = 0;
+	}
+
+	// Two rows per line while the whole file fits, else a row for as many lines as it takes
+	const int lines = (int)mLines.size();
+	const int linesPerGroup = lines * 2 <= MinimapHeight ? 1 : (lines + MinimapHeight - 1) / MinimapHeight;
+	const int rowsPerGroup = lines * 2 <= MinimapHeight ? 2 : 1;
+	if (linesPerGroup != mMinimapLinesPerGroup || rowsPerGroup != mMinimapRowsPerGroup || mMinimapPatternVersion != mFindPatternVersion || mMinimapPalette != mPalette)
+	{
+		mMinimapLinesPerGroup = linesPerGroup;
+		mMinimapRowsPerGroup = rowsPerGroup;
+		mMinimapPatternVersion = mFindPatternVersion;
+		mMinimapPalette = mPalette;
+		mMinimapDirty.assign(MinimapHeight / rowsPerGroup, 1);
+	}
+	mMinimapGroups = (lines + linesPerGroup - 1) / linesPerGroup;
+
+	const int firstGroup = std::min(mMinimapGroups - 1, mMinimapFirstLine / linesPerGroup);
+	int budget = MinimapGlyphBudget;
+	for (int i = 0; i < mMinimapGroups && budget > 0; ++i)
+	{
+		const int group = (firstGroup + i) % mMinimapGroups;
+		if (!mMinimapDirty[group])
+			continue;
+		mMinimapDirty[group] = 0;
+		budget -= DrawMinimapGroup(group);
+		mMinimapUploadStart = std::min(mMinimapUploadStart, group * rowsPerGroup);
+		mMinimapUploadEnd = std::max(mMinimapUploadEnd, (group + 1) * rowsPerGroup);
+	}
+
+	if (mMinimapUploadEnd > MinimapHeight)
+		mMinimapUploadEnd = MinimapHeight;
+	if (mMinimapUploadStart < mMinimapUploadEnd)
+		sTextureHandler.mUpdate(mMinimapTexture, MinimapWidth, mMinimapPixels.data(), mMinimapUploadStart, mMinimapUploadEnd);
+	mMinimapUploadStart = MinimapHeight;
+	mMinimapUploadEnd = 0;
+}
+
+// A pixel per column in the color of the first glyph of the group's lines there, and the right edge marked when one of
+// them has a find match. Returns the number of glyphs looked at.
+int TextEditor::DrawMinimapGroup(int aGroup)
+{
+	ImU32* pixels = mMinimapPixels.data() + aGroup * mMinimapRowsPerGroup * MinimapWidth;
+	std::fill(pixels, pixels + mMinimapRowsPerGroup * MinimapWidth, 0);
+
+	const int first = aGroup * mMinimapLinesPerGroup;
+	const int last = std::min((int)mLines.size(), first + mMinimapLinesPerGroup);
+	int glyphs = 1;
+	bool found = false;
+	for (int i = first; i < last; ++i)
+	{
+		auto& line = mLines[i];
+		int column = 0;
+		for (int j = 0; j < (int)line.size() && column < MinimapColumns; ++j)
+		{
+			auto glyph = line[j];
+			if (glyph.mChar == '\t')
+				column = (column / mTabSize + 1) * mTabSize;
+			else if (!IsUTFSequence(glyph.mChar))
+			{
+				if (glyph.mChar != ' ' && pixels[column] == 0)
+					pixels[column] = (GetGlyphColor(glyph) & ~IM_COL32_A_MASK) | (0xb0 << IM_COL32_A_SHIFT);
+				++column;
+			}
+		}
+		glyphs += (int)line.size();
+
+		if (!found && !mFindPattern.IsEmpty())
+		{
+			mFindLineText.assign((const char*)line.Chars(), line.size());
+			const char* matchBegin;
+			const char* matchEnd;
+			const char* text = mFindLineText.data();
+			found = mFindPattern.Search(text, text + mFindLineText.size(), text, matchBegin, matchEnd);
+		}
+	}
+
+	if (found)
+	{
+		const ImU32 color = mPalette[(int)PaletteIndex::FindMatch] | IM_COL32_A_MASK;
+		for (int row = 0; row < mMinimapRowsPerGroup; ++row)
+			std::fill(pixels + row * MinimapWidth + MinimapColumns + 2, pixels + (row + 1) * MinimapWidth, color);
+	}
+	return glyphs;
+}
+
+void TextEditor::RenderMinimap(const ImVec2& aSize)
 {
-	return !mReadOnly && mUndoIndex > 0;
-}
+	ImGui::PushID(this);
+	const ImVec2 pos = ImGui::GetCursorScreenPos();
+	ImGui::InvisibleButton("##minimap", aSize);
+	const bool held = ImGui::IsItemActive();
+	ImGui::PopID();
 
-bool TextEditor::CanRedo() const
-{
-	return !mReadOnly && mUndoIndex < (int)mUndoBuffer.size();
-}
+	auto drawList = ImGui::GetWindowDrawList();
+	drawList->AddRectFilled(pos, ImVec2(pos.x + aSize.x, pos.y + aSize.y), mPalette[(int)PaletteIndex::Background]);
+	if (mMinimapTexture == nullptr || mMinimapGroups == 0)
+		return;
 
-void TextEditor::Undo(int aSteps)
-{
-	while (CanUndo() && aSteps-- > 0)
-		mUndoBuffer[--mUndoIndex].Undo(this);
+	// A texture row per pixel as long as they fit, squeezed when there are more
+	const int rows = mMinimapGroups * mMinimapRowsPerGroup;
+	const float height = std::min(aSize.y, (float)rows);
+	const float lineHeight = height * mMinimapRowsPerGroup / (rows * (float)mMinimapLinesPerGroup);
+	drawList->AddImage(mMinimapTexture, pos, ImVec2(pos.x + aSize.x, pos.y + height), ImVec2(0.0f, 0.0f), ImVec2(1.0f, rows / (float)MinimapHeight));
+
+	const float viewStart = pos.y + mMinimapFirstLine * lineHeight;
+	const float viewEnd = std::max(viewStart + 2.0f, pos.y + (mMinimapLastLine + 1) * lineHeight);
+	drawList->AddRectFilled(ImVec2(pos.x, viewStart), ImVec2(pos.x + aSize.x, viewEnd), mPalette[(int)PaletteIndex::CurrentLineFillInactive]);
+
+	// Errors change without the text changing, so they're drawn over the image instead of into it
+	const ImU32 errorColor = mPalette[(int)PaletteIndex::ErrorMarker] | IM_COL32_A_MASK;
+	const float markerX = pos.x + aSize.x * MinimapColumns / MinimapWidth;
+	auto drawError = [&](int aLine)
+	{
+		const float y = pos.y + aLine * lineHeight;
+		drawList->AddRectFilled(ImVec2(markerX, y), ImVec2(pos.x + aSize.x, y + std::max(2.0f, lineHeight)), errorColor);
+	};
+	for (auto& marker : mErrorMarkers)
+		drawError(marker.first - 1);
+	for (auto& diagnostic : mDiagnostics)
+		drawError(diagnostic.mLine);
+
+	if (held && ImGui::IsMousePosValid())
+		mMinimapScrollLine = std::max(0, std::min((int)mLines.size() - 1, (int)((ImGui::GetMousePos().y - pos.y) / lineHeight)));
 }
 
-void TextEditor::Redo(int aSteps)
+void TextEditor::ReleaseMinimap()
 {
-	while (CanRedo() && aSteps-- > 0)
-		mUndoBuffer[mUndoIndex++].Redo(this);
+	if (mMinimapTexture != nullptr && sTextureHandler.mDestroy != nullptr)
+		sTextureHandler.mDestroy(mMinimapTexture);
+	mMinimapTexture = nullptr;
+	std::vector<ImU32>().swap(mMinimapPixels);
+	std::vector<uint8_t>().swap(mMinimapDirty);
+	mMinimapLinesPerGroup = mMinimapRowsPerGroup = mMinimapGroups = 0;
 }
 
 const TextEditor::Palette& TextEditor::GetDarkPalette()
@@ -2031,6 +5163,8 @@ const TextEditor::Palette& TextEditor::GetDarkPalette()
 			0x40000000, // Current line fill
 			0x40808080, // Current line fill (inactive)
 			0x40a0a0a0, // Current line edge
+			0x5000a0ff, // Find match
+			0x60a0a0a0, // Matching bracket
 		} };
 	return p;
 }
@@ -2059,6 +5193,8 @@ const TextEditor::Palette& TextEditor::GetLightPalette()
 			0x40000000, // Current line fill
 			0x40808080, // Current line fill (inactive)
 			0x40000000, // Current line edge
+			0x500080ff, // Find match
+			0x40606060, // Matching bracket
 		} };
 	return p;
 }
@@ -2087,6 +5223,8 @@ const TextEditor::Palette& TextEditor::GetRetroBluePalette()
 			0x40000000, // Current line fill
 			0x40808080, // Current line fill (inactive)
 			0x40000000, // Current line edge
+			0x5000c0ff, // Find match
+			0x60ffffff, // Matching bracket
 		} };
 	return p;
 }
@@ -2094,7 +5232,19 @@ const TextEditor::Palette& TextEditor::GetRetroBluePalette()
 
 std::string TextEditor::GetText() const
 {
-	return GetText(Coordinates(), Coordinates((int)mLines.size(), 0));
+	if (mSuspended)
+		return mSuspendedText;
+
+	std::string result(mLines.GetCharCount() + mLines.size() - 1, '\n');
+	char* out = &result[0];
+	for (int i = 0; i < mLines.size(); ++i)
+	{
+		auto& line = mLines[i];
+		if (!line.empty())
+			memcpy(out, line.Chars(), line.size());
+		out += line.size() + 1;
+	}
+	return result;
 }
 
 std::vector<std::string> TextEditor::GetTextLines() const
@@ -2103,16 +5253,10 @@ std::vector<std::string> TextEditor::GetTextLines() const
 
 	result.reserve(mLines.size());
 
-	for (auto& line : mLines)
+	for (int i = 0; i < mLines.size(); ++i)
 	{
-		std::string text;
-
-		text.resize(line.size());
-
-		for (size_t i = 0; i < line.size(); ++i)
-			text[i] = line[i].mChar;
-
-		result.emplace_back(std::move(text));
+		auto& line = mLines[i];
+		result.emplace_back((const char*)line.Chars(), line.size());
 	}
 
 	return result;
@@ -2143,6 +5287,20 @@ void TextEditor::Colorize(int aFromLine, int aLines)
 	mColorRangeMin = std::max(0, mColorRangeMin);
 	mColorRangeMax = std::max(mColorRangeMin, mColorRangeMax);
 	mCheckComments = true;
+	++mTextVersion;
+
+	for (int i = std::max(0, aFromLine); i < toLine; ++i)
+		mLines[i].mGlyphPositions.clear();
+	InvalidateBrackets(aFromLine, toLine);
+	InvalidateMinimap(aFromLine, toLine);
+}
+
+// Stores the lexer state at the end of aLine, returns true if it differs from the one stored by the previous pass
+bool TextEditor::UpdateLineState(int aLine, int aState)
+{
+	const bool changed = mLines[aLine].mState != aState;
+	mLines[aLine].mState = aState;
+	return changed;
 }
 
 void TextEditor::ColorizeRange(int aFromLine, int aToLine)
@@ -2155,6 +5313,8 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 	std::string id;
 
 	int endLine = std::max(0, std::min((int)mLines.size(), aToLine));
+	InvalidateBrackets(aFromLine, endLine);
+	InvalidateMinimap(aFromLine, endLine);
 	for (int i = aFromLine; i < endLine; ++i)
 	{
 		auto& line = mLines[i];
@@ -2162,13 +5322,10 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 		if (line.empty())
 			continue;
 
-		buffer.resize(line.size());
-		for (size_t j = 0; j < line.size(); ++j)
-		{
-			auto& col = line[j];
-			buffer[j] = col.mChar;
-			col.mColorIndex = PaletteIndex::Default;
-		}
+		buffer.assign((const char*)line.Chars(), line.size());
+		uint8_t* attributes = line.Attributes();
+		for (int j = 0; j < line.size(); ++j)
+			SetGlyphColor(attributes[j], PaletteIndex::Default);
 
 		const char* bufferBegin = &buffer.front();
 		const char* bufferEnd = bufferBegin + buffer.size();
@@ -2183,9 +5340,9 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 
 			bool hasTokenizeResult = false;
 
-			if (mLanguageDefinition.mTokenize != nullptr)
+			if (mLanguageDefinition->mTokenize != nullptr)
 			{
-				if (mLanguageDefinition.mTokenize(first, last, token_begin, token_end, token_color))
+				if (mLanguageDefinition->mTokenize(first, last, token_begin, token_end, token_color))
 					hasTokenizeResult = true;
 			}
 
@@ -2222,27 +5379,27 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 					id.assign(token_begin, token_end);
 
 					// todo : allmost all language definitions use lower case to specify keywords, so shouldn't this use ::tolower ?
-					if (!mLanguageDefinition.mCaseSensitive)
+					if (!mLanguageDefinition->mCaseSensitive)
 						std::transform(id.begin(), id.end(), id.begin(), ::toupper);
 
 					if (!line[first - bufferBegin].mPreprocessor)
 					{
-						if (mLanguageDefinition.mKeywords.count(id) != 0)
+						if (mLanguageDefinition->mKeywords.count(id) != 0)
 							token_color = PaletteIndex::Keyword;
-						else if (mLanguageDefinition.mIdentifiers.count(id) != 0)
+						else if (mLanguageDefinition->mIdentifiers.count(id) != 0)
 							token_color = PaletteIndex::KnownIdentifier;
-						else if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
+						else if (mLanguageDefinition->mPreprocIdentifiers.count(id) != 0)
 							token_color = PaletteIndex::PreprocIdentifier;
 					}
 					else
 					{
-						if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
+						if (mLanguageDefinition->mPreprocIdentifiers.count(id) != 0)
 							token_color = PaletteIndex::PreprocIdentifier;
 					}
 				}
 
 				for (size_t j = 0; j < token_length; ++j)
-					line[(token_begin - bufferBegin) + j].mColorIndex = token_color;
+					SetGlyphColor(attributes[(token_begin - bufferBegin) + j], token_color);
 
 				first = token_end;
 			}
@@ -2255,6 +5412,18 @@ void TextEditor::ColorizeInternal()
 	if (mLines.empty() || !mColorizerEnabled)
 		return;
 
+	if (mLanguageDefinition->mStatefulTokenize != nullptr)
+	{
+		// Stateful tokenizers lex comments and long strings themselves, on the colorizer thread. Here we only
+		// pick up finished colors and hand the next damaged range over.
+		mCheckComments = false;
+		if (mColorizeBusy && !ApplyFinishedColorizeJob())
+			return;
+		if (mColorRangeMin < mColorRangeMax)
+			SubmitColorizeJob();
+		return;
+	}
+
 	if (mCheckComments)
 	{
 		auto endLine = mLines.size();
@@ -2283,10 +5452,9 @@ void TextEditor::ColorizeInternal()
 
 			if (!line.empty())
 			{
-				auto& g = line[currentIndex];
-				auto c = g.mChar;
+				auto c = line[currentIndex].mChar;
 
-				if (c != mLanguageDefinition.mPreprocChar && !isspace(c))
+				if (c != mLanguageDefinition->mPreprocChar && !isspace(c))
 					firstChar = false;
 
 				if (currentIndex == (int)line.size() - 1 && line[line.size() - 1].mChar == '\\')
@@ -2296,7 +5464,7 @@ void TextEditor::ColorizeInternal()
 
 				if (withinString)
 				{
-					line[currentIndex].mMultiLineComment = inComment;
+					SetGlyphFlag(line.Attributes()[currentIndex], Glyph::MultiLineCommentFlag, inComment);
 
 					if (c == '\"')
 					{
@@ -2304,7 +5472,7 @@ void TextEditor::ColorizeInternal()
 						{
 							currentIndex += 1;
 							if (currentIndex < (int)line.size())
-								line[currentIndex].mMultiLineComment = inComment;
+								SetGlyphFlag(line.Attributes()[currentIndex], Glyph::MultiLineCommentFlag, inComment);
 						}
 						else
 							withinString = false;
@@ -2313,35 +5481,35 @@ void TextEditor::ColorizeInternal()
 					{
 						currentIndex += 1;
 						if (currentIndex < (int)line.size())
-							line[currentIndex].mMultiLineComment = inComment;
+							SetGlyphFlag(line.Attributes()[currentIndex], Glyph::MultiLineCommentFlag, inComment);
 					}
 				}
 				else
 				{
-					if (firstChar && c == mLanguageDefinition.mPreprocChar)
+					if (firstChar && c == mLanguageDefinition->mPreprocChar)
 						withinPreproc = true;
 
 					if (c == '\"')
 					{
 						withinString = true;
-						line[currentIndex].mMultiLineComment = inComment;
+						SetGlyphFlag(line.Attributes()[currentIndex], Glyph::MultiLineCommentFlag, inComment);
 					}
 					else
 					{
-						auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
-						auto from = line.begin() + currentIndex;
-						auto& startStr = mLanguageDefinition.mCommentStart;
-						auto& startStr2 = mLanguageDefinition.mCommentStart2;
-						auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
-						auto& singleStartStr2 = mLanguageDefinition.mSingleLineComment2;
+						auto pred = [](const char& a, const Char& b) { return a == (char)b; };
+						auto from = line.Chars() + currentIndex;
+						auto& startStr = mLanguageDefinition->mCommentStart;
+						auto& startStr2 = mLanguageDefinition->mCommentStart2;
+						auto& singleStartStr = mLanguageDefinition->mSingleLineComment;
+						auto& singleStartStr2 = mLanguageDefinition->mSingleLineComment2;
 
 						if (singleStartStr.size() > 0 &&
-							currentIndex + singleStartStr.size() <= line.size() &&
+							currentIndex + singleStartStr.size() <= (size_t)line.size() &&
 							equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred) &&
 							!equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
 						{
 							withinSingleLineComment = true;
-							if (currentIndex + startStr.size() > line.size())
+							if (currentIndex + startStr.size() > (size_t)line.size())
 							{
 								withinSingleLineComment = true;
 							}
@@ -2351,12 +5519,12 @@ void TextEditor::ColorizeInternal()
 							}
 						}
 						if (singleStartStr2.size() > 0 &&
-							currentIndex + singleStartStr2.size() <= line.size() &&
+							currentIndex + singleStartStr2.size() <= (size_t)line.size() &&
 							equals(singleStartStr2.begin(), singleStartStr2.end(), from, from + singleStartStr2.size(), pred) &&
 							!equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
 						{
 							withinSingleLineComment = true;
-							if (currentIndex + startStr.size() > line.size())
+							if (currentIndex + startStr.size() > (size_t)line.size())
 							{
 								withinSingleLineComment = true;
 							}
@@ -2365,7 +5533,7 @@ void TextEditor::ColorizeInternal()
 								withinSingleLineComment = true;
 							}
 						}
-						if (!withinSingleLineComment && currentIndex + startStr.size() <= line.size() &&
+						if (!withinSingleLineComment && currentIndex + startStr.size() <= (size_t)line.size() &&
 							equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
 						{
 							commentStartLine = currentLine;
@@ -2375,12 +5543,12 @@ void TextEditor::ColorizeInternal()
 						// AUIWFVBAWUFVAWUFVBAWIFAWIUAWIUGVAWUIFVBAWUIFBAWIUOFBAWUIFGVBAWUFBAWBFGAUIG
 
 						if (singleStartStr.size() > 0 &&
-							currentIndex + singleStartStr.size() <= line.size() &&
+							currentIndex + singleStartStr.size() <= (size_t)line.size() &&
 							equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred) &&
 							!equals(startStr2.begin(), startStr2.end(), from, from + startStr2.size(), pred))
 						{
 							withinSingleLineComment = true;
-							if (currentIndex + startStr2.size() > line.size())
+							if (currentIndex + startStr2.size() > (size_t)line.size())
 							{
 								withinSingleLineComment = true;
 							}
@@ -2390,12 +5558,12 @@ void TextEditor::ColorizeInternal()
 							}
 						}
 						if (singleStartStr2.size() > 0 &&
-							currentIndex + singleStartStr2.size() <= line.size() &&
+							currentIndex + singleStartStr2.size() <= (size_t)line.size() &&
 							equals(singleStartStr2.begin(), singleStartStr2.end(), from, from + singleStartStr2.size(), pred) &&
 							!equals(startStr2.begin(), startStr2.end(), from, from + startStr2.size(), pred))
 						{
 							withinSingleLineComment = true;
-							if (currentIndex + startStr2.size() > line.size())
+							if (currentIndex + startStr2.size() > (size_t)line.size())
 							{
 								withinSingleLineComment = true;
 							}
@@ -2404,7 +5572,7 @@ void TextEditor::ColorizeInternal()
 								withinSingleLineComment = true;
 							}
 						}
-						if (!withinSingleLineComment && currentIndex + startStr2.size() <= line.size() &&
+						if (!withinSingleLineComment && currentIndex + startStr2.size() <= (size_t)line.size() &&
 							equals(startStr2.begin(), startStr2.end(), from, from + startStr2.size(), pred))
 						{
 							commentStartLine = currentLine;
@@ -2413,10 +5581,10 @@ void TextEditor::ColorizeInternal()
 
 						inComment = inComment = (commentStartLine < currentLine || (commentStartLine == currentLine && commentStartIndex <= currentIndex));
 
-						line[currentIndex].mMultiLineComment = inComment;
-						line[currentIndex].mComment = withinSingleLineComment;
+						SetGlyphFlag(line.Attributes()[currentIndex], Glyph::MultiLineCommentFlag, inComment);
+						SetGlyphFlag(line.Attributes()[currentIndex], Glyph::CommentFlag, withinSingleLineComment);
 
-						auto& endStr = mLanguageDefinition.mCommentEnd;
+						auto& endStr = mLanguageDefinition->mCommentEnd;
 						if (currentIndex + 1 >= (int)endStr.size() &&
 							equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
 						{
@@ -2424,7 +5592,7 @@ void TextEditor::ColorizeInternal()
 							commentStartLine = endLine;
 						}
 
-						auto& endStr2 = mLanguageDefinition.mCommentEnd2;
+						auto& endStr2 = mLanguageDefinition->mCommentEnd2;
 						if (currentIndex + 1 >= (int)endStr2.size() &&
 							equals(endStr2.begin(), endStr2.end(), from + 1 - endStr2.size(), from + 1, pred))
 						{
@@ -2433,7 +5601,7 @@ void TextEditor::ColorizeInternal()
 						}
 					}
 				}
-				line[currentIndex].mPreprocessor = withinPreproc;
+				SetGlyphFlag(line.Attributes()[currentIndex], Glyph::PreprocessorFlag, withinPreproc);
 				currentIndex += UTF8CharLength(c);
 				if (currentIndex >= (int)line.size())
 				{
@@ -2448,11 +5616,13 @@ void TextEditor::ColorizeInternal()
 			}
 		}
 		mCheckComments = false;
+		InvalidateBrackets(0, (int)mLines.size());
+		InvalidateMinimap(0, (int)mLines.size());
 	}
 
 	if (mColorRangeMin < mColorRangeMax)
 	{
-		const int increment = (mLanguageDefinition.mTokenize == nullptr) ? 10 : 10000;
+		const int increment = (mLanguageDefinition->mTokenize == nullptr) ? 10 : 10000;
 		const int to = std::min(mColorRangeMin + increment, mColorRangeMax);
 		ColorizeRange(mColorRangeMin, to);
 		mColorRangeMin = to;
@@ -2466,16 +5636,236 @@ void TextEditor::ColorizeInternal()
 	}
 }
 
+void TextEditor::SubmitColorizeJob()
+{
+	// Resume from the state at the end of the previous line, going back over lines never lexed
+	int from = std::min(mColorRangeMin, (int)mLines.size());
+	while (from > 0 && mLines[from - 1].mState < 0)
+		--from;
+
+	// Large ranges (a freshly loaded file) are split so results show up progressively
+	const int to = std::min(std::min(mColorRangeMax, (int)mLines.size()), from + 10000);
+	mColorRangeMin = to;
+	if (mColorRangeMin >= mColorRangeMax)
+	{
+		mColorRangeMin = std::numeric_limits<int>::max();
+		mColorRangeMax = 0;
+	}
+	if (from >= to)
+		return;
+
+	std::unique_ptr<ColorizeJob> job(new ColorizeJob());
+	job->mVersion = mTextVersion;
+	job->mFromLine = from;
+	job->mStartState = from > 0 ? mLines[from - 1].mState : 0;
+	job->mLanguage = mLanguageDefinition;
+	job->mLineEnds.reserve(to - from);
+	for (int i = from; i < to; ++i)
+	{
+		auto& line = mLines[i];
+		job->mText.append((const char*)line.Chars(), line.size());
+		job->mLineEnds.push_back((int)job->mText.size());
+	}
+
+	mColorizeBusy = true;
+	mColorizeJobFrom = from;
+	mColorizeJobCount = to - from;
+
+	std::lock_guard<std::mutex> lock(mColorizeMutex);
+	mColorizeJob = std::move(job);
+	if (mColorizeThreadRunning)
+	{
+		mColorizeCondition.notify_one();
+	}
+	else
+	{
+		if (mColorizeThread.joinable())
+			mColorizeThread.join();
+		mColorizeThreadRunning = true;
+		mColorizeThread = std::thread(&TextEditor::ColorizerThread, this);
+	}
+}
+
+// Applies the job the colorizer thread is done with, returns false while it is still running
+bool TextEditor::ApplyFinishedColorizeJob()
+{
+	std::unique_ptr<ColorizeJob> done;
+	{
+		std::lock_guard<std::mutex> lock(mColorizeMutex);
+		done = std::move(mColorizeDone);
+	}
+	if (!done)
+		return false;
+	mColorizeBusy = false;
+	ApplyColorizeJob(*done);
+	return true;
+}
+
+// Keeps the range of the job on the colorizer thread on the same lines when aCount lines are inserted (or removed if negative) at aIndex
+void TextEditor::ShiftColorizeJob(int aIndex, int aCount)
+{
+	if (!mColorizeBusy)
+		return;
+
+	const int jobEnd = mColorizeJobFrom + mColorizeJobCount;
+	if (aCount > 0)
+	{
+		if (aIndex <= mColorizeJobFrom)
+			mColorizeJobFrom += aCount;
+		else if (aIndex < jobEnd)
+			mColorizeJobCount += aCount;
+		return;
+	}
+
+	const int removedEnd = aIndex - aCount;
+	const int removedBefore = std::max(0, std::min(removedEnd, mColorizeJobFrom) - aIndex);
+	const int removedInside = std::max(0, std::min(removedEnd, jobEnd) - std::max(aIndex, mColorizeJobFrom));
+	mColorizeJobFrom -= removedBefore;
+	mColorizeJobCount -= removedInside;
+}
+
+void TextEditor::ApplyColorizeJob(const ColorizeJob& aJob)
+{
+	// The text changed since the snapshot was taken, lex the same lines again (InsertLine/RemoveLine kept the range in place)
+	if (aJob.mVersion != mTextVersion)
+	{
+		Colorize(mColorizeJobFrom, mColorizeJobCount);
+		return;
+	}
+
+	int begin = 0;
+	for (int n = 0; n < (int)aJob.mLineEnds.size(); ++n)
+	{
+		const int i = aJob.mFromLine + n;
+		auto& line = mLines[i];
+		const int end = aJob.mLineEnds[n];
+		if (line.size() != end - begin)
+		{
+			// Edited without going through Colorize(), lex it again
+			Colorize(i, (int)aJob.mLineEnds.size() - n);
+			return;
+		}
+
+		// A color alone, the stateful lexer leaves no comment flags
+		uint8_t* attributes = line.Attributes();
+		for (int j = 0; j < line.size(); ++j)
+			attributes[j] = (uint8_t)aJob.mColors[begin + j];
+		begin = end;
+		InvalidateBrackets(i, i + 1);
+		InvalidateMinimap(i, i + 1);
+
+		// An edit that opens or closes a long string/comment changes the end state, keep going until it matches the previous pass again.
+		// The text itself didn't change, so this extends the range without bumping mTextVersion.
+		if (UpdateLineState(i, aJob.mEndStates[n]) && n + 1 == (int)aJob.mLineEnds.size() && i + 1 < (int)mLines.size())
+		{
+			mColorRangeMin = std::min(mColorRangeMin, i + 1);
+			mColorRangeMax = std::max(mColorRangeMax, i + 2);
+			mCheckComments = true;
+		}
+	}
+}
+
+void TextEditor::ColorizerThread()
+{
+	std::unique_lock<std::mutex> lock(mColorizeMutex);
+	for (;;)
+	{
+		// Exit when idle so the thread is long gone by the time the module gets unloaded, SubmitColorizeJob() starts a new one
+		if (!mColorizeCondition.wait_for(lock, std::chrono::seconds(1), [this] { return mColorizeStop || mColorizeJob != nullptr; }))
+			break;
+		if (mColorizeStop)
+			break;
+
+		std::unique_ptr<ColorizeJob> job = std::move(mColorizeJob);
+		lock.unlock();
+		job->Run();
+		lock.lock();
+		mColorizeDone = std::move(job);
+	}
+	mColorizeThreadRunning = false;
+}
+
+void TextEditor::ColorizeJob::Run()
+{
+	const LanguageDefinition& lang = *mLanguage;
+	const char* text = mText.data();
+	std::string id;
+	int state = mStartState;
+
+	mColors.assign(mText.size(), PaletteIndex::Default);
+	mEndStates.reserve(mLineEnds.size());
+
+	int lineBegin = 0;
+	for (int lineEnd : mLineEnds)
+	{
+		const char* last = text + lineEnd;
+		for (const char* first = text + lineBegin; first != last; )
+		{
+			const char* token_begin = nullptr;
+			const char* token_end = nullptr;
+			PaletteIndex token_color = PaletteIndex::Default;
+
+			if (!lang.mStatefulTokenize(first, last, token_begin, token_end, token_color, state))
+			{
+				first++;
+				continue;
+			}
+
+			if (token_color == PaletteIndex::Identifier)
+			{
+				id.assign(token_begin, token_end);
+				if (!lang.mCaseSensitive)
+					std::transform(id.begin(), id.end(), id.begin(), ::toupper);
+
+				if (lang.mKeywords.count(id) != 0)
+					token_color = PaletteIndex::Keyword;
+				else if (lang.mIdentifiers.count(id) != 0)
+					token_color = PaletteIndex::KnownIdentifier;
+				else if (lang.mPreprocIdentifiers.count(id) != 0)
+					token_color = PaletteIndex::PreprocIdentifier;
+			}
+
+			std::fill(mColors.begin() + (token_begin - text), mColors.begin() + (token_end - text), token_color);
+			first = token_end;
+		}
+		mEndStates.push_back(state);
+		lineBegin = lineEnd;
+	}
+}
+
 float TextEditor::TextDistanceToLineStart(const Coordinates& aFrom) const
 {
-	auto& line = mLines[aFrom.mLine];
+	auto& positions = GetGlyphPositions(aFrom.mLine);
+	int colIndex = GetCharacterIndex(aFrom);
+	return positions[std::min(std::max(colIndex, 0), (int)positions.size() - 1)];
+}
+
+// Distance from the line start of every glyph index in aLine (the bytes of a UTF-8 sequence share the position of the character),
+// followed by the width of the whole line. Measured on first use and dropped by Colorize(), which every edit goes through.
+const std::vector<float>& TextEditor::GetGlyphPositions(int aLine) const
+{
+	if (mGlyphPositionsFont != ImGui::GetFont() || mGlyphPositionsFontSize != ImGui::GetFontSize() || mGlyphPositionsTabSize != mTabSize)
+	{
+		for (int i = 0; i < mLines.size(); ++i)
+			mLines[i].mGlyphPositions.clear();
+		mGlyphPositionsFont = ImGui::GetFont();
+		mGlyphPositionsFontSize = ImGui::GetFontSize();
+		mGlyphPositionsTabSize = mTabSize;
+	}
+
+	auto& line = mLines[aLine];
+	auto& positions = line.mGlyphPositions;
+	if (!positions.empty())
+		return positions;
+
+	positions.resize(line.size() + 1);
 	float distance = 0.0f;
 	float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
-	int colIndex = GetCharacterIndex(aFrom);
-	for (size_t it = 0u; it < line.size() && it < colIndex; )
+	for (int it = 0; it < line.size(); )
 	{
 		if (line[it].mChar == '\t')
 		{
+			positions[it] = distance;
 			distance = (1.0f + std::floor((1.0f + distance) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
 			++it;
 		}
@@ -2484,19 +5874,25 @@ float TextEditor::TextDistanceToLineStart(const Coordinates& aFrom) const
 			auto d = UTF8CharLength(line[it].mChar);
 			char tempCString[7];
 			int i = 0;
-			for (; i < 6 && d-- > 0 && it < (int)line.size(); i++, it++)
+			for (; i < 6 && d-- > 0 && it < line.size(); i++, it++)
+			{
+				positions[it] = distance;
 				tempCString[i] = line[it].mChar;
+			}
 
 			tempCString[i] = '\0';
 			distance += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, tempCString, nullptr, nullptr).x;
 		}
 	}
+	positions[line.size()] = distance;
 
-	return distance;
+	return positions;
 }
 
 void TextEditor::EnsureCursorVisible()
 {
+	UnfoldAround(mState.mCursorPosition.mLine);
+
 	if (!mWithinRender)
 	{
 		mScrollToCursor = true;
@@ -2517,17 +5913,19 @@ void TextEditor::EnsureCursorVisible()
 
 	auto pos = GetActualCursorCoordinates();
 	auto len = TextDistanceToLineStart(pos);
+	const int row = LineToRow(pos.mLine);
 
-	if (pos.mLine < top)
-		ImGui::SetScrollY(std::max(0.0f, (pos.mLine - 1) * mCharAdvance.y));
-	if (pos.mLine > bottom - 4)
-		ImGui::SetScrollY(std::max(0.0f, (pos.mLine + 4) * mCharAdvance.y - height));
+	if (row < top)
+		ImGui::SetScrollY(std::max(0.0f, (row - 1) * mCharAdvance.y));
+	if (row > bottom - 4)
+		ImGui::SetScrollY(std::max(0.0f, (row + 4) * mCharAdvance.y - height));
 	if (len + mTextStart < left + 4)
 		ImGui::SetScrollX(std::max(0.0f, len + mTextStart - 4));
 	if (len + mTextStart > right - 4)
 		ImGui::SetScrollX(std::max(0.0f, len + mTextStart + 4 - width));
 }
 
+// In rows, which is what MoveUp() and MoveDown() count
 int TextEditor::GetPageSize() const
 {
 	auto height = ImGui::GetWindowHeight() - 20.0f;
@@ -2556,18 +5954,21 @@ TextEditor::UndoRecord::UndoRecord(
 	assert(mRemovedStart <= mRemovedEnd);
 }
 
-void TextEditor::UndoRecord::Undo(TextEditor* aEditor)
+void TextEditor::UndoEntry::Undo(TextEditor* aEditor) const
 {
-	if (!mAdded.empty())
+	if (mAddedLength > 0)
 	{
+		// Journal what the range covers, pasted carriage returns are in the record but not in the lines
+		aEditor->RecordChange(mAddedStart, aEditor->CoordinatesToOffset(mAddedEnd) - aEditor->CoordinatesToOffset(mAddedStart), nullptr, 0);
 		aEditor->DeleteRange(mAddedStart, mAddedEnd);
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 2);
 	}
 
-	if (!mRemoved.empty())
+	if (mRemovedLength > 0)
 	{
 		auto start = mRemovedStart;
-		aEditor->InsertTextAt(start, mRemoved.c_str());
+		aEditor->RecordChange(start, 0, aEditor->mUndoText.c_str() + mText + mAddedLength + 1, mRemovedLength);
+		aEditor->InsertTextAt(start, aEditor->mUndoText.c_str() + mText + mAddedLength + 1);
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 2);
 	}
 
@@ -2576,18 +5977,20 @@ void TextEditor::UndoRecord::Undo(TextEditor* aEditor)
 
 }
 
-void TextEditor::UndoRecord::Redo(TextEditor* aEditor)
+void TextEditor::UndoEntry::Redo(TextEditor* aEditor) const
 {
-	if (!mRemoved.empty())
+	if (mRemovedLength > 0)
 	{
+		aEditor->RecordChange(mRemovedStart, aEditor->CoordinatesToOffset(mRemovedEnd) - aEditor->CoordinatesToOffset(mRemovedStart), nullptr, 0);
 		aEditor->DeleteRange(mRemovedStart, mRemovedEnd);
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 1);
 	}
 
-	if (!mAdded.empty())
+	if (mAddedLength > 0)
 	{
 		auto start = mAddedStart;
-		aEditor->InsertTextAt(start, mAdded.c_str());
+		aEditor->RecordChange(start, 0, aEditor->mUndoText.c_str() + mText, mAddedLength);
+		aEditor->InsertTextAt(start, aEditor->mUndoText.c_str() + mText);
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 1);
 	}
 
@@ -2814,6 +6217,232 @@ static bool TokenizeCStylePunctuation(const char* in_begin, const char* in_end,
 	return false;
 }
 
+// Lexer state of the GLua tokenizer: the kind of construct left open at the end of a token in the low bits, the long bracket level ("[==[" is 2) above them
+enum LuaLexState
+{
+	LuaLexNone = 0,
+	LuaLexLongString = 1,
+	LuaLexLongComment = 2,
+	LuaLexBlockComment = 3,
+	LuaLexKindMask = 3,
+	LuaLexLevelShift = 2
+};
+
+// Returns the level of the long bracket opening at p ("[[", "[=[", ...), or -1 if there is none
+static int LuaLongBracketLevel(const char* p, const char* in_end)
+{
+	if (p >= in_end || *p != '[')
+		return -1;
+
+	const char* q = p + 1;
+	while (q < in_end && *q == '=')
+		q++;
+
+	return (q < in_end && *q == '[') ? (int)(q - p - 1) : -1;
+}
+
+// Returns the end of the delimiter closing the construct described by aState, or nullptr if it doesn't close on this line
+static const char* LuaFindClose(const char* p, const char* in_end, int aState)
+{
+	if ((aState & LuaLexKindMask) == LuaLexBlockComment)
+	{
+		for (; p + 1 < in_end; p++)
+			if (p[0] == '*' && p[1] == '/')
+				return p + 2;
+		return nullptr;
+	}
+
+	const int level = aState >> LuaLexLevelShift;
+	while ((p = (const char*)memchr(p, ']', in_end - p)) != nullptr)
+	{
+		const char* q = p + 1;
+		while (q < in_end && *q == '=')
+			q++;
+		if (q < in_end && *q == ']' && q - p - 1 == level)
+			return q + 1;
+		p++;
+	}
+	return nullptr;
+}
+
+static bool TokenizeLuaLongBracket(const char* in_begin, const char* in_end, const char* body, int aKind, int aLevel, const char*& out_begin, const char*& out_end, int& state)
+{
+	state = aKind | (aLevel << LuaLexLevelShift);
+
+	const char* close = LuaFindClose(body, in_end, state);
+	if (close != nullptr)
+		state = LuaLexNone;
+
+	out_begin = in_begin;
+	out_end = close != nullptr ? close : in_end;
+	return true;
+}
+
+static bool TokenizeLuaString(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end)
+{
+	const char quote = *in_begin;
+	if (quote != '"' && quote != '\'')
+		return false;
+
+	const char* p = in_begin + 1;
+	while (p < in_end && *p != quote)
+		p += (*p == '\\' && p + 1 < in_end) ? 2 : 1;
+
+	// An unterminated string runs to the end of the line
+	out_begin = in_begin;
+	out_end = p < in_end ? p + 1 : in_end;
+	return true;
+}
+
+static bool TokenizeLuaNumber(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end)
+{
+	auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+	auto isHexDigit = [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); };
+
+	const char* p = in_begin;
+	if (!isDigit(*p) && !(*p == '.' && p + 1 < in_end && isDigit(p[1])))
+		return false;
+
+	if (p[0] == '0' && p + 1 < in_end && (p[1] == 'x' || p[1] == 'X'))
+	{
+		// 0xff, 0x1.8p3
+		p += 2;
+		while (p < in_end && isHexDigit(*p))
+			p++;
+		if (p < in_end && *p == '.')
+			for (p++; p < in_end && isHexDigit(*p); p++);
+		if (p < in_end && (*p == 'p' || *p == 'P'))
+		{
+			p++;
+			if (p < in_end && (*p == '+' || *p == '-'))
+				p++;
+			while (p < in_end && isDigit(*p))
+				p++;
+		}
+	}
+	else
+	{
+		// 3, 3.0, .5, 1e-3
+		while (p < in_end && isDigit(*p))
+			p++;
+		if (p < in_end && *p == '.')
+			for (p++; p < in_end && isDigit(*p); p++);
+		if (p < in_end && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+			if (p < in_end && (*p == '+' || *p == '-'))
+				p++;
+			while (p < in_end && isDigit(*p))
+				p++;
+		}
+	}
+
+	// LuaJIT literal suffixes: 1LL, 1ULL, 1i
+	while (p < in_end && (*p == 'u' || *p == 'U' || *p == 'l' || *p == 'L' || *p == 'i' || *p == 'I'))
+		p++;
+
+	out_begin = in_begin;
+	out_end = p;
+	return true;
+}
+
+static bool TokenizeLuaPunctuation(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end)
+{
+	// Longest first. != && || are GLua extensions
+	static const char* const operators[] = { "...", "..", "==", "~=", "!=", "<=", ">=", "::", "&&", "||" };
+	for (auto op : operators)
+	{
+		const size_t len = strlen(op);
+		if ((size_t)(in_end - in_begin) >= len && memcmp(in_begin, op, len) == 0)
+		{
+			out_begin = in_begin;
+			out_end = in_begin + len;
+			return true;
+		}
+	}
+
+	if (*in_begin != '\0' && strchr("+-*/%^#&~|<>=(){}[];:,.!", *in_begin) != nullptr)
+	{
+		out_begin = in_begin;
+		out_end = in_begin + 1;
+		return true;
+	}
+	return false;
+}
+
+// Hand-written GLua scanner: Lua 5.1/LuaJIT tokens plus the GMod // and /* */ comments and C-style operators. Long strings and
+// long/block comments that don't close on their line leave their kind and level in state, and the next line resumes inside them.
+static bool TokenizeGLua(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end, TextEditor::PaletteIndex& paletteIndex, int& state)
+{
+	typedef TextEditor::PaletteIndex PaletteIndex;
+
+	if (state != LuaLexNone)
+	{
+		paletteIndex = (state & LuaLexKindMask) == LuaLexLongString ? PaletteIndex::String : PaletteIndex::MultiLineComment;
+		const char* close = LuaFindClose(in_begin, in_end, state);
+		if (close != nullptr)
+			state = LuaLexNone;
+
+		out_begin = in_begin;
+		out_end = close != nullptr ? close : in_end;
+		return true;
+	}
+
+	while (in_begin < in_end && (*in_begin == ' ' || *in_begin == '\t'))
+		in_begin++;
+
+	if (in_begin == in_end)
+	{
+		out_begin = in_end;
+		out_end = in_end;
+		paletteIndex = PaletteIndex::Default;
+		return true;
+	}
+
+	const char c = in_begin[0];
+	const char next = in_begin + 1 < in_end ? in_begin[1] : '\0';
+	int level;
+
+	if ((c == '-' && next == '-') || (c == '/' && next == '/'))
+	{
+		if (c == '-' && (level = LuaLongBracketLevel(in_begin + 2, in_end)) >= 0)
+		{
+			paletteIndex = PaletteIndex::MultiLineComment;
+			return TokenizeLuaLongBracket(in_begin, in_end, in_begin + 2 + level + 2, LuaLexLongComment, level, out_begin, out_end, state);
+		}
+
+		paletteIndex = PaletteIndex::Comment;
+		out_begin = in_begin;
+		out_end = in_end;
+		return true;
+	}
+
+	if (c == '/' && next == '*')
+	{
+		paletteIndex = PaletteIndex::MultiLineComment;
+		return TokenizeLuaLongBracket(in_begin, in_end, in_begin + 2, LuaLexBlockComment, 0, out_begin, out_end, state);
+	}
+
+	if ((level = LuaLongBracketLevel(in_begin, in_end)) >= 0)
+	{
+		paletteIndex = PaletteIndex::String;
+		return TokenizeLuaLongBracket(in_begin, in_end, in_begin + level + 2, LuaLexLongString, level, out_begin, out_end, state);
+	}
+
+	if (TokenizeLuaString(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::String;
+	else if (TokenizeCStyleIdentifier(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Identifier;
+	else if (TokenizeLuaNumber(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Number;
+	else if (TokenizeLuaPunctuation(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Punctuation;
+	else
+		return false;
+
+	return true;
+}
+
 const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus()
 {
 	static bool inited = false;
@@ -2827,6 +6456,13 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus(
 		for (auto& k : cppKeywords)
 			langDef.mKeywords.insert(k);
 
+		for (auto& k : { "function", "if", "do", "repeat" })
+			langDef.mBlockOpeners.insert(k);
+		for (auto& k : { "end", "until" })
+			langDef.mBlockClosers.insert(k);
+		for (auto& k : { "while", "for" })
+			langDef.mBlockHeads.insert(k);
+
 		static const char* const identifiers[] = {
 			"assert", "collectgarbage", "dofile", "error", "getmetatable", "ipairs", "loadfile", "load", "loadstring",  "next",  "pairs",  "pcall",  "print",  "rawequal",  "rawlen",  "rawget",  "rawset",
 			"select",  "setmetatable",  "tonumber",  "tostring",  "type",  "xpcall",  "_G",  "_VERSION","arshift", "band", "bnot", "bor", "bxor", "btest", "extract", "lrotate", "lshift", "replace",
@@ -2949,4 +6585,23 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus(
 		inited = true;
 	}
 	return langDef;
+}
+
+const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::GLua()
+{
+	static bool inited = false;
+	static LanguageDefinition langDef;
+	if (!inited)
+	{
+		// Same keyword and API tables, lexed by the stateful scanner instead of the C tokenizers and the comment pass
+		langDef = CPlusPlus();
+		langDef.mTokenize = nullptr;
+		langDef.mTokenRegexStrings.clear();
+		langDef.mStatefulTokenize = TokenizeGLua;
+		langDef.mPreprocChar = '\0';
+		langDef.mName = "GLua";
+
+		inited = true;
+	}
+	return langDef;
 }
\ No newline at end of file
@@ -7,13 +7,18 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <map>
+#include <deque>
 #include <regex>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include "imgui.h"
 
 class TextEditor
 {
 public:
-	enum class PaletteIndex
+	enum class PaletteIndex : uint8_t
 	{
 		Default,
 		Keyword,
@@ -36,6 +41,8 @@ public:
 		CurrentLineFill,
 		CurrentLineFillInactive,
 		CurrentLineEdge,
+		FindMatch,
+		MatchingBracket,
 		Max
 	};
 
@@ -143,44 +150,108 @@ public:
 
 		Glyph(Char aChar, PaletteIndex aColorIndex) : mChar(aChar), mColorIndex(aColorIndex),
 			mComment(false), mMultiLineComment(false), mPreprocessor(false) {}
+
+		// The color and comment flags packed in one byte, which is how the editor stores them next to the chars.
+		// A color alone is a valid byte with no flags set.
+		static const uint8_t ColorMask = 0x1f;
+		static const uint8_t CommentFlag = 0x20;
+		static const uint8_t MultiLineCommentFlag = 0x40;
+		static const uint8_t PreprocessorFlag = 0x80;
+		static_assert((int)PaletteIndex::Max <= ColorMask + 1, "palette index must fit in 5 bits");
+
+		Glyph(Char aChar, uint8_t aAttributes) : mChar(aChar), mColorIndex((PaletteIndex)(aAttributes & ColorMask)),
+			mComment((aAttributes & CommentFlag) != 0), mMultiLineComment((aAttributes & MultiLineCommentFlag) != 0),
+			mPreprocessor((aAttributes & PreprocessorFlag) != 0) {}
+		uint8_t GetAttributes() const
+		{
+			return (uint8_t)((int)mColorIndex | (mComment ? CommentFlag : 0) | (mMultiLineComment ? MultiLineCommentFlag : 0) | (mPreprocessor ? PreprocessorFlag : 0));
+		}
 	};
 
-	typedef std::vector<Glyph> Line;
-	typedef std::vector<Line> Lines;
+	struct Completion
+	{
+		const char* mText;      // the whole dotted name, replaces the one left of the cursor
+		const char* mDetail;    // signature or kind shown next to it, may be empty
+	};
+
+	// Textures are made by the renderer backend, the editor only fills in pixels. Without mCreate there is no minimap.
+	struct TextureHandler
+	{
+		ImTextureID(*mCreate)(int aWidth, int aHeight);     // null if it failed
+		// aPixels is the whole image, ImU32 colors like IM_COL32 makes them, of which rows [aRowStart, aRowEnd) changed
+		void(*mUpdate)(ImTextureID aTexture, int aWidth, const ImU32* aPixels, int aRowStart, int aRowEnd);
+		void(*mDestroy)(ImTextureID aTexture);
+	};
+
+	// An edit in bytes, for keeping a copy of the text elsewhere: mRemoved bytes (line breaks count as one) starting at byte
+	// mIndex of line mLine were replaced by mText. A reset replaces the whole text instead.
+	struct Change
+	{
+		bool mReset = false;
+		int mLine = 0;
+		int mIndex = 0;
+		size_t mRemoved = 0;
+		std::string mText;
+	};
+
+	// A problem found by the language's diagnose callback, underlined in the text
+	struct Diagnostic
+	{
+		int mLine;              // 0-based, like Coordinates
+		int mStartIndex;        // byte range in the line
+		int mEndIndex;
+		std::string mMessage;
+	};
 
 	struct LanguageDefinition
 	{
 		typedef std::pair<std::string, PaletteIndex> TokenRegexString;
 		typedef std::vector<TokenRegexString> TokenRegexStrings;
 		typedef bool(*TokenizeCallback)(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end, PaletteIndex& paletteIndex);
+		// Like TokenizeCallback, for languages with tokens spanning lines. state carries the open construct (long string, block comment)
+		// from one token to the next and across line ends, 0 means none. Comments are colored by the tokenizer itself.
+		typedef bool(*StatefulTokenizeCallback)(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end, PaletteIndex& paletteIndex, int& state);
+		// Fills up to aMax completions for a dotted name prefix such as "net.Wri", returns how many. The editor copies the strings right away.
+		typedef int(*CompleteCallback)(const char* aPrefix, size_t aLength, Completion* aOut, int aMax);
+		// Checks the whole text (lines separated by '\n') on the diagnostics thread. Should give up and return false soon after aCancel is set.
+		typedef bool(*DiagnoseCallback)(const char* aBegin, const char* aEnd, std::vector<Diagnostic>& aOut, const std::atomic<bool>& aCancel);
 
 		std::string mName;
 		Keywords mKeywords;
 		Identifiers mIdentifiers;
 		Identifiers mPreprocIdentifiers;
+		// Keywords that open and close blocks, matched like brackets. A head (while, for) belongs to the next opener
+		// (its do) and is highlighted along with it.
+		Keywords mBlockOpeners, mBlockClosers, mBlockHeads;
 		std::string mCommentStart, mCommentEnd, mCommentStart2, mCommentEnd2, mSingleLineComment, mSingleLineComment2;
 		char mPreprocChar;
 		bool mAutoIndentation;
 
 		TokenizeCallback mTokenize;
+		StatefulTokenizeCallback mStatefulTokenize;
+		CompleteCallback mComplete;
+		DiagnoseCallback mDiagnose;
 
 		TokenRegexStrings mTokenRegexStrings;
 
 		bool mCaseSensitive;
 
 		LanguageDefinition()
-			: mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mCaseSensitive(true)
+			: mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mStatefulTokenize(nullptr), mComplete(nullptr), mDiagnose(nullptr), mCaseSensitive(true)
 		{
 		}
 
 		static const LanguageDefinition& CPlusPlus();
+		static const LanguageDefinition& GLua();
 	};
 
 	TextEditor();
 	~TextEditor();
 
 	void SetLanguageDefinition(const LanguageDefinition& aLanguageDef);
-	const LanguageDefinition& GetLanguageDefinition() const { return mLanguageDefinition; }
+	// Editors given the same definition share it instead of holding a copy each
+	void SetLanguageDefinition(std::shared_ptr<const LanguageDefinition> aLanguageDef);
+	const LanguageDefinition& GetLanguageDefinition() const { return *mLanguageDefinition; }
 
 	const Palette& GetPalette() const { return mPaletteBase; }
 	void SetPalette(const Palette& aValue);
@@ -190,15 +261,20 @@ public:
 
 	void Render(const char* aTitle, const ImVec2& aSize = ImVec2(), bool aBorder = false);
 	void SetText(const std::string& aText);
+	void SetText(const char* aText, size_t aLength);
 	std::string GetText() const;
 
 	void SetTextLines(const std::vector<std::string>& aLines);
 	std::vector<std::string> GetTextLines() const;
 
+	// Every edit from here on is recorded as a Change until taken, in order. Undo and redo are edits like any other.
+	void SetRecordChanges(bool aValue) { mRecordChanges = aValue; mChanges.clear(); }
+	void TakeChanges(std::vector<Change>& aChanges) { aChanges.clear(); aChanges.swap(mChanges); }
+
 	std::string GetSelectedText() const;
 	std::string GetCurrentLineText()const;
 
-	int GetTotalLines() const { return (int)mLines.size(); }
+	int GetTotalLines() const { return mSuspended ? mSuspendedLineCount : (int)mLines.size(); }
 	bool IsOverwrite() const { return mOverwrite; }
 
 	void SetReadOnly(bool aValue);
@@ -227,6 +303,10 @@ public:
 	void SetTabSize(int aValue);
 	inline int GetTabSize() const { return mTabSize; }
 
+	// The oldest undo history is dropped once it takes more than this many bytes
+	inline void SetUndoMemoryLimit(size_t aValue) { mUndoMemoryLimit = aValue; }
+	inline size_t GetUndoMemoryLimit() const { return mUndoMemoryLimit; }
+
 	void InsertText(const std::string& aValue);
 	void InsertText(const char* aValue);
 
@@ -256,6 +336,41 @@ public:
 	void Undo(int aSteps = 1);
 	void Redo(int aSteps = 1);
 
+	// Find/replace. Matches are never empty and never span lines, regular expressions run in linear time (see FindPattern).
+	bool SetFindPattern(const std::string& aPattern, bool aRegex = false, bool aCaseSensitive = false);
+	const std::string& GetFindError() const { return mFindError; }
+	bool FindNext(bool aBackwards = false);
+	bool ReplaceNext(const std::string& aReplacement);
+	int ReplaceAll(const std::string& aReplacement);
+	int GetFindMatchCount();            // -1 while a large text is still being counted
+
+	// Moves the cursor to the bracket or block keyword matching the one at the cursor, returns false if there is none
+	bool MoveToMatchingBracket(bool aSelect = false);
+
+	// Folding hides the lines between the opener and the closer of a block spanning three lines or more. Folds stay on
+	// their lines through edits, and open again when the cursor is moved into them.
+	bool Fold(int aLine);               // the first such block opened on aLine, false if there is none
+	bool Unfold(int aLine);             // the fold starting on aLine
+	void UnfoldAll();
+	bool IsFolded(int aLine) const;
+	bool IsLineVisible(int aLine) const;
+
+	// Overview of the whole file to the right of the text, drawn from a texture that only gets the changed lines redrawn
+	// (see TextureHandler). Click or drag on it to scroll.
+	void SetShowMinimap(bool aValue) { mShowMinimap = aValue; }
+	bool IsShowingMinimap() const { return mShowMinimap; }
+	static void SetTextureHandler(const TextureHandler& aHandler);
+	// Frees the texture now, on the thread that owns the renderer. The next Render() makes a new one if there is a handler.
+	void ReleaseMinimap();
+
+	// For an editor that isn't shown: packs the text into a plain string plus run-length coded colors and frees
+	// everything rebuilt on demand (glyph positions, cached geometry, the find snapshot). Resume() restores the
+	// glyphs with their colors and lexer states, so nothing has to be colorized again. Render() resumes by itself.
+	// While suspended only GetText(), GetTotalLines(), SetText() and Resume() may be used.
+	void Suspend();
+	void Resume();
+	bool IsSuspended() const { return mSuspended; }
+
 	static const Palette& GetDarkPalette();
 	static const Palette& GetLightPalette();
 	static const Palette& GetRetroBluePalette();
@@ -288,9 +403,6 @@ private:
 			TextEditor::EditorState& aBefore,
 			TextEditor::EditorState& aAfter);
 
-		void Undo(TextEditor* aEditor);
-		void Redo(TextEditor* aEditor);
-
 		std::string mAdded;
 		Coordinates mAddedStart;
 		Coordinates mAddedEnd;
@@ -303,13 +415,289 @@ private:
 		EditorState mAfter;
 	};
 
-	typedef std::vector<UndoRecord> UndoBuffer;
+	// An UndoRecord as kept in the history, its text lives in mUndoText
+	struct UndoEntry
+	{
+		size_t mText;                       // offset of the added text in mUndoText, followed by the removed text, both zero terminated
+		size_t mAddedLength;
+		size_t mRemovedLength;
+		Coordinates mAddedStart;
+		Coordinates mAddedEnd;
+		Coordinates mRemovedStart;
+		Coordinates mRemovedEnd;
+		EditorState mBefore;
+		EditorState mAfter;
+
+		void Undo(TextEditor* aEditor) const;
+		void Redo(TextEditor* aEditor) const;
+	};
+
+	typedef std::deque<UndoEntry> UndoBuffer;
 
 	void ProcessInputs();
 	void Colorize(int aFromLine = 0, int aCount = -1);
 	void ColorizeRange(int aFromLine = 0, int aToLine = 0);
 	void ColorizeInternal();
+	bool UpdateLineState(int aLine, int aState);
+
+	// Snapshot of a line range lexed on the colorizer thread, for stateful tokenizers
+	struct ColorizeJob
+	{
+		uint64_t mVersion;
+		int mFromLine;
+		int mStartState;
+		std::shared_ptr<const LanguageDefinition> mLanguage;
+		std::string mText;                  // bytes of the lines, without line breaks
+		std::vector<int> mLineEnds;         // end offset of each line in mText
+		std::vector<PaletteIndex> mColors;  // result: one per byte of mText
+		std::vector<int> mEndStates;        // result: lexer state at the end of each line
+
+		void Run();
+	};
+	void SubmitColorizeJob();
+	void ShiftColorizeJob(int aIndex, int aCount);
+	void ApplyColorizeJob(const ColorizeJob& aJob);
+	bool ApplyFinishedColorizeJob();
+	void DiscardSuspended();
+	void ColorizerThread();
 	float TextDistanceToLineStart(const Coordinates& aFrom) const;
+	const std::vector<float>& GetGlyphPositions(int aLine) const;
+	bool IsCompleting() const;
+	void UpdateCompletions();
+	void AcceptCompletion();
+	void RenderCompletions(const ImVec2& aOrigin);
+
+	// A literal string, or a regular expression run as a Pike VM (a Thompson NFA simulation) so matching never backtracks
+	class FindPattern
+	{
+	public:
+		bool Compile(const std::string& aPattern, bool aRegex, bool aCaseSensitive, std::string& aError);
+		bool IsEmpty() const { return mLiteral.empty() && mProgram.empty(); }
+		// First match in [aFrom, aEnd), lines are separated by '\n'. aBegin is where the text starts, for ^ and \b.
+		bool Search(const char* aBegin, const char* aEnd, const char* aFrom, const char*& aMatchBegin, const char*& aMatchEnd) const;
+		// Returns -1 when cancelled
+		int Count(const char* aBegin, const char* aEnd, const std::atomic<bool>* aCancel) const;
+
+	private:
+		struct Node;
+		class Parser;
+		typedef std::array<uint32_t, 8> CharSet;
+
+		enum class Op : uint8_t { Char, Set, Any, Split, Jump, LineStart, LineEnd, WordBoundary, NotWordBoundary, Match };
+		struct Instruction
+		{
+			Op mOp;
+			int mX;                         // the char, the index in mSets or the (preferred) target
+			int mY;                         // the other target of a Split
+		};
+		struct Thread
+		{
+			int mPc;
+			const char* mStart;
+		};
+
+		bool Emit(const Node& aNode);
+		void AddThread(std::vector<Thread>& aList, int aPc, const char* aStart, const char* aAt, const char* aBegin, const char* aLineEnd) const;
+		bool SearchLine(const char* aBegin, const char* aLineEnd, const char* aFrom, const char*& aMatchBegin, const char*& aMatchEnd) const;
+		bool SearchLiteral(const char* aFrom, const char* aEnd, const char*& aMatchBegin, const char*& aMatchEnd) const;
+		bool IsLiteralAt(const char* aAt) const;
+
+		std::string mLiteral;               // lowercase when not case sensitive
+		bool mCaseSensitive = true;
+		std::vector<Instruction> mProgram;
+		std::vector<CharSet> mSets;
+		CharSet mFirstBytes;                // bytes a match can start with, when mHasFirstBytes
+		bool mHasFirstBytes = false;
+
+		// Scratch space of the VM
+		mutable std::vector<Thread> mThreads, mNextThreads;
+		mutable std::vector<unsigned> mMarks;
+		mutable std::vector<int> mStack;
+		mutable unsigned mGeneration = 0;
+	};
+
+	// The whole text with '\n' line breaks, shared with the threads counting matches and checking diagnostics. Offsets
+	// into the current one map to lines with Lines::FindLine() and GetLineOffset().
+	struct FindText
+	{
+		std::string mText;
+	};
+	const FindText& GetFindText();
+	Coordinates OffsetToCoordinates(int aOffset) const;
+	int CoordinatesToOffset(const Coordinates& aCoordinates) const;
+	void CancelFindCount();
+
+	// The text as of mVersion, checked with the language's diagnose callback on the diagnostics thread
+	struct DiagnoseJob
+	{
+		uint64_t mVersion;
+		std::shared_ptr<const LanguageDefinition> mLanguage;
+		std::shared_ptr<const FindText> mText;
+		std::vector<Diagnostic> mDiagnostics;  // result, sorted by line
+		bool mComplete = false;                // false when cancelled
+	};
+	void UpdateDiagnostics();
+	void ShiftDiagnostics(int aIndex, int aCount);
+	void DiagnoseThread();
+
+	// Brackets and block keywords outside strings and comments, taken from the colors of a line on first use
+	enum BracketKind : uint8_t { BracketParen, BracketSquare, BracketCurly, BracketBlock, BracketKindCount };
+	struct Bracket
+	{
+		int mIndex;                         // glyph index
+		uint8_t mLength;
+		BracketKind mKind;
+		int8_t mDelta;                      // +1 opens, -1 closes, 0 for a block head
+	};
+	struct LineBrackets
+	{
+		bool mValid = false;
+		std::vector<Bracket> mBrackets;
+	};
+	// Depth changes over BracketChunkLines lines, so a match far away is found skipping whole chunks
+	static const int BracketChunkLines = 64;
+	struct BracketChunk
+	{
+		bool mValid = false;
+		int mDelta[BracketKindCount];       // net change over the chunk
+		int mMin[BracketKindCount];         // lowest depth reached going forward from its start, <= 0
+		int mMax[BracketKindCount];         // highest depth reached going backward from its end, >= 0
+	};
+	// A bracket as (line, index into the line's brackets)
+	struct BracketRef
+	{
+		int mLine = -1;
+		int mIndex = -1;
+	};
+	const std::vector<Bracket>& GetLineBrackets(int aLine) const;
+	const BracketChunk& GetBracketChunk(int aChunk) const;
+	void InvalidateBrackets(int aFromLine, int aToLine);
+	void ShiftBrackets(int aIndex);
+	BracketRef FindBracketAt(const Coordinates& aAt) const;
+	BracketRef FindMatchingBracket(const BracketRef& aBracket) const;
+	BracketRef FindBlockHead(const BracketRef& aOpener) const;
+	BracketRef FindBlockBody(const BracketRef& aHead) const;
+	void UpdateBracketHighlights();
+
+	// Lines mStart + 1 to mEnd - 1 are hidden
+	struct FoldedBlock
+	{
+		int mStart;
+		int mEnd;
+	};
+	// The hidden lines [mFrom, mTo) of overlapping folds merged, after mHiddenBefore hidden by the ranges before
+	struct FoldRange
+	{
+		int mFrom;
+		int mTo;
+		int mHiddenBefore;
+	};
+	int GetFoldEnd(int aLine) const;
+	void ShiftFolds(int aIndex, int aCount);
+	void UpdateFoldRanges();
+	void UnfoldAround(int aLine);
+	// Rows are what is on screen, the lines minus the hidden ones. A hidden line is on the row of its fold.
+	int LineToRow(int aLine) const;
+	int RowToLine(int aRow) const;
+	int GetRowCount() const { return (int)mLines.size() - mFoldHidden; }
+
+	// The minimap texture has a pixel per column and two rows per line, or a row for several lines once the file gets
+	// longer than it is high. Groups of lines sharing rows are redrawn when dirty, a budget of glyphs per frame at most.
+	static const int MinimapWidth = 112;
+	static const int MinimapHeight = 2048;
+	static const int MinimapColumns = 106;          // the rest is the stripe marking find matches
+	static const int MinimapGlyphBudget = 256 * 1024;
+	void InvalidateMinimap(int aFromLine, int aToLine);
+	void ShiftMinimap(int aIndex, int aCount);
+	void UpdateMinimap();
+	int DrawMinimapGroup(int aGroup);
+	void RenderMinimap(const ImVec2& aSize);
+
+	// The text as a B+ tree of lines. A leaf holds up to LeafLines lines with their chars and attributes (see
+	// Glyph::GetAttributes()) in two arrays of its own, a branch the line and char counts of its subtrees. Looking up
+	// a line, or the offset of its first char in the text, walks down from the root, going on to the next line doesn't.
+	// Inserting or removing lines only rewrites the leaves and branches on the way, edits within a line only its leaf.
+	class Line;
+	class Lines
+	{
+	public:
+		Lines();
+		~Lines();
+		Lines(const Lines&) = delete;
+		Lines& operator=(const Lines&) = delete;
+
+		int size() const;
+		bool empty() const { return size() == 0; }
+		Line& operator[](int aIndex);
+		const Line& operator[](int aIndex) const;
+		size_t GetCharCount() const;                // line breaks not included
+		size_t GetLineOffset(int aIndex) const;     // of the first char of the line in the text joined with '\n'
+		int FindLine(size_t aOffset) const;         // the line the char at aOffset in that text is on
+
+		void Insert(int aIndex, int aCount);        // empty lines
+		void Insert(int aIndex, const char* aText, const char* aTextEnd);  // a line per '\n' and one more
+		void Erase(int aStart, int aEnd);
+		void Clear();                               // no lines at all, until some are inserted
+
+	private:
+		friend class Line;
+		struct Node;
+		struct Leaf;
+		struct Branch;
+
+		static const int LeafLines = 64;
+		static const int LeafChars = 8192;          // a leaf with more lines than one is split past this too
+		static const int BranchChildren = 32;
+
+		Leaf* FindLeaf(int aIndex, int& aFirst) const;
+		static void AddCounts(Node* aNode, int aLines, ptrdiff_t aChars);
+		void Split(Leaf* aLeaf);
+		void InsertAfter(Node* aNode, std::vector<Node*>& aNodes);
+		void Remove(Node* aNode);
+		void Merge(Leaf* aLeaf);
+		static void Free(Node* aNode);
+
+		Node* mRoot;
+		mutable Leaf* mFinger;                      // the leaf of the last line looked up, where the next lookup starts
+		mutable int mFingerFirst;                   // index of its first line
+	};
+
+	// A line's glyphs are its slice of the arrays of its leaf. They're read by value or through Chars() and Attributes(),
+	// attributes can be written in place, chars are changed with Insert() and Erase(). A reference to a Line stays valid
+	// through edits within lines, not through lines being inserted or removed.
+	class Line
+	{
+	public:
+		Line() = default;
+		Line(Line&&) = default;
+		Line& operator=(Line&&) = default;
+
+		int size() const { return mSize; }
+		bool empty() const { return mSize == 0; }
+		Glyph operator[](int aIndex) const { return Glyph(Chars()[aIndex], Attributes()[aIndex]); }
+		const Char* Chars() const;
+		const uint8_t* Attributes() const;
+		uint8_t* Attributes();
+
+		void Insert(int aIndex, const Char* aChars, int aCount, uint8_t aAttributes = 0);
+		void Insert(int aIndex, const Glyph& aGlyph) { Insert(aIndex, &aGlyph.mChar, 1, aGlyph.GetAttributes()); }
+		void Insert(int aIndex, const Line& aFrom, int aStart, int aEnd);   // with their attributes
+		void Erase(int aStart, int aEnd);
+
+		// Kept by the editor with the line, so they move along when lines are inserted or removed before it
+		int mState = -1;                            // stateful tokenizer state at the end of the line, -1 until it has been lexed
+		mutable std::vector<float> mGlyphPositions; // see GetGlyphPositions(), empty until measured
+		mutable LineBrackets mBrackets;             // see GetLineBrackets()
+
+	private:
+		friend class Lines;
+		size_t Grow(int aIndex, int aCount);
+
+		Lines::Leaf* mLeaf = nullptr;
+		int mStart = 0;                             // of the chars in the leaf
+		int mSize = 0;
+	};
+
 	void EnsureCursorVisible();
 	int GetPageSize() const;
 	std::string GetText(const Coordinates& aStart, const Coordinates& aEnd) const;
@@ -319,6 +707,9 @@ private:
 	void DeleteRange(const Coordinates& aStart, const Coordinates& aEnd);
 	int InsertTextAt(Coordinates& aWhere, const char* aValue);
 	void AddUndo(UndoRecord& aValue);
+	bool MergeUndo(UndoEntry& aLast, const UndoRecord& aValue);
+	void RecordChange(const Coordinates& aAt, size_t aRemoved, const char* aText, size_t aLength);
+	void TrimUndoBuffer();
 	Coordinates ScreenPosToCoordinates(const ImVec2& aPosition) const;
 	Coordinates FindWordStart(const Coordinates& aFrom) const;
 	Coordinates FindWordEnd(const Coordinates& aFrom) const;
@@ -331,6 +722,7 @@ private:
 	void RemoveLine(int aStart, int aEnd);
 	void RemoveLine(int aIndex);
 	Line& InsertLine(int aIndex);
+	int InsertLines(int aIndex, const char* aText, const char* aTextEnd);
 	void EnterCharacter(ImWchar aChar, bool aShift);
 	void Backspace();
 	void DeleteSelection();
@@ -342,11 +734,38 @@ private:
 	void HandleMouseInputs();
 	void Render();
 
+	// Geometry of a visible line, replayed every frame as long as the line and everything it was drawn with stay the same
+	struct RenderCacheLine
+	{
+		bool mValid = false;
+		std::vector<Char> mChars;           // copy of the line the geometry was built from
+		std::vector<uint8_t> mAttributes;
+		ImVec2 mOriginFraction;             // sub-pixel part of the text origin, glyphs are snapped relative to it
+		float mLineNumberWidth = -1.0f;
+		std::vector<ImDrawVert> mVertices;  // relative to the text start of the line
+		std::vector<ImDrawIdx> mIndices;    // relative to the first vertex
+		uint64_t mFindTextVersion = 0;      // mFindMatches are valid for this mTextVersion and mFindPatternVersion
+		uint64_t mFindPatternVersion = 0;
+		std::vector<std::pair<int, int>> mFindMatches;  // glyph index ranges
+		uint64_t mFoldEndVersion = ~(uint64_t)0;        // mFoldEnd is GetFoldEnd() as of this mBracketsVersion
+		int mFoldEnd = -1;
+	};
+	void RenderLineGlyphs(ImDrawList* aDrawList, const Line& aLine, const ImVec2& aTextScreenPos, float aSpaceSize, bool aClip);
+
 	float mLineSpacing;
 	Lines mLines;
+	bool mSuspended;
+	std::string mSuspendedText;         // see Suspend()
+	std::vector<uint8_t> mSuspendedRuns;// (glyph attributes, count) pairs over all glyphs, lines not included
+	std::vector<int> mSuspendedStates;  // Line::mState of each line
+	int mSuspendedLineCount;
 	EditorState mState;
 	UndoBuffer mUndoBuffer;
+	std::string mUndoText;              // append-only, in the order of mUndoBuffer
+	size_t mUndoMemoryLimit;
 	int mUndoIndex;
+	bool mRecordChanges;
+	std::vector<Change> mChanges;
 
 	int mTabSize;
 	bool mOverwrite;
@@ -368,16 +787,84 @@ private:
 
 	Palette mPaletteBase;
 	Palette mPalette;
-	LanguageDefinition mLanguageDefinition;
+	std::shared_ptr<const LanguageDefinition> mLanguageDefinition;
 	RegexList mRegexList;
 
 	bool mCheckComments;
+	uint64_t mTextVersion;              // bumped by Colorize(), which every edit goes through. Results lexed from an older snapshot are discarded.
+	bool mColorizeBusy;                 // a job is queued, running or waiting to be applied
+	int mColorizeJobFrom, mColorizeJobCount;
+	std::thread mColorizeThread;
+	std::mutex mColorizeMutex;          // guards everything below
+	std::condition_variable mColorizeCondition;
+	std::unique_ptr<ColorizeJob> mColorizeJob;
+	std::unique_ptr<ColorizeJob> mColorizeDone;
+	bool mColorizeThreadRunning;
+	bool mColorizeStop;
 	Breakpoints mBreakpoints;
 	ErrorMarkers mErrorMarkers;
 	ImVec2 mCharAdvance;
 	Coordinates mInteractiveStart, mInteractiveEnd;
 	std::string mLineBuffer;
 	uint64_t mStartTime;
+	std::vector<RenderCacheLine> mRenderCache;  // one per visible row, starting at mRenderCacheFirst
+	int mRenderCacheFirst;
+	ImFont* mRenderCacheFont;                   // what the cached geometry was built with
+	float mRenderCacheFontSize;
+	ImTextureID mRenderCacheTexture;
+	int mRenderCacheTabSize;
+	bool mRenderCacheWhitespaces;
+	Palette mRenderCachePalette;
+	mutable ImFont* mGlyphPositionsFont;  // what Line::mGlyphPositions were measured with
+	mutable float mGlyphPositionsFontSize;
+	mutable int mGlyphPositionsTabSize;
+	mutable std::vector<BracketChunk> mBracketChunks;
+	uint64_t mBracketsVersion;          // bumped whenever a line's brackets may have changed
+	std::vector<std::pair<int, std::pair<int, int>>> mBracketHighlights;  // (line, glyph index range) of the bracket at the cursor and its match
+	uint64_t mBracketHighlightsVersion; // mBracketsVersion and cursor mBracketHighlights were found for
+	Coordinates mBracketHighlightsCursor;
+	std::vector<FoldedBlock> mFolds;    // sorted by mStart, may nest
+	std::vector<FoldRange> mFoldRanges;
+	int mFoldHidden;                    // lines hidden in all
+	bool mShowMinimap;
+	ImTextureID mMinimapTexture;
+	std::vector<ImU32> mMinimapPixels;  // MinimapWidth x MinimapHeight, empty until drawn
+	std::vector<uint8_t> mMinimapDirty; // per group of lines
+	int mMinimapLinesPerGroup;          // layout the pixels were drawn in
+	int mMinimapRowsPerGroup;
+	int mMinimapGroups;                 // groups in use
+	int mMinimapUploadStart, mMinimapUploadEnd;  // rows changed since the last upload
+	uint64_t mMinimapPatternVersion;
+	Palette mMinimapPalette;
+	int mMinimapFirstLine, mMinimapLastLine;  // what the text shows, as of the last Render()
+	int mMinimapScrollLine;             // clicked on the minimap, scrolled to by the next Render(); -1 for none
+	FindPattern mFindPattern;
+	std::string mFindError;
+	uint64_t mFindPatternVersion;
+	std::shared_ptr<const FindText> mFindText;
+	uint64_t mFindTextVersion;          // mTextVersion mFindText was taken at
+	std::string mFindLineText;          // scratch copy of a line to highlight
+	uint64_t mFindCountTextVersion, mFindCountPatternVersion;  // what mFindCount is (being) counted for
+	std::atomic<int> mFindCount;
+	std::atomic<bool> mFindCountCancel;
+	std::thread mFindCountThread;
+	std::vector<Diagnostic> mDiagnostics;   // of the last finished check, kept on their lines by edits until the next one finishes
+	uint64_t mDiagnoseVersion;          // mTextVersion the last check was submitted for
+	uint64_t mDiagnoseSeenVersion;      // mTextVersion as of mDiagnoseChangeTime
+	double mDiagnoseChangeTime;
+	bool mDiagnoseBusy;                 // a job is queued, running or waiting to be picked up
+	std::atomic<bool> mDiagnoseCancel;
+	std::thread mDiagnoseThread;
+	std::mutex mDiagnoseMutex;          // guards everything below
+	std::condition_variable mDiagnoseCondition;
+	std::unique_ptr<DiagnoseJob> mDiagnoseJob;
+	std::unique_ptr<DiagnoseJob> mDiagnoseDone;
+	bool mDiagnoseThreadRunning;
+	bool mDiagnoseStop;
+	std::vector<std::pair<std::string, std::string>> mCompletions;  // popup entries (text, detail), empty when it is closed
+	int mCompletionIndex = 0;
+	Coordinates mCompletionStart;       // where the completed name starts
+	Coordinates mCompletionCursor;      // the popup closes as soon as the cursor leaves this
 
 	float mLastClick;
 };
\ No newline at end of file
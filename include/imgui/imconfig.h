@@ -74,6 +74,12 @@
 // The only purpose of this define is if you want force compilation of the stb_truetype backend ALONG with the FreeType backend.
 //#define IMGUI_ENABLE_STB_TRUETYPE
 
+//---- Number of threads rasterizing glyphs when the stb_truetype builder renders the atlas (0 = one per hardware thread, 1 = render on the calling thread only)
+//#define IMGUI_FONT_BUILD_THREADS 0
+
+//---- Disable the SSE2 fast paths (text rendering) and use the scalar code everywhere.
+//#define IMGUI_DISABLE_SSE
+
 //---- Define constructor and implicit cast operators to convert back<>forth between your math types and ImVec2/ImVec4.
 // This will be inlined as part of ImVec2 and ImVec4 class declarations.
 /*
@@ -1655,6 +1655,35 @@ int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char*
     return wanted;
 }
 
+// Skip a run of 7-bit ASCII, which needs no decoding. Text is overwhelmingly ASCII so callers use this to process whole runs at once.
+const char* ImTextFindNonAscii(const char* in_text, const char* in_text_end)
+{
+#ifdef IMGUI_ENABLE_SSE
+    // The top bit of every byte is gathered by a single movemask
+    while (in_text_end - in_text >= 32)
+    {
+        const __m128i block = _mm_or_si128(_mm_loadu_si128((const __m128i*)in_text), _mm_loadu_si128((const __m128i*)(in_text + 16)));
+        if (_mm_movemask_epi8(block) != 0)
+            break;
+        in_text += 32;
+    }
+    if (in_text_end - in_text >= 16 && _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)in_text)) == 0)
+        in_text += 16;
+#else
+    while (in_text_end - in_text >= 8)
+    {
+        ImU64 block;
+        memcpy(&block, in_text, 8);
+        if (block & 0x8080808080808080ULL)
+            break;
+        in_text += 8;
+    }
+#endif
+    while (in_text < in_text_end && (unsigned char)*in_text < 0x80)
+        in_text++;
+    return in_text;
+}
+
 int ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char* in_text, const char* in_text_end, const char** in_text_remaining)
 {
     ImWchar* buf_out = buf;
@@ -1678,6 +1707,16 @@ int ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end)
     int char_count = 0;
     while ((!in_text_end || in_text < in_text_end) && *in_text)
     {
+        if (in_text_end && (unsigned char)*in_text < 0x80)
+        {
+            const char* ascii_end = ImTextFindNonAscii(in_text, in_text_end);
+            const char* zero = (const char*)memchr(in_text, 0, (size_t)(ascii_end - in_text));
+            char_count += (int)((zero ? zero : ascii_end) - in_text);
+            if (zero)
+                break;
+            in_text = ascii_end;
+            continue;
+        }
         unsigned int c;
         in_text += ImTextCharFromUtf8(&c, in_text, in_text_end);
         if (c == 0)
@@ -39,6 +39,14 @@ Index of this file:
 #endif
 
 #include <stdio.h>      // vsnprintf, sscanf, printf
+#include <stdlib.h>     // malloc, free (stb_truetype allocations on font build worker threads)
+#ifndef IMGUI_FONT_BUILD_THREADS
+#define IMGUI_FONT_BUILD_THREADS 0
+#endif
+#if IMGUI_FONT_BUILD_THREADS != 1
+#include <atomic>
+#include <thread>
+#endif
 #if !defined(alloca)
 #if defined(__GLIBC__) || defined(__sun) || defined(__APPLE__) || defined(__NEWLIB__)
 #include <alloca.h>     // alloca (glibc uses <alloca.h>. Note that Cygwin may have _WIN32 defined, so the order matters here)
@@ -138,8 +146,8 @@ namespace IMGUI_STB_NAMESPACE
 #ifdef  IMGUI_ENABLE_STB_TRUETYPE
 #ifndef STB_TRUETYPE_IMPLEMENTATION                         // in case the user already have an implementation in the _same_ compilation unit (e.g. unity builds)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION           // in case the user already have an implementation in another compilation unit
-#define STBTT_malloc(x,u)   ((void)(u), IM_ALLOC(x))
-#define STBTT_free(x,u)     ((void)(u), IM_FREE(x))
+#define STBTT_malloc(x,u)   ((u) ? malloc(x) : IM_ALLOC(x))    // Worker threads rasterizing glyphs pass a non-NULL user context so they don't race on ImGui::MemAlloc()'s allocation counter
+#define STBTT_free(x,u)     ((u) ? free(x) : IM_FREE(x))
 #define STBTT_assert(x)     do { IM_ASSERT(x); } while(0)
 #define STBTT_fmod(x,y)     ImFmod(x,y)
 #define STBTT_sqrt(x)       ImSqrt(x)
@@ -2301,6 +2309,45 @@ static void UnpackBitVectorToFlatIndexList(const ImBitVector* in, ImVector<int>*
                     out->push_back((int)(((it - it_begin) << 5) + bit_n));
 }
 
+// Slice of one source font's glyphs, rasterized as a single unit of work
+struct ImFontBuildRenderJob
+{
+    int                 SrcIndex;
+    int                 GlyphBegin;
+    int                 GlyphEnd;
+};
+
+// Every glyph was given its own (padded) rectangle during packing, so rendering glyphs in any order or from any thread
+// writes disjoint pixels and produces the exact same texture as rendering them serially.
+static void ImFontAtlasBuildRenderJob(ImFontAtlas* atlas, ImFontBuildSrcData* src_tmp_array, const stbtt_pack_context& spc, const ImFontBuildRenderJob& job, bool on_worker_thread)
+{
+    ImFontConfig& cfg = atlas->ConfigData[job.SrcIndex];
+    ImFontBuildSrcData& src_tmp = src_tmp_array[job.SrcIndex];
+
+    // stbtt_PackFontRangesRenderIntoRects() temporarily writes the oversampling settings into the pack context, so each job works on its own copy
+    static char worker_alloc_tag;
+    stbtt_pack_context job_spc = spc;
+    stbtt_fontinfo job_font_info = src_tmp.FontInfo;
+    job_font_info.userdata = on_worker_thread ? &worker_alloc_tag : NULL;
+
+    stbtt_pack_range job_range = src_tmp.PackRange;
+    job_range.array_of_unicode_codepoints += job.GlyphBegin;
+    job_range.chardata_for_range += job.GlyphBegin;
+    job_range.num_chars = job.GlyphEnd - job.GlyphBegin;
+    stbtt_PackFontRangesRenderIntoRects(&job_spc, &job_font_info, &job_range, 1, src_tmp.Rects + job.GlyphBegin);
+
+    // Apply multiply operator
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        stbrp_rect* r = &src_tmp.Rects[job.GlyphBegin];
+        for (int glyph_i = job.GlyphBegin; glyph_i < job.GlyphEnd; glyph_i++, r++)
+            if (r->was_packed)
+                ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+    }
+}
+
 static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
@@ -2485,27 +2532,48 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     spc.height = atlas->TexHeight;
 
     // 8. Render/rasterize font characters into the texture
+    // Glyphs are split into fixed-size jobs, handed out to worker threads through an atomic counter.
+    const int GLYPHS_PER_JOB = 64;
+    ImVector<ImFontBuildRenderJob> render_jobs;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontConfig& cfg = atlas->ConfigData[src_i];
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbtt_PackFontRangesRenderIntoRects(&spc, &src_tmp.FontInfo, &src_tmp.PackRange, 1, src_tmp.Rects);
+        for (int glyph_i = 0; glyph_i < src_tmp_array[src_i].GlyphsCount; glyph_i += GLYPHS_PER_JOB)
+        {
+            ImFontBuildRenderJob job = { src_i, glyph_i, ImMin(glyph_i + GLYPHS_PER_JOB, src_tmp_array[src_i].GlyphsCount) };
+            render_jobs.push_back(job);
+        }
 
-        // Apply multiply operator
-        if (cfg.RasterizerMultiply != 1.0f)
+    int threads_count = 1;
+#if IMGUI_FONT_BUILD_THREADS != 1
+    threads_count = (IMGUI_FONT_BUILD_THREADS > 0) ? IMGUI_FONT_BUILD_THREADS : (int)std::thread::hardware_concurrency();
+    threads_count = ImClamp(threads_count, 1, render_jobs.Size);
+#endif
+    if (threads_count <= 1)
+    {
+        for (int job_i = 0; job_i < render_jobs.Size; job_i++)
+            ImFontAtlasBuildRenderJob(atlas, src_tmp_array.Data, spc, render_jobs[job_i], false);
+    }
+#if IMGUI_FONT_BUILD_THREADS != 1
+    else
+    {
+        std::atomic<int> next_job(0);
+        auto worker = [&]()
         {
-            unsigned char multiply_table[256];
-            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
-            stbrp_rect* r = &src_tmp.Rects[0];
-            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++, r++)
-                if (r->was_packed)
-                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+            for (int job_i = next_job++; job_i < render_jobs.Size; job_i = next_job++)
+                ImFontAtlasBuildRenderJob(atlas, src_tmp_array.Data, spc, render_jobs[job_i], true);
+        };
+        ImVector<std::thread*> workers;
+        for (int thread_n = 1; thread_n < threads_count; thread_n++)
+            workers.push_back(IM_NEW(std::thread)(worker));
+        worker();
+        for (int thread_n = 0; thread_n < workers.Size; thread_n++)
+        {
+            workers[thread_n]->join();
+            IM_DELETE(workers[thread_n]);
         }
-        src_tmp.Rects = NULL;
     }
+#endif
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+        src_tmp_array[src_i].Rects = NULL;
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -3389,9 +3457,38 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
 
+    // ASCII runs are measured without going through the UTF-8 decoder
+    const bool ascii_fast_path = !word_wrap_enabled && IndexAdvanceX.Size >= 0x80;
+
     const char* s = text_begin;
     while (s < text_end)
     {
+        if (ascii_fast_path && (unsigned char)*s < 0x80)
+        {
+            const char* run_end = ImTextFindNonAscii(s, text_end);
+            for (; s < run_end; s++)
+            {
+                const unsigned int c = (unsigned char)*s;
+                if (c == '\n')
+                {
+                    text_size.x = ImMax(text_size.x, line_width);
+                    text_size.y += line_height;
+                    line_width = 0.0f;
+                    continue;
+                }
+                if (c == '\r')
+                    continue;
+
+                const float char_width = IndexAdvanceX.Data[c] * scale;
+                if (line_width + char_width >= max_width)
+                    break;
+                line_width += char_width;
+            }
+            if (s < run_end) // Reached max_width
+                break;
+            continue;
+        }
+
         if (word_wrap_enabled)
         {
             // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
@@ -3540,8 +3637,71 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
 
     const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
 
+#if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+    // Runs of ASCII take a batched path when nothing needs per-character handling (wrapping, fine clipping).
+    IM_STATIC_ASSERT(IM_OFFSETOF(ImDrawVert, uv) == IM_OFFSETOF(ImDrawVert, pos) + 8);
+    IM_STATIC_ASSERT(IM_OFFSETOF(ImFontGlyph, U0) == IM_OFFSETOF(ImFontGlyph, X0) + 16);
+    const bool ascii_batch = !word_wrap_enabled && !cpu_fine_clip && IndexLookup.Size >= 0x80;
+    const __m128 scale_4 = _mm_set1_ps(scale);
+#endif
+
     while (s < text_end)
     {
+#if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+        // An ASCII run needs no UTF-8 decoding: find its end in bulk, then compute each quad as (x1,y1,x2,y2) and (u1,v1,u2,v2) registers written with 16-byte stores.
+        // Uses the same float operations in the same order as the scalar path below, so the output is bit-identical.
+        if (ascii_batch && (unsigned char)*s < 0x80)
+        {
+            const char* run_end = ImTextFindNonAscii(s, text_end);
+            for (; s < run_end; s++)
+            {
+                const unsigned int c = (unsigned char)*s;
+                if (c == '\n')
+                {
+                    x = pos.x;
+                    y += line_height;
+                    if (y > clip_rect.w)
+                        break;
+                    continue;
+                }
+                if (c == '\r')
+                    continue;
+
+                const ImWchar glyph_idx = IndexLookup.Data[c];
+                const ImFontGlyph* glyph = (glyph_idx == (ImWchar)-1) ? FallbackGlyph : &Glyphs.Data[glyph_idx];
+                if (glyph == NULL)
+                    continue;
+
+                const float char_width = glyph->AdvanceX * scale;
+                if (glyph->Visible)
+                {
+                    const __m128 p = _mm_add_ps(_mm_setr_ps(x, y, x, y), _mm_mul_ps(_mm_loadu_ps(&glyph->X0), scale_4));
+                    const float x1 = _mm_cvtss_f32(p);
+                    const float x2 = _mm_cvtss_f32(_mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)));
+                    if (x1 <= clip_rect.z && x2 >= clip_rect.x)
+                    {
+                        const __m128 uv = _mm_loadu_ps(&glyph->U0);
+                        const ImU32 glyph_col = glyph->Colored ? col_untinted : col;
+                        idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+                        idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
+                        _mm_storeu_ps(&vtx_write[0].pos.x, _mm_movelh_ps(p, uv));                           // x1 y1 u1 v1
+                        _mm_storeu_ps(&vtx_write[1].pos.x, _mm_shuffle_ps(p, uv, _MM_SHUFFLE(1, 2, 1, 2))); // x2 y1 u2 v1
+                        _mm_storeu_ps(&vtx_write[2].pos.x, _mm_movehl_ps(uv, p));                           // x2 y2 u2 v2
+                        _mm_storeu_ps(&vtx_write[3].pos.x, _mm_shuffle_ps(p, uv, _MM_SHUFFLE(3, 0, 3, 0))); // x1 y2 u1 v2
+                        vtx_write[0].col = vtx_write[1].col = vtx_write[2].col = vtx_write[3].col = glyph_col;
+                        vtx_write += 4;
+                        vtx_current_idx += 4;
+                        idx_write += 6;
+                    }
+                }
+                x += char_width;
+            }
+            if (s < run_end) // Went past the bottom of the clip rect
+                break;
+            continue;
+        }
+#endif
+
         if (word_wrap_enabled)
         {
             // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
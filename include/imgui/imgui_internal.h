@@ -90,6 +90,12 @@ Index of this file:
 #define IMGUI_ENABLE_STB_TRUETYPE
 #endif
 
+// Enable SSE2 intrinsics if available (always the case on x64). Define IMGUI_DISABLE_SSE to force the scalar code paths.
+#if (defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(IMGUI_DISABLE_SSE)
+#define IMGUI_ENABLE_SSE
+#include <emmintrin.h>
+#endif
+
 //-----------------------------------------------------------------------------
 // [SECTION] Forward declarations
 //-----------------------------------------------------------------------------
@@ -309,6 +315,7 @@ IMGUI_API int           ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char
 IMGUI_API int           ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end);                            // return number of UTF-8 code-points (NOT bytes count)
 IMGUI_API int           ImTextCountUtf8BytesFromChar(const char* in_text, const char* in_text_end);                        // return number of bytes to express one char in UTF-8
 IMGUI_API int           ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_end);                   // return number of bytes to express string in UTF-8
+IMGUI_API const char*   ImTextFindNonAscii(const char* in_text, const char* in_text_end);                                  // return pointer to the first byte >= 0x80 (or in_text_end). Checks 16 bytes per instruction with SSE2
 
 // Helpers: ImVec2/ImVec4 operators
 // We are keeping those disabled by default so they don't leak in user space, to allow user enabling implicit cast operators between ImVec2 and their own types (using IM_VEC2_CLASS_EXTRA etc.)
@@ -0,0 +1,446 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <imgui/imgui.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "executor.h"
+
+// Local endpoint for running scripts from other programs: a named pipe, or a Unix socket in builds without _WIN32.
+// A client writes requests, each a RequestHeader followed by the script, and gets a ResponseHeader back for each one
+// once it ran, followed by the error if there was one. Requests can be pipelined, responses come back in the same
+// order. Every client has a thread that reads scripts straight into the job that runs them, and writes out the
+// responses the game thread queued for it whenever it wakes.
+namespace Ipc {
+	const char* const PipeName = "\\\\.\\pipe\\glua-executor";
+	const ImU32 MaxScriptSize = 64 * 1024 * 1024;
+
+	enum Realm : ImU32 {
+		RealmSelected,      // whichever the menu checkbox says
+		RealmClient,
+		RealmMenu,
+	};
+
+	enum Status : ImU32 {
+		StatusRan,
+		StatusError,        // the Lua error follows
+		StatusRejected,     // too big or an unknown realm, the connection is closed after it
+	};
+
+	struct RequestHeader {
+		ImU32 id;           // the client's own, echoed in the response
+		ImU32 realm;
+		ImU32 size;
+	};
+
+	struct ResponseHeader {
+		ImU32 id;
+		ImU32 status;
+		ImU32 size;
+	};
+
+	// A request still waiting for its response
+	struct Pending {
+		ImU32 id;
+		const char* rejection;          // set for one that was turned away, it's answered once everything before it is
+	};
+
+	struct Connection {
+		int id;
+		std::mutex mutex;               // guards the two below
+		std::vector<char> outbox;       // responses waiting to be written
+		std::deque<Pending> inFlight;   // requests with jobs still queued or running, in order
+		std::atomic<bool> queued{ false };  // the outbox got something since the last flush, and the thread was woken once for it
+		std::atomic<bool> finished{ false };
+#ifdef _WIN32
+		HANDLE pipe;
+		HANDLE wake = CreateEventA(NULL, FALSE, FALSE, NULL);
+		HANDLE readEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+		HANDLE writeEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+		~Connection() {
+			CloseHandle(wake);
+			CloseHandle(readEvent);
+			CloseHandle(writeEvent);
+		}
+#else
+		int socket;
+		int wakePipe[2] = { -1, -1 };
+
+		~Connection() {
+			close(wakePipe[0]);
+			close(wakePipe[1]);
+		}
+#endif
+	};
+
+	std::mutex mutex;           // guards connections
+	std::vector<std::shared_ptr<Connection>> connections;
+	std::atomic<bool> stopping(false);
+	std::thread listener;
+	int nextId = 1;
+#ifdef _WIN32
+	HANDLE stopEvent = NULL;
+#else
+	int stopPipe[2] = { -1, -1 };
+#endif
+	std::string endpoint;       // pipe name, or socket path
+
+	void Queue(Connection& connection, ImU32 id, Status status, const char* message, size_t size) {
+		ResponseHeader header = { id, status, (ImU32)size };
+		connection.outbox.insert(connection.outbox.end(), (const char*)&header, (const char*)&header + sizeof(header));
+		connection.outbox.insert(connection.outbox.end(), message, message + size);
+	}
+
+#ifdef _WIN32
+	void Wake(Connection& connection) {
+		SetEvent(connection.wake);
+	}
+
+	// Waits for overlapped I/O to finish, cancelling it if the endpoint is stopped first
+	bool Complete(Connection& connection, OVERLAPPED& overlapped, DWORD& bytes) {
+		HANDLE events[2] = { overlapped.hEvent, stopEvent };
+		if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+			CancelIoEx(connection.pipe, &overlapped);
+		return GetOverlappedResult(connection.pipe, &overlapped, &bytes, TRUE) && !stopping;
+	}
+
+	bool Flush(Connection& connection, std::vector<char>& buffer) {
+		buffer.clear();
+		{
+			std::lock_guard<std::mutex> lock(connection.mutex);
+			connection.queued = false;
+			buffer.swap(connection.outbox);
+		}
+		for (size_t written = 0; written < buffer.size();) {
+			OVERLAPPED overlapped = {};
+			overlapped.hEvent = connection.writeEvent;
+			DWORD bytes = 0;
+			if (!WriteFile(connection.pipe, buffer.data() + written, (DWORD)(buffer.size() - written), &bytes, &overlapped) &&
+				(GetLastError() != ERROR_IO_PENDING || !Complete(connection, overlapped, bytes)))
+				return false;
+			written += bytes;
+		}
+		return true;
+	}
+
+	// Reads exactly size bytes into out, writing queued responses whenever the game thread adds some
+	bool Receive(Connection& connection, char* out, size_t size, std::vector<char>& buffer) {
+		if (connection.queued && !Flush(connection, buffer))
+			return false;
+
+		for (size_t received = 0; received < size;) {
+			OVERLAPPED overlapped = {};
+			overlapped.hEvent = connection.readEvent;
+			DWORD bytes = 0;
+			DWORD chunk = (DWORD)std::min<size_t>(size - received, 1 << 30);
+			if (!ReadFile(connection.pipe, out + received, chunk, &bytes, &overlapped)) {
+				if (GetLastError() != ERROR_IO_PENDING)
+					return false;
+				HANDLE events[3] = { connection.readEvent, connection.wake, stopEvent };
+				for (;;) {
+					DWORD signaled = WaitForMultipleObjects(3, events, FALSE, INFINITE);
+					if (signaled == WAIT_OBJECT_0)
+						break;
+					if (signaled != WAIT_OBJECT_0 + 1 || !Flush(connection, buffer)) {
+						CancelIoEx(connection.pipe, &overlapped);
+						GetOverlappedResult(connection.pipe, &overlapped, &bytes, TRUE);
+						return false;
+					}
+				}
+				if (!GetOverlappedResult(connection.pipe, &overlapped, &bytes, FALSE))
+					return false;
+			}
+			if (bytes == 0)
+				return false;
+			received += bytes;
+		}
+		return true;
+	}
+
+	// After the client stopped sending, until the responses to what it sent are written
+	void Drain(Connection& connection, std::vector<char>& buffer) {
+		HANDLE events[2] = { connection.wake, stopEvent };
+		for (;;) {
+			if (!Flush(connection, buffer))
+				return;
+			{
+				std::lock_guard<std::mutex> lock(connection.mutex);
+				if (connection.inFlight.empty() && connection.outbox.empty())
+					return;
+			}
+			if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+				return;
+		}
+	}
+#else
+	void Wake(Connection& connection) {
+		char byte = 0;
+		(void)!write(connection.wakePipe[1], &byte, 1);
+	}
+
+	bool Flush(Connection& connection, std::vector<char>& buffer) {
+		buffer.clear();
+		{
+			std::lock_guard<std::mutex> lock(connection.mutex);
+			connection.queued = false;
+			buffer.swap(connection.outbox);
+		}
+		for (size_t written = 0; written < buffer.size();) {
+			ssize_t bytes = send(connection.socket, buffer.data() + written, buffer.size() - written, MSG_NOSIGNAL);
+			if (bytes <= 0)
+				return false;
+			written += bytes;
+		}
+		return true;
+	}
+
+	// Sleeps until the socket has data or the thread is woken, which also drains the wake pipe
+	bool Wait(Connection& connection, bool watchSocket) {
+		pollfd fds[3] = { { stopPipe[0], POLLIN, 0 }, { connection.wakePipe[0], POLLIN, 0 }, { connection.socket, POLLIN, 0 } };
+		if (poll(fds, watchSocket ? 3 : 2, -1) < 0 || fds[0].revents || stopping)
+			return false;
+		char drain[64];
+		if (fds[1].revents)
+			while (read(connection.wakePipe[0], drain, sizeof(drain)) > 0);
+		return true;
+	}
+
+	// Only sleeps once the socket runs dry, a client streaming requests costs a recv per header and per script
+	bool Receive(Connection& connection, char* out, size_t size, std::vector<char>& buffer) {
+		for (size_t received = 0; received < size;) {
+			if (connection.queued && !Flush(connection, buffer))
+				return false;
+			ssize_t bytes = recv(connection.socket, out + received, size - received, MSG_DONTWAIT);
+			if (bytes > 0)
+				received += bytes;
+			else if (bytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK) || !Wait(connection, true))
+				return false;
+		}
+		return true;
+	}
+
+	// The client may only have shut down its sending side, so the socket stays writable but isn't polled any more
+	void Drain(Connection& connection, std::vector<char>& buffer) {
+		for (;;) {
+			if (!Flush(connection, buffer))
+				return;
+			{
+				std::lock_guard<std::mutex> lock(connection.mutex);
+				if (connection.inFlight.empty() && connection.outbox.empty())
+					return;
+			}
+			if (!Wait(connection, false))
+				return;
+		}
+	}
+#endif
+
+	// Job::done for submitted scripts, on the game thread
+	void Reply(const Executor::Job& job, const char* error) {
+		std::shared_ptr<Connection> connection;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& c : connections) {
+				if (c->id == job.tag)
+					connection = c;
+			}
+		}
+		if (!connection)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(connection->mutex);
+			if (connection->inFlight.empty())
+				return;
+			Queue(*connection, connection->inFlight.front().id, error ? StatusError : StatusRan, error, error ? strlen(error) : 0);
+			connection->inFlight.pop_front();
+			for (; !connection->inFlight.empty() && connection->inFlight.front().rejection; connection->inFlight.pop_front()) {
+				auto& rejected = connection->inFlight.front();
+				Queue(*connection, rejected.id, StatusRejected, rejected.rejection, strlen(rejected.rejection));
+			}
+		}
+		// A thread that hasn't flushed since the last wake will pick this up with it
+		if (!connection->queued.exchange(true))
+			Wake(*connection);
+	}
+
+	void Serve(std::shared_ptr<Connection> connection) {
+		std::vector<char> buffer;
+		for (;;) {
+			RequestHeader header;
+			if (!Receive(*connection, (char*)&header, sizeof(header), buffer))
+				break;
+			if (header.size > MaxScriptSize || header.realm > RealmMenu) {
+				const char* message = header.size > MaxScriptSize ? "Script too large" : "Unknown realm";
+				{
+					// Responses keep the order of the requests, the ones before it may still be running
+					std::lock_guard<std::mutex> lock(connection->mutex);
+					if (connection->inFlight.empty())
+						Queue(*connection, header.id, StatusRejected, message, strlen(message));
+					else
+						connection->inFlight.push_back({ header.id, message });
+				}
+				break;
+			}
+
+			// Read straight into the job's buffer, which is moved the rest of the way to the game thread
+			Executor::Job job;
+			job.code.resize(header.size);
+			if (header.size > 0 && !Receive(*connection, &job.code[0], header.size, buffer))
+				break;
+			job.menuRealm = header.realm == RealmSelected ? Globals::menuRealm.load() : header.realm == RealmMenu;
+			job.tag = connection->id;
+			job.done = Reply;
+			{
+				std::lock_guard<std::mutex> lock(connection->mutex);
+				connection->inFlight.push_back({ header.id, nullptr });
+			}
+			Executor::Submit(std::move(job));
+		}
+
+		Drain(*connection, buffer);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			connections.erase(std::find(connections.begin(), connections.end(), connection));
+		}
+		// Closed here rather than when the last reference goes, which may not be until the next client connects
+#ifdef _WIN32
+		CloseHandle(connection->pipe);
+#else
+		close(connection->socket);
+#endif
+		connection->finished = true;
+	}
+
+	// Accepts clients until stopped, each gets a thread. Finished ones are joined when the next client connects.
+	void Listen() {
+		std::vector<std::pair<std::shared_ptr<Connection>, std::thread>> clients;
+		auto reap = [&](bool all) {
+			for (size_t i = 0; i < clients.size();) {
+				if (!all && !clients[i].first->finished) {
+					i++;
+					continue;
+				}
+				clients[i].second.join();
+				clients.erase(clients.begin() + i);
+			}
+		};
+
+#ifdef _WIN32
+		HANDLE connectEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+		bool first = true;
+		while (!stopping) {
+			HANDLE pipe = CreateNamedPipeA(endpoint.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+				PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, PIPE_UNLIMITED_INSTANCES, 64 * 1024, 64 * 1024, 0, NULL);
+			if (pipe == INVALID_HANDLE_VALUE)
+				break;
+			first = false;
+
+			OVERLAPPED overlapped = {};
+			overlapped.hEvent = connectEvent;
+			ResetEvent(connectEvent);
+			bool connected = ConnectNamedPipe(pipe, &overlapped) != 0 || GetLastError() == ERROR_PIPE_CONNECTED;
+			if (!connected && GetLastError() == ERROR_IO_PENDING) {
+				HANDLE events[2] = { connectEvent, stopEvent };
+				if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+					CancelIoEx(pipe, &overlapped);
+				DWORD bytes;
+				connected = GetOverlappedResult(pipe, &overlapped, &bytes, TRUE) != 0 && !stopping;
+			}
+			if (!connected) {
+				CloseHandle(pipe);
+				continue;
+			}
+
+			auto connection = std::make_shared<Connection>();
+			connection->pipe = pipe;
+#else
+		int server = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, endpoint.c_str(), sizeof(address.sun_path) - 1);
+		unlink(endpoint.c_str());
+		if (server < 0 || bind(server, (sockaddr*)&address, sizeof(address)) != 0 || listen(server, 16) != 0) {
+			close(server);
+			return;
+		}
+		while (!stopping) {
+			pollfd fds[2] = { { server, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+			if (poll(fds, 2, -1) < 0 || fds[1].revents)
+				break;
+			int client = accept4(server, NULL, NULL, SOCK_CLOEXEC);
+			if (client < 0)
+				continue;
+
+			auto connection = std::make_shared<Connection>();
+			connection->socket = client;
+			if (pipe(connection->wakePipe) == 0) {
+				fcntl(connection->wakePipe[0], F_SETFL, O_NONBLOCK);
+				fcntl(connection->wakePipe[1], F_SETFL, O_NONBLOCK);
+			}
+#endif
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				connection->id = nextId++;
+				connections.push_back(connection);
+			}
+			reap(false);
+			clients.emplace_back(connection, std::thread(Serve, connection));
+		}
+
+#ifdef _WIN32
+		CloseHandle(connectEvent);
+#else
+		close(server);
+		unlink(endpoint.c_str());
+#endif
+		reap(true);
+	}
+
+	void Start(const std::string& name) {
+		endpoint = name;
+#ifdef _WIN32
+		stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+#else
+		if (pipe(stopPipe) != 0)
+			return;
+#endif
+		listener = std::thread(Listen);
+	}
+
+	// Clients still connected are dropped, responses they haven't been sent are lost
+	void Stop() {
+		if (!listener.joinable())
+			return;
+		stopping = true;
+#ifdef _WIN32
+		SetEvent(stopEvent);
+		listener.join();
+		CloseHandle(stopEvent);
+#else
+		(void)!write(stopPipe[1], "", 1);
+		{
+			// Unblocks threads writing to clients that stopped reading
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& connection : connections)
+				shutdown(connection->socket, SHUT_RDWR);
+		}
+		listener.join();
+		close(stopPipe[0]);
+		close(stopPipe[1]);
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,338 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h>
+#include "lz4.h"
+#include "storage.h"
+
+// Saved scripts, kept in one append-only file of LZ4 compressed records. Saving under an existing name or deleting
+// appends a record that supersedes the old one, and the file is rewritten without the dead records once they take up
+// more than half of it. Only names and tags are held in memory, texts are read from the file when loaded.
+namespace Library {
+	const ImU32 Magic = 0x42494c47; // "GLIB"
+	const ImU32 Version = 1;
+	const size_t CompactMinimum = 64 * 1024;
+
+	enum RecordKind : ImU32 {
+		RecordSave,
+		RecordDelete,
+	};
+
+	struct FileHeader {
+		ImU32 magic;
+		ImU32 version;
+	};
+
+	// Followed by the name, the tags and the compressed text
+	struct RecordHeader {
+		ImU32 hash;             // of the rest of the header and everything after it
+		ImU32 kind;
+		ImU32 nameLength;
+		ImU32 tagsLength;
+		ImU32 packedSize;
+		ImU32 textSize;
+	};
+
+	struct Entry {
+		std::string name;
+		std::string tags;
+		size_t recordOffset;    // where its record starts in the file
+		ImU32 recordSize;
+		ImU32 packedSize;
+		ImU32 textSize;
+		bool live;              // false once saved over or deleted, the slot stays until the next compaction
+	};
+
+	std::string path;
+	std::vector<Entry> entries;
+	std::unordered_map<std::string, int> byName;                // live entries only
+	std::unordered_map<ImU32, std::vector<int>> trigrams;       // entries each lowercase trigram of a name or tag occurs in
+	size_t fileSize = 0;    // end of the last good record, anything after it is a torn write and gets overwritten
+	size_t liveBytes = 0;
+	int version = 0;        // bumped on every change, search results are stale after it
+
+	ImU32 RecordHash(const RecordHeader& header, const char* payload) {
+		ImU32 hash = ImHashData(&header.kind, sizeof(RecordHeader) - sizeof(header.hash));
+		return ImHashData(payload, (size_t)header.nameLength + header.tagsLength + header.packedSize, hash);
+	}
+
+	char Lower(char c) {
+		return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+	}
+
+	bool IsSeparator(char c) {
+		return c == ' ' || c == '\t' || c == ',' || c == '_' || c == '.' || c == '-' || c == '/';
+	}
+
+	// Calls f for each trigram of each word with a space in front, so the start of a word is a gram of its own and
+	// "hok" still shares " ho" with "hook". Words too short for a trigram are padded at the end as well.
+	template <typename F>
+	void ForEachTrigram(const std::string& text, F f) {
+		for (size_t i = 0; i < text.size();) {
+			while (i < text.size() && IsSeparator(text[i]))
+				i++;
+			size_t wordEnd = i;
+			while (wordEnd < text.size() && !IsSeparator(text[wordEnd]))
+				wordEnd++;
+			if (wordEnd > i) {
+				ImU32 gram = ' ';
+				for (size_t j = i; j < wordEnd || j < i + 2; j++) {
+					gram = (gram << 8 | (unsigned char)(j < wordEnd ? Lower(text[j]) : ' ')) & 0xffffff;
+					if (j >= i + 1)
+						f(gram);
+				}
+			}
+			i = wordEnd;
+		}
+	}
+
+	void IndexEntry(int index) {
+		std::vector<ImU32> grams;
+		ForEachTrigram(entries[index].name + " " + entries[index].tags, [&](ImU32 gram) { grams.push_back(gram); });
+		std::sort(grams.begin(), grams.end());
+		grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+		for (ImU32 gram : grams)
+			trigrams[gram].push_back(index);
+	}
+
+	// Applies a record read from or just written to the file
+	void Apply(const RecordHeader& header, const char* payload, size_t offset) {
+		std::string name(payload, header.nameLength);
+		auto old = byName.find(name);
+		if (old != byName.end()) {
+			entries[old->second].live = false;
+			liveBytes -= entries[old->second].recordSize;
+			byName.erase(old);
+		}
+		if (header.kind != RecordSave)
+			return;
+
+		Entry entry;
+		entry.name = std::move(name);
+		entry.tags.assign(payload + header.nameLength, header.tagsLength);
+		entry.recordOffset = offset;
+		entry.recordSize = (ImU32)sizeof(RecordHeader) + header.nameLength + header.tagsLength + header.packedSize;
+		entry.packedSize = header.packedSize;
+		entry.textSize = header.textSize;
+		entry.live = true;
+		liveBytes += entry.recordSize;
+		byName[entry.name] = (int)entries.size();
+		entries.push_back(std::move(entry));
+		IndexEntry((int)entries.size() - 1);
+	}
+
+	// Walks the records up to the first one that is cut off or doesn't match its hash
+	void Parse(const char* data, size_t size) {
+		entries.clear();
+		byName.clear();
+		trigrams.clear();
+		liveBytes = 0;
+		fileSize = 0;
+		version++;
+
+		FileHeader fileHeader;
+		if (size < sizeof(fileHeader))
+			return;
+		memcpy(&fileHeader, data, sizeof(fileHeader));
+		if (fileHeader.magic != Magic || fileHeader.version != Version)
+			return;
+
+		size_t offset = sizeof(fileHeader);
+		while (size - offset >= sizeof(RecordHeader)) {
+			RecordHeader header;
+			memcpy(&header, data + offset, sizeof(header));
+			size_t payloadSize = (size_t)header.nameLength + header.tagsLength + header.packedSize;
+			const char* payload = data + offset + sizeof(header);
+			if (payloadSize > size - offset - sizeof(header) || RecordHash(header, payload) != header.hash)
+				break;
+			Apply(header, payload, offset);
+			offset += sizeof(header) + payloadSize;
+		}
+		fileSize = offset;
+	}
+
+	void Load(const std::string& libraryPath) {
+		path = libraryPath;
+		MappedFile file;
+		if (file.Open(path))
+			Parse(file.data, file.size);
+		else
+			Parse(nullptr, 0);
+	}
+
+	bool Append(const std::vector<char>& record) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		// A new file, or one that wasn't ours, starts over with a header
+		std::vector<char> bytes;
+		if (fileSize == 0) {
+			FileHeader fileHeader = { Magic, Version };
+			bytes.insert(bytes.end(), (const char*)&fileHeader, (const char*)&fileHeader + sizeof(fileHeader));
+		}
+		bytes.insert(bytes.end(), record.begin(), record.end());
+
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)fileSize;
+		DWORD written = 0;
+		bool ok = SetFilePointerEx(file, position, NULL, FILE_BEGIN) && WriteFile(file, bytes.data(), (DWORD)bytes.size(), &written, NULL) && written == bytes.size() && SetEndOfFile(file);
+		CloseHandle(file);
+		if (ok && fileSize == 0)
+			fileSize = sizeof(FileHeader);
+		return ok;
+	}
+
+	// Copies the live records into a new file, in the order they were saved
+	bool Compact() {
+		MappedFile file;
+		if (!file.Open(path) || file.size < fileSize)
+			return false;
+
+		std::vector<char> bytes;
+		FileHeader fileHeader = { Magic, Version };
+		bytes.insert(bytes.end(), (const char*)&fileHeader, (const char*)&fileHeader + sizeof(fileHeader));
+		for (const Entry& entry : entries) {
+			if (entry.live)
+				bytes.insert(bytes.end(), file.data + entry.recordOffset, file.data + entry.recordOffset + entry.recordSize);
+		}
+		file.Close();
+		if (!WriteFileBytes(path, bytes.data(), bytes.size()))
+			return false;
+		Parse(bytes.data(), bytes.size());
+		return true;
+	}
+
+	bool Write(RecordKind kind, const std::string& name, const std::string& tags, const char* text, size_t textSize) {
+		RecordHeader header = {};
+		header.kind = kind;
+		header.nameLength = (ImU32)name.size();
+		header.tagsLength = (ImU32)tags.size();
+		header.textSize = (ImU32)textSize;
+
+		std::vector<char> record(sizeof(header) + name.size() + tags.size() + Lz4::Bound(textSize));
+		char* payload = record.data() + sizeof(header);
+		memcpy(payload, name.data(), name.size());
+		memcpy(payload + name.size(), tags.data(), tags.size());
+		header.packedSize = (ImU32)Lz4::Compress(text, textSize, payload + name.size() + tags.size());
+		record.resize(sizeof(header) + name.size() + tags.size() + header.packedSize);
+		payload = record.data() + sizeof(header);
+		header.hash = RecordHash(header, payload);
+		memcpy(record.data(), &header, sizeof(header));
+
+		if (!Append(record))
+			return false;
+		Apply(header, payload, fileSize);
+		fileSize += record.size();
+		version++;
+
+		if (fileSize > CompactMinimum && liveBytes < fileSize / 2)
+			Compact();
+		return true;
+	}
+
+	bool Save(const std::string& name, const std::string& tags, const std::string& text) {
+		return !name.empty() && Write(RecordSave, name, tags, text.data(), text.size());
+	}
+
+	bool Delete(const std::string& name) {
+		return byName.count(name) && Write(RecordDelete, name, "", "", 0);
+	}
+
+	// Decompresses the entry's text, which the editor then takes in one piece
+	bool Read(const Entry& entry, std::string& text) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		std::vector<char> packed(entry.packedSize);
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)(entry.recordOffset + sizeof(RecordHeader) + entry.name.size() + entry.tags.size());
+		DWORD read = 0;
+		bool ok = SetFilePointerEx(file, position, NULL, FILE_BEGIN) && (packed.empty() || (ReadFile(file, packed.data(), (DWORD)packed.size(), &read, NULL) && read == packed.size()));
+		CloseHandle(file);
+
+		text.resize(entry.textSize);
+		return ok && Lz4::Decompress(packed.data(), packed.size(), &text[0], text.size());
+	}
+
+	// How well the query's characters line up with the text, in order: runs and word starts count more.
+	// -1 when they don't all occur in order.
+	int SubsequenceScore(const std::string& query, const std::string& text) {
+		int score = 0, run = 0;
+		size_t t = 0;
+		for (size_t q = 0; q < query.size(); q++) {
+			if (IsSeparator(query[q]))
+				continue;
+			char c = Lower(query[q]);
+			size_t start = t;
+			while (t < text.size() && Lower(text[t]) != c)
+				t++;
+			if (t == text.size())
+				return -1;
+			run = t == start && q > 0 ? run + 1 : 0;
+			score += 1 + run * 2 + (t == 0 || !isalnum((unsigned char)text[t - 1]) ? 3 : 0);
+			t++;
+		}
+		return score;
+	}
+
+	// Names weigh more than tags
+	int MatchScore(const std::string& query, const Entry& entry) {
+		int score = SubsequenceScore(query, entry.name);
+		return score >= 0 ? score * 2 : SubsequenceScore(query, entry.name + " " + entry.tags);
+	}
+
+	// Live entries matching the query, best first. Candidates are the entries sharing at least half of the query's
+	// trigrams, so a typo or two still finds them; queries too short for that are matched against every name.
+	void Search(const std::string& query, std::vector<int>& results) {
+		results.clear();
+		std::vector<ImU32> grams;
+		ForEachTrigram(query, [&](ImU32 gram) { grams.push_back(gram); });
+		std::sort(grams.begin(), grams.end());
+		grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+		std::vector<std::pair<int, int>> scored;
+		size_t queryLength = query.size() - std::count_if(query.begin(), query.end(), IsSeparator);
+		if (queryLength < 3) {
+			for (int i = 0; i < (int)entries.size(); i++) {
+				if (!entries[i].live)
+					continue;
+				int score = queryLength == 0 ? 0 : MatchScore(query, entries[i]);
+				if (score >= 0)
+					scored.emplace_back(score, i);
+			}
+		}
+		else {
+			std::vector<int> shared(entries.size());
+			std::vector<int> touched;
+			for (ImU32 gram : grams) {
+				auto posting = trigrams.find(gram);
+				if (posting == trigrams.end())
+					continue;
+				for (int index : posting->second) {
+					if (shared[index]++ == 0)
+						touched.push_back(index);
+				}
+			}
+			for (int index : touched) {
+				if (!entries[index].live || shared[index] * 2 < (int)grams.size())
+					continue;
+				scored.emplace_back(shared[index] * 8 + std::max(MatchScore(query, entries[index]), 0), index);
+			}
+		}
+
+		std::sort(scored.begin(), scored.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+			if (a.first != b.first)
+				return a.first > b.first;
+			return _stricmp(entries[a.second].name.c_str(), entries[b.second].name.c_str()) < 0;
+		});
+		for (auto& s : scored)
+			results.push_back(s.second);
+	}
+}
\ No newline at end of file
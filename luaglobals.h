@@ -0,0 +1,344 @@
+#pragma once
+#include <Windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <map>
+#include <unordered_set>
+#include <vector>
+#include <imgui/TextEditor.h>
+#include "sdk/lua_shared/CLuaInterface.h"
+#include "glua_completion.h"
+
+// Names defined in the running Lua state, for completions the static API table can't know about (addon globals).
+// Step() walks _G and the tables below it a few hundred keys per call from PaintTraverse, one pass after another.
+// Names are stamped with the pass that last saw them. A finished pass drops the ones the last few passes didn't see
+// (a table rehashed mid-walk makes lua_next skip keys) and publishes a new snapshot, bumping generation, only when
+// something was added or removed.
+namespace LuaGlobals {
+	const int KeysPerStep = 256;
+	const double StepBudgetMs = 0.25;
+	const int MaxDepth = 3;               // _G.a.b.c
+	const size_t MaxNames = 50000;
+	const ULONGLONG PassInterval = 2000;  // ms between passes
+	const unsigned StalePasses = 3;       // passes a name may go unseen before it is dropped
+
+	// Only raw accessors, a metamethod raising an error would unwind through our frames
+	typedef int(*_lua_gettop)(lua_State* L);
+	typedef void(*_lua_settop)(lua_State* L, int idx);
+	typedef void(*_lua_pushvalue)(lua_State* L, int idx);
+	typedef void(*_lua_pushnil)(lua_State* L);
+	typedef void(*_lua_pushlstring)(lua_State* L, const char* s, size_t len);
+	typedef void(*_lua_pushnumber)(lua_State* L, double n);
+	typedef void(*_lua_replace)(lua_State* L, int idx);
+	typedef void(*_lua_rawget)(lua_State* L, int idx);
+	typedef int(*_lua_next)(lua_State* L, int idx);
+	typedef int(*_lua_type)(lua_State* L, int idx);
+	typedef const char*(*_lua_tolstring)(lua_State* L, int idx, size_t* len);
+	typedef double(*_lua_tonumber)(lua_State* L, int idx);
+	typedef const void*(*_lua_topointer)(lua_State* L, int idx);
+	const int GlobalsIndex = -10002;      // LUA_GLOBALSINDEX
+
+	struct Api {
+		_lua_gettop gettop;
+		_lua_settop settop;
+		_lua_pushvalue pushvalue;
+		_lua_pushnil pushnil;
+		_lua_pushlstring pushlstring;
+		_lua_pushnumber pushnumber;
+		_lua_replace replace;
+		_lua_rawget rawget;
+		_lua_next next;
+		_lua_type type;
+		_lua_tolstring tolstring;
+		_lua_tonumber tonumber;
+		_lua_topointer topointer;
+		bool ok;
+	};
+
+	const Api& GetApi() {
+		static const Api api = [] {
+			HMODULE luaModule = GetModuleHandle("lua_shared.dll");
+			Api a = {};
+			if (luaModule) {
+				a.gettop = (_lua_gettop)GetProcAddress(luaModule, "lua_gettop");
+				a.settop = (_lua_settop)GetProcAddress(luaModule, "lua_settop");
+				a.pushvalue = (_lua_pushvalue)GetProcAddress(luaModule, "lua_pushvalue");
+				a.pushnil = (_lua_pushnil)GetProcAddress(luaModule, "lua_pushnil");
+				a.pushlstring = (_lua_pushlstring)GetProcAddress(luaModule, "lua_pushlstring");
+				a.pushnumber = (_lua_pushnumber)GetProcAddress(luaModule, "lua_pushnumber");
+				a.replace = (_lua_replace)GetProcAddress(luaModule, "lua_replace");
+				a.rawget = (_lua_rawget)GetProcAddress(luaModule, "lua_rawget");
+				a.next = (_lua_next)GetProcAddress(luaModule, "lua_next");
+				a.type = (_lua_type)GetProcAddress(luaModule, "lua_type");
+				a.tolstring = (_lua_tolstring)GetProcAddress(luaModule, "lua_tolstring");
+				a.tonumber = (_lua_tonumber)GetProcAddress(luaModule, "lua_tonumber");
+				a.topointer = (_lua_topointer)GetProcAddress(luaModule, "lua_topointer");
+			}
+			a.ok = a.gettop && a.settop && a.pushvalue && a.pushnil && a.pushlstring && a.pushnumber && a.replace && a.rawget && a.next && a.type &&
+				a.tolstring && a.tonumber && a.topointer;
+			return a;
+		}();
+		return api;
+	}
+
+	// What the editor queries, sorted by name ignoring case like the static API table
+	struct Snapshot {
+		std::vector<std::string> names;
+		std::vector<unsigned char> types;   // LuaTypes of each name's value
+	};
+
+	std::shared_ptr<const Snapshot> snapshot = std::make_shared<const Snapshot>();
+	std::atomic<unsigned> generation(0);    // bumped with every published snapshot
+
+	// Walker state, only touched from Step() on the game thread
+	struct Name {
+		unsigned pass;
+		unsigned char type;
+	};
+	struct NameLess {
+		bool operator()(const std::string& a, const std::string& b) const {
+			int c = _stricmp(a.c_str(), b.c_str());
+			return c != 0 ? c < 0 : a < b;
+		}
+	};
+	std::map<std::string, Name, NameLess> names;  // kept in snapshot order, publishing is a copy
+	std::deque<std::string> pending;        // tables still to walk this pass, by dotted path ("" is _G)
+	std::unordered_set<const void*> visited;
+	std::string current;                    // table being walked, valid while walking
+	enum ResumeType { None, StringKey, NumberKey } resumeType = None;  // last key taken from it
+	std::string resumeKey;
+	double resumeNumber = 0;
+	bool walking = false;
+	bool changed = false;
+	int restarts = 0;
+	unsigned pass = 0;
+	ULONGLONG nextPass = 0;
+	lua_State* walkedState = nullptr;
+
+	bool IsIdentifier(const char* s, size_t len) {
+		if (len == 0 || len > 255 || isdigit((unsigned char)s[0]))
+			return false;
+		for (size_t i = 0; i < len; i++)
+			if (!isalnum((unsigned char)s[i]) && s[i] != '_')
+				return false;
+		return true;
+	}
+
+	// Pushes the table at a dotted path, or nothing if it isn't a table anymore
+	bool PushTable(const Api& lua, lua_State* L, const std::string& path) {
+		lua.pushvalue(L, GlobalsIndex);
+		size_t start = 0;
+		while (start < path.size()) {
+			size_t dot = path.find('.', start);
+			if (dot == std::string::npos)
+				dot = path.size();
+			lua.pushlstring(L, path.data() + start, dot - start);
+			lua.rawget(L, -2);
+			lua.replace(L, -2);
+			if (lua.type(L, -1) != LuaTypes::Table) {
+				lua.settop(L, -2);
+				return false;
+			}
+			start = dot + 1;
+		}
+		return true;
+	}
+
+	void Publish() {
+		auto next = std::make_shared<Snapshot>();
+		next->names.reserve(names.size());
+		next->types.reserve(names.size());
+		for (auto& name : names) {
+			next->names.push_back(name.first);
+			next->types.push_back(name.second.type);
+		}
+		std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(std::move(next)));
+		generation++;
+	}
+
+	void Reset() {
+		names.clear();
+		pending.clear();
+		visited.clear();
+		walking = false;
+		changed = false;
+		nextPass = 0;
+		std::atomic_store(&snapshot, std::make_shared<const Snapshot>());
+		generation++;
+	}
+
+	void FinishPass() {
+		for (auto it = names.begin(); it != names.end();) {
+			if (pass - it->second.pass >= StalePasses) {
+				it = names.erase(it);
+				changed = true;
+			}
+			else {
+				++it;
+			}
+		}
+		if (changed)
+			Publish();
+		walking = false;
+		visited.clear();
+		nextPass = GetTickCount64() + PassInterval;
+	}
+
+	// Walks on from where the last call stopped, at most KeysPerStep keys or StepBudgetMs. Call with the state of the
+	// selected realm, switching states starts over.
+	void Step(lua_State* L) {
+		const Api& lua = GetApi();
+		if (!lua.ok || !L)
+			return;
+
+		if (L != walkedState) {
+			walkedState = L;
+			Reset();
+		}
+
+		if (!walking) {
+			if (GetTickCount64() < nextPass)
+				return;
+			walking = true;
+			changed = false;
+			pass++;
+			pending.assign(1, std::string());
+			resumeType = None;
+		}
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(StepBudgetMs * 1000));
+		int budget = KeysPerStep;
+		int top = lua.gettop(L);
+		while (budget > 0) {
+			if (resumeType == None) {
+				if (pending.empty()) {
+					FinishPass();
+					break;
+				}
+				current = std::move(pending.front());
+				pending.pop_front();
+				restarts = 0;
+			}
+
+			if (!PushTable(lua, L, current)) {
+				resumeType = None;
+				continue;
+			}
+			int table = lua.gettop(L);
+			if (resumeType == None && !visited.insert(lua.topointer(L, table)).second) {
+				lua.settop(L, top);
+				continue;
+			}
+
+			// lua_next needs a key that is still in the table, start over (names are deduplicated) if it was removed
+			if (resumeType == None) {
+				lua.pushnil(L);
+			}
+			else {
+				if (resumeType == StringKey)
+					lua.pushlstring(L, resumeKey.data(), resumeKey.size());
+				else
+					lua.pushnumber(L, resumeNumber);
+				lua.pushvalue(L, -1);
+				lua.rawget(L, table);
+				bool present = lua.type(L, -1) != LuaTypes::Nil;
+				lua.settop(L, -2);
+				if (!present) {
+					lua.settop(L, -2);
+					lua.pushnil(L);
+					if (++restarts > 3) {
+						resumeType = None;
+						lua.settop(L, top);
+						continue;
+					}
+				}
+			}
+
+			int depth = current.empty() ? 0 : (int)std::count(current.begin(), current.end(), '.') + 1;
+			bool stopped = false;
+			while (lua.next(L, table)) {
+				budget--;
+				// lua_tolstring would convert a number key in place and break lua_next, so only strings are read as names
+				int keyType = lua.type(L, -2);
+				if (keyType == LuaTypes::String) {
+					size_t len = 0;
+					const char* key = lua.tolstring(L, -2, &len);
+					int type = lua.type(L, -1);
+					if (IsIdentifier(key, len) && names.size() < MaxNames) {
+						std::string name = current.empty() ? std::string(key, len) : current + "." + std::string(key, len);
+						auto inserted = names.emplace(name, Name{ pass, (unsigned char)type });
+						if (inserted.second || inserted.first->second.type != type)
+							changed = true;
+						inserted.first->second.pass = pass;
+						inserted.first->second.type = (unsigned char)type;
+						if (type == LuaTypes::Table && depth + 1 < MaxDepth)
+							pending.push_back(std::move(name));
+					}
+				}
+
+				// Only string and number keys can be pushed again to resume from
+				if ((keyType == LuaTypes::String || keyType == LuaTypes::Number) &&
+					(budget <= 0 || ((budget & 31) == 0 && std::chrono::steady_clock::now() > deadline))) {
+					if (keyType == LuaTypes::String) {
+						size_t len = 0;
+						const char* key = lua.tolstring(L, -2, &len);
+						resumeKey.assign(key, len);
+						resumeType = StringKey;
+					}
+					else {
+						resumeNumber = lua.tonumber(L, -2);
+						resumeType = NumberKey;
+					}
+					stopped = true;
+					break;
+				}
+				lua.settop(L, -2);
+			}
+			lua.settop(L, top);
+			if (!stopped)
+				resumeType = None;
+			else
+				break;
+		}
+		lua.settop(L, top);
+	}
+
+	// Same ranking as GLuaApi::Complete. The strings stay valid until the next call.
+	int Complete(const char* prefix, size_t length, TextEditor::Completion* out, int max) {
+		static const char* const typeNames[] = { "nil", "boolean", "lightuserdata", "number", "string", "table", "function", "userdata", "thread" };
+		static std::shared_ptr<const Snapshot> held;
+		held = std::atomic_load(&snapshot);
+		const std::vector<std::string>& sorted = held->names;
+
+		auto compare = [&](const std::string& name) {
+			for (size_t i = 0; i < length; i++) {
+				if (i == name.size())
+					return -1;
+				unsigned char a = GLuaApi::Fold(name[i]), b = GLuaApi::Fold(prefix[i]);
+				if (a != b)
+					return a < b ? -1 : 1;
+			}
+			return 0;
+		};
+		auto begin = std::partition_point(sorted.begin(), sorted.end(), [&](const std::string& name) { return compare(name) < 0; });
+		auto end = std::partition_point(begin, sorted.end(), [&](const std::string& name) { return compare(name) == 0; });
+
+		int depth = (int)std::count(prefix, prefix + length, '.');
+		int count = 0;
+		for (int pass = 0; pass < 2 && count < max; pass++) {
+			for (auto it = begin; it != end && count < max; ++it) {
+				if (((int)std::count(it->begin(), it->end(), '.') == depth) != (pass == 0))
+					continue;
+				unsigned char type = held->types[it - sorted.begin()];
+				out[count].mText = it->c_str();
+				out[count].mDetail = type < sizeof(typeNames) / sizeof(typeNames[0]) ? typeNames[type] : "";
+				count++;
+			}
+		}
+		return count;
+	}
+}
\ No newline at end of file
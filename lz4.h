@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// LZ4 block format (no frame header): sequences of a token, literals and a back reference into the last 64 KB.
+// Greedy single-probe matching, which is fast and plenty for script text.
+namespace Lz4 {
+	const int MinMatch = 4;
+	const int HashBits = 12;
+	const size_t MaxOffset = 65535;
+	const size_t LastLiterals = 5;      // the format wants the block to end in literals
+	const size_t MatchStartLimit = 12;  // and the last match to start this far from the end
+
+	// Worst case for incompressible input
+	size_t Bound(size_t size) {
+		return size + size / 255 + 16;
+	}
+
+	uint32_t Read32(const unsigned char* p) {
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t sequence) {
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	// Lengths that don't fit the token's 4 bits continue in bytes of 255 and a remainder
+	void WriteLength(unsigned char*& out, size_t length) {
+		for (; length >= 255; length -= 255)
+			*out++ = 255;
+		*out++ = (unsigned char)length;
+	}
+
+	void WriteSequence(unsigned char*& out, const unsigned char* literals, size_t literalCount, size_t offset, size_t matchLength) {
+		unsigned char* token = out++;
+		*token = (unsigned char)((literalCount >= 15 ? 15 : literalCount) << 4);
+		if (literalCount >= 15)
+			WriteLength(out, literalCount - 15);
+		memcpy(out, literals, literalCount);
+		out += literalCount;
+		if (offset == 0)
+			return;
+
+		*out++ = (unsigned char)(offset & 0xff);
+		*out++ = (unsigned char)(offset >> 8);
+		matchLength -= MinMatch;
+		*token |= (unsigned char)(matchLength >= 15 ? 15 : matchLength);
+		if (matchLength >= 15)
+			WriteLength(out, matchLength - 15);
+	}
+
+	// Returns the compressed size, dst has to hold Bound(size) bytes
+	size_t Compress(const char* src, size_t size, char* dst) {
+		const unsigned char* in = (const unsigned char*)src;
+		const unsigned char* end = in + size;
+		const unsigned char* anchor = in;
+		unsigned char* out = (unsigned char*)dst;
+
+		if (size > MatchStartLimit) {
+			const unsigned char* matchStartEnd = end - MatchStartLimit;
+			const unsigned char* matchEnd = end - LastLiterals;
+			int table[1 << HashBits];
+			memset(table, 0xff, sizeof(table));
+
+			const unsigned char* p = in;
+			while (p < matchStartEnd) {
+				uint32_t sequence = Read32(p);
+				uint32_t hash = Hash(sequence);
+				int previous = table[hash];
+				table[hash] = (int)(p - in);
+				const unsigned char* ref = in + previous;
+				if (previous < 0 || (size_t)(p - ref) > MaxOffset || Read32(ref) != sequence) {
+					p++;
+					continue;
+				}
+
+				while (p > anchor && ref > in && p[-1] == ref[-1]) {
+					p--;
+					ref--;
+				}
+				const unsigned char* q = p + MinMatch;
+				for (const unsigned char* r = ref + MinMatch; q < matchEnd && *q == *r; q++, r++);
+
+				WriteSequence(out, anchor, p - anchor, p - ref, q - p);
+				p = anchor = q;
+			}
+		}
+		WriteSequence(out, anchor, end - anchor, 0, 0);
+		return out - (unsigned char*)dst;
+	}
+
+	// Fails on anything malformed instead of reading or writing out of bounds, dst gets exactly dstSize bytes
+	bool Decompress(const char* src, size_t srcSize, char* dst, size_t dstSize) {
+		const unsigned char* in = (const unsigned char*)src;
+		const unsigned char* inEnd = in + srcSize;
+		unsigned char* out = (unsigned char*)dst;
+		unsigned char* outEnd = out + dstSize;
+
+		auto readLength = [&](size_t& length) {
+			unsigned char byte;
+			do {
+				if (in >= inEnd)
+					return false;
+				byte = *in++;
+				length += byte;
+			} while (byte == 255);
+			return true;
+		};
+
+		while (in < inEnd) {
+			unsigned token = *in++;
+			size_t literalCount = token >> 4;
+			if (literalCount == 15 && !readLength(literalCount))
+				return false;
+			if ((size_t)(inEnd - in) < literalCount || (size_t)(outEnd - out) < literalCount)
+				return false;
+			memcpy(out, in, literalCount);
+			in += literalCount;
+			out += literalCount;
+
+			// The last sequence has no match
+			if (in == inEnd)
+				break;
+			if (inEnd - in < 2)
+				return false;
+			size_t offset = in[0] | (size_t)in[1] << 8;
+			in += 2;
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !readLength(matchLength))
+				return false;
+			matchLength += MinMatch;
+			if (offset == 0 || offset > (size_t)(out - (unsigned char*)dst) || (size_t)(outEnd - out) < matchLength)
+				return false;
+
+			// A reference closer than its length repeats the bytes it is copying
+			const unsigned char* ref = out - offset;
+			if (offset >= matchLength)
+				memcpy(out, ref, matchLength);
+			else
+				for (size_t i = 0; i < matchLength; i++)
+					out[i] = ref[i];
+			out += matchLength;
+		}
+		return out == outEnd;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Everything the executor persists between injections lives in %APPDATA%\glua-executor
+std::string GetDataPath(const char* fileName) {
+	static const std::string dataDir = [] {
+		char appData[MAX_PATH];
+		DWORD len = GetEnvironmentVariableA("APPDATA", appData, MAX_PATH);
+		std::string dir = (len > 0 && len < MAX_PATH) ? std::string(appData) + "\\glua-executor" : "glua-executor";
+		CreateDirectoryA(dir.c_str(), NULL);
+		return dir;
+	}();
+	return dataDir + "\\" + fileName;
+}
+
+// Reads a whole file with a single read call
+bool ReadFileBytes(const std::string& path, std::vector<char>& out) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	bool ok = GetFileSizeEx(file, &size) && size.QuadPart < MAXDWORD;
+	if (ok) {
+		DWORD read = 0;
+		out.resize((size_t)size.QuadPart);
+		ok = out.empty() || (ReadFile(file, out.data(), (DWORD)out.size(), &read, NULL) && read == out.size());
+	}
+	CloseHandle(file);
+	return ok;
+}
+
+// Read-only view of a whole file, large scripts are handed to the editor straight from the mapping
+struct MappedFile {
+	const char* data = nullptr;
+	size_t size = 0;
+
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const std::string& path) {
+		Close();
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		bool ok = GetFileSizeEx(file, &fileSize) != 0;
+		// Empty files can't be mapped, they just have no data
+		if (ok && fileSize.QuadPart > 0) {
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+			ok = view != NULL;
+			if (ok) {
+				data = (const char*)view;
+				size = (size_t)fileSize.QuadPart;
+			}
+		}
+		CloseHandle(file);
+		if (!ok)
+			Close();
+		return ok;
+	}
+
+	void Close() {
+		if (view)
+			UnmapViewOfFile(view);
+		if (mapping)
+			CloseHandle(mapping);
+		view = NULL;
+		mapping = NULL;
+		data = nullptr;
+		size = 0;
+	}
+
+private:
+	HANDLE mapping = NULL;
+	LPVOID view = NULL;
+};
+
+// Writes to a temporary file first so a crash mid-write never leaves a truncated file behind
+bool WriteFileBytes(const std::string& path, const void* data, size_t size) {
+	std::string tmpPath = path + ".tmp";
+	HANDLE file = CreateFileA(tmpPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD written = 0;
+	bool ok = size == 0 || (WriteFile(file, data, (DWORD)size, &written, NULL) && written == size);
+	CloseHandle(file);
+	if (!ok) {
+		DeleteFileA(tmpPath.c_str());
+		return false;
+	}
+	return MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+// Windows paths ignore case
+bool SamePath(const std::string& a, const std::string& b) {
+	return _stricmp(a.c_str(), b.c_str()) == 0;
+}
+#else
+// The same files for builds without _WIN32, under $HOME/.glua-executor
+std::string GetDataPath(const char* fileName) {
+	static const std::string dataDir = [] {
+		const char* home = getenv("HOME");
+		std::string dir = home ? std::string(home) + "/.glua-executor" : "glua-executor";
+		mkdir(dir.c_str(), 0755);
+		return dir;
+	}();
+	return dataDir + "/" + fileName;
+}
+
+bool ReadFileBytes(const std::string& path, std::vector<char>& out) {
+	int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	bool ok = fstat(file, &info) == 0;
+	if (ok) {
+		out.resize((size_t)info.st_size);
+		ok = out.empty() || read(file, out.data(), out.size()) == (ssize_t)out.size();
+	}
+	close(file);
+	return ok;
+}
+
+struct MappedFile {
+	const char* data = nullptr;
+	size_t size = 0;
+
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const std::string& path) {
+		Close();
+		int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			return false;
+
+		struct stat info;
+		bool ok = fstat(file, &info) == 0;
+		if (ok && info.st_size > 0) {
+			void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			ok = view != MAP_FAILED;
+			if (ok) {
+				data = (const char*)view;
+				size = (size_t)info.st_size;
+			}
+		}
+		close(file);
+		return ok;
+	}
+
+	void Close() {
+		if (data)
+			munmap((void*)data, size);
+		data = nullptr;
+		size = 0;
+	}
+};
+
+bool WriteFileBytes(const std::string& path, const void* data, size_t size) {
+	std::string tmpPath = path + ".tmp";
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (!file)
+		return false;
+
+	bool ok = size == 0 || fwrite(data, 1, size, file) == size;
+	ok = fclose(file) == 0 && ok;
+	if (!ok) {
+		remove(tmpPath.c_str());
+		return false;
+	}
+	return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool SamePath(const std::string& a, const std::string& b) {
+	return a == b;
+}
+#endif
\ No newline at end of file
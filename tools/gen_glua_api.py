@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# Builds glua_api.h, the table behind GLua autocompletion, from an API dump (tools/glua_api.txt by default).
+# Usage: python tools/gen_glua_api.py [--check] [dump] [output]
+#
+# The repo doesn't ship a project file, so nothing runs this for you: rerun it after editing the dump and commit both.
+# It only rewrites the header when the output changes, so it can go in the project's Pre-Build Event as
+#   python "$(ProjectDir)tools\gen_glua_api.py"
+# without rebuilding everything each time. --check writes nothing and fails if glua_api.h is out of date.
+#
+# Entries are sorted case-insensitively so a prefix maps to one contiguous range that glua_completion.h finds
+# with two binary searches. Names and details live in two packed string tables, each detail stored once.
+import os
+import sys
+
+root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+args = [arg for arg in sys.argv[1:] if arg != "--check"]
+check = len(args) != len(sys.argv) - 1
+dumpPath = args[0] if len(args) > 0 else os.path.join(root, "tools", "glua_api.txt")
+outPath = args[1] if len(args) > 1 else os.path.join(root, "glua_api.h")
+
+# MSVC refuses string literals longer than this after concatenation
+MaxLiteral = 65535
+
+
+def fail(message):
+    sys.stderr.write("gen_glua_api: " + message + "\n")
+    sys.exit(1)
+
+
+def escape(text):
+    return text.replace("\\", "\\\\").replace("\"", "\\\"")
+
+
+entries = {}
+with open(dumpPath, encoding="utf-8") as dump:
+    for number, line in enumerate(dump, 1):
+        line = line.rstrip("\r\n")
+        if not line.strip() or line.startswith("#"):
+            continue
+        name, _, detail = line.partition("\t")
+        name = name.strip()
+        if not name or not all(c.isalnum() or c in "_." for c in name) or len(name) > 255:
+            fail("%s:%d: bad name '%s'" % (dumpPath, number, name))
+        if name in entries:
+            fail("%s:%d: duplicate name '%s'" % (dumpPath, number, name))
+        entries[name] = detail.strip()
+
+names = sorted(entries, key=lambda n: (n.lower(), n))
+
+nameOffsets = []
+nameSize = 0
+for name in names:
+    nameOffsets.append(nameSize)
+    nameSize += len(name) + 1
+
+detailOffsets = {}
+details = []
+detailSize = 0
+for name in names:
+    detail = entries[name]
+    if detail not in detailOffsets:
+        detailOffsets[detail] = detailSize
+        details.append(detail)
+        detailSize += len(detail) + 1
+
+if nameSize > MaxLiteral or detailSize > MaxLiteral:
+    fail("string tables too large (%d, %d bytes)" % (nameSize, detailSize))
+
+out = []
+out.append("#pragma once")
+out.append("// Generated by tools/gen_glua_api.py from tools/glua_api.txt, do not edit. Rerun the script after changing the dump.")
+out.append("#include <cstdint>")
+out.append("")
+out.append("namespace GLuaApi {")
+out.append("\tstruct Entry {")
+out.append("\t\tuint16_t name;         // offset into Names")
+out.append("\t\tuint16_t detail;       // offset into Details")
+out.append("\t\tuint8_t nameLength;")
+out.append("\t\tuint8_t depth;         // number of dots in the name")
+out.append("\t};")
+out.append("")
+out.append("\tconst int EntryCount = %d;" % len(names))
+out.append("")
+out.append("\t// Sorted by name, ignoring case")
+out.append("\tconst Entry Entries[EntryCount] = {")
+for name, offset in zip(names, nameOffsets):
+    out.append("\t\t{ %d, %d, %d, %d }," % (offset, detailOffsets[entries[name]], len(name), name.count(".")))
+out.append("\t};")
+out.append("")
+out.append("\tconst char Names[] =")
+for name in names:
+    out.append("\t\t\"%s\\0\"" % escape(name))
+out.append("\t\t;")
+out.append("")
+out.append("\tconst char Details[] =")
+for detail in details:
+    out.append("\t\t\"%s\\0\"" % escape(detail))
+out.append("\t\t;")
+out.append("}")
+
+text = "\r\n".join(out).encode("utf-8")
+try:
+    with open(outPath, "rb") as header:
+        current = header.read()
+except OSError:
+    current = None
+
+if current == text:
+    print("gen_glua_api: %s is up to date" % outPath)
+    sys.exit(0)
+if check:
+    fail("%s is out of date, run tools/gen_glua_api.py" % outPath)
+
+with open(outPath, "wb") as header:
+    header.write(text)
+
+print("gen_glua_api: %d entries, %d + %d bytes of strings -> %s" % (len(names), nameSize, detailSize, outPath))
@@ -0,0 +1,479 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "executor.h"
+#include "glua_syntax.h"
+#include "storage.h"
+
+// Local script files that are reloaded when they change on disk, syntax checked, and optionally run in the selected
+// realm. A thread of its own sleeps on change notifications for the files' directories, and only reloads a file once
+// its writes have stopped for DebounceMs, so the handful of writes an editor makes per save comes down to one check.
+namespace Watcher {
+	const int DebounceMs = 100;
+	const int ReadAttempts = 5;     // the file can still be locked by whatever is saving it
+
+	enum Status {
+		StatusWaiting,
+		StatusLoaded,
+		StatusSyntaxError,
+		StatusReadError,
+		StatusQueued,
+		StatusRan,
+		StatusRunError,
+	};
+
+	struct File {
+		int id;
+		std::string path;
+		bool autoRun;
+		Status status;
+		std::string message;    // the first syntax error, or what running it gave
+		ImU32 hash;             // of the text last checked, saves that change nothing are skipped
+		int loads;
+		bool runRequested;      // from the list, read and run it whether it changed or not
+	};
+
+	// One change in a watched directory, an empty name means anything in it may have changed
+	struct Change {
+		size_t directory;
+		std::string name;
+	};
+
+#ifdef _WIN32
+	// An overlapped ReadDirectoryChangesW per directory, all waited on together with an event that wakes the thread
+	struct Notifier {
+		struct Directory {
+			HANDLE handle;
+			OVERLAPPED overlapped;
+			DWORD buffer[4096];     // FILE_NOTIFY_INFORMATION records have to be DWORD aligned
+		};
+
+		HANDLE wake = CreateEventA(NULL, FALSE, FALSE, NULL);
+		std::vector<std::unique_ptr<Directory>> directories;    // the system writes into them, they can't move
+
+		~Notifier() {
+			Watch(std::vector<std::string>());
+			CloseHandle(wake);
+		}
+
+		void Wake() {
+			SetEvent(wake);
+		}
+
+		bool Listen(Directory& directory) {
+			ResetEvent(directory.overlapped.hEvent);
+			return ReadDirectoryChangesW(directory.handle, directory.buffer, sizeof(directory.buffer), FALSE,
+				FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, NULL, &directory.overlapped, NULL) != 0;
+		}
+
+		// Directories that can't be opened stay in the list so indices keep matching, they just never report anything
+		void Watch(const std::vector<std::string>& paths) {
+			for (auto& directory : directories) {
+				if (directory->handle == INVALID_HANDLE_VALUE)
+					continue;
+				DWORD bytes;
+				CancelIoEx(directory->handle, &directory->overlapped);
+				GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+				CloseHandle(directory->handle);
+				CloseHandle(directory->overlapped.hEvent);
+			}
+			directories.clear();
+
+			for (size_t i = 0; i < paths.size() && i < MAXIMUM_WAIT_OBJECTS - 1; i++) {
+				std::unique_ptr<Directory> directory(new Directory());
+				directory->handle = CreateFileA(paths[i].c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+					OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+				if (directory->handle != INVALID_HANDLE_VALUE) {
+					directory->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+					if (!Listen(*directory)) {
+						CloseHandle(directory->handle);
+						CloseHandle(directory->overlapped.hEvent);
+						directory->handle = INVALID_HANDLE_VALUE;
+					}
+				}
+				directories.push_back(std::move(directory));
+			}
+		}
+
+		// Sleeps until something changes, the thread is woken or timeoutMs passes (forever if it's negative)
+		void Wait(int timeoutMs, std::vector<Change>& changes) {
+			HANDLE events[MAXIMUM_WAIT_OBJECTS];
+			DWORD count = 0;
+			events[count++] = wake;
+			for (auto& directory : directories) {
+				if (directory->handle != INVALID_HANDLE_VALUE)
+					events[count++] = directory->overlapped.hEvent;
+			}
+			WaitForMultipleObjects(count, events, FALSE, timeoutMs < 0 ? INFINITE : (DWORD)timeoutMs);
+
+			for (size_t i = 0; i < directories.size(); i++) {
+				Directory& directory = *directories[i];
+				if (directory.handle == INVALID_HANDLE_VALUE || WaitForSingleObject(directory.overlapped.hEvent, 0) != WAIT_OBJECT_0)
+					continue;
+
+				// Nothing returned means the buffer overflowed and the changes were lost
+				DWORD bytes = 0;
+				if (!GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE) || bytes == 0) {
+					changes.push_back({ i, std::string() });
+				}
+				else {
+					for (const char* p = (const char*)directory.buffer;;) {
+						const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)p;
+						char name[MAX_PATH * 2];
+						int length = WideCharToMultiByte(CP_ACP, 0, info->FileName, info->FileNameLength / sizeof(WCHAR), name, sizeof(name), NULL, NULL);
+						changes.push_back({ i, std::string(name, length > 0 ? length : 0) });
+						if (info->NextEntryOffset == 0)
+							break;
+						p += info->NextEntryOffset;
+					}
+				}
+				if (!Listen(directory)) {
+					CloseHandle(directory.handle);
+					CloseHandle(directory.overlapped.hEvent);
+					directory.handle = INVALID_HANDLE_VALUE;
+				}
+			}
+		}
+	};
+#else
+	// inotify, for the test builds outside the game
+	struct Notifier {
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		int wakePipe[2] = { -1, -1 };
+		std::vector<int> watches;
+
+		Notifier() {
+			if (pipe(wakePipe) == 0) {
+				fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+				fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+			}
+		}
+
+		~Notifier() {
+			close(fd);
+			close(wakePipe[0]);
+			close(wakePipe[1]);
+		}
+
+		void Wake() {
+			char byte = 0;
+			(void)!write(wakePipe[1], &byte, 1);
+		}
+
+		void Watch(const std::vector<std::string>& paths) {
+			for (int watch : watches) {
+				if (watch >= 0)
+					inotify_rm_watch(fd, watch);
+			}
+			watches.clear();
+			for (const std::string& path : paths)
+				watches.push_back(inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE));
+		}
+
+		void Wait(int timeoutMs, std::vector<Change>& changes) {
+			pollfd fds[2] = { { fd, POLLIN, 0 }, { wakePipe[0], POLLIN, 0 } };
+			if (poll(fds, 2, timeoutMs) <= 0)
+				return;
+
+			char drain[64];
+			while (read(wakePipe[0], drain, sizeof(drain)) > 0);
+
+			alignas(inotify_event) char buffer[16384];
+			ssize_t size;
+			while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+				for (char* p = buffer; p < buffer + size;) {
+					const inotify_event* event = (const inotify_event*)p;
+					p += sizeof(inotify_event) + event->len;
+					if (event->mask & IN_Q_OVERFLOW) {
+						for (size_t i = 0; i < watches.size(); i++)
+							changes.push_back({ i, std::string() });
+						continue;
+					}
+					auto watch = std::find(watches.begin(), watches.end(), event->wd);
+					if (watch != watches.end())
+						changes.push_back({ (size_t)(watch - watches.begin()), event->len ? std::string(event->name) : std::string() });
+				}
+			}
+		}
+	};
+#endif
+
+	std::mutex mutex;           // guards files and everything in them, listVersion and stopping
+	std::vector<File> files;
+	int nextId = 1;
+	int listVersion = 0;        // bumped when files are added or removed, the thread then watches the new set of directories
+	bool stopping = false;
+	std::atomic<bool> cancel(false);
+	std::string listPath;
+	Notifier* notifier = nullptr;
+	std::thread thread;
+
+	std::string DirectoryOf(const std::string& path) {
+		size_t slash = path.find_last_of("\\/");
+		return slash == std::string::npos ? "." : path.substr(0, slash);
+	}
+
+	std::string NameOf(const std::string& path) {
+		return path.substr(path.find_last_of("\\/") + 1);
+	}
+
+	File* Find(int id) {
+		for (File& file : files) {
+			if (file.id == id)
+				return &file;
+		}
+		return nullptr;
+	}
+
+	// Job::done for runs queued by a reload
+	void Ran(const Executor::Job& job, const char* error) {
+		std::lock_guard<std::mutex> lock(mutex);
+		File* file = Find(job.tag);
+		if (!file)
+			return;
+		file->status = error ? StatusRunError : StatusRan;
+		file->message = error ? error : "";
+	}
+
+	// Reads and checks a file, then queues it to run if it should. Returns false if it couldn't be read.
+	bool Load(int id, bool force) {
+		std::string path;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			File* file = Find(id);
+			if (!file)
+				return true;
+			path = file->path;
+		}
+
+		std::vector<char> bytes;
+		if (!ReadFileBytes(path, bytes))
+			return false;
+		const char* text = bytes.data();
+		size_t size = bytes.size();
+		if (size >= 3 && memcmp(text, "\xEF\xBB\xBF", 3) == 0) {
+			text += 3;
+			size -= 3;
+		}
+
+		ImU32 hash = ImHashData(text, size);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			File* file = Find(id);
+			if (!file || (!force && file->hash == hash && file->status != StatusReadError && file->status != StatusWaiting))
+				return true;
+			file->hash = hash;
+			file->loads++;
+		}
+
+		std::vector<TextEditor::Diagnostic> diagnostics;
+		GLuaSyntax::Diagnose(text, text + size, diagnostics, cancel);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		File* file = Find(id);
+		if (!file)
+			return true;
+		if (!diagnostics.empty()) {
+			file->status = StatusSyntaxError;
+			file->message = "line " + std::to_string(diagnostics[0].mLine + 1) + ": " + diagnostics[0].mMessage;
+		}
+		else if (file->autoRun || force) {
+			file->status = StatusQueued;
+			file->message.clear();
+			Executor::Submit({ std::string(text, size), Globals::menuRealm.load(), id, Ran });
+		}
+		else {
+			file->status = StatusLoaded;
+			file->message.clear();
+		}
+		return true;
+	}
+
+	void Run() {
+		typedef std::chrono::steady_clock Clock;
+		struct Due {
+			int id;
+			Clock::time_point time;     // pushed back by every write, the file is read once it passes
+			int attempts;
+			bool force;
+		};
+
+		std::vector<Due> due;
+		std::vector<std::string> directories;
+		std::vector<Change> changes;
+		int watchedVersion = -1;
+		for (;;) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (stopping)
+					return;
+				if (listVersion != watchedVersion) {
+					watchedVersion = listVersion;
+					directories.clear();
+					for (const File& file : files) {
+						std::string directory = DirectoryOf(file.path);
+						if (std::none_of(directories.begin(), directories.end(), [&](const std::string& d) { return SamePath(d, directory); }))
+							directories.push_back(directory);
+						// New files are checked right away
+						if (file.status == StatusWaiting && std::none_of(due.begin(), due.end(), [&](const Due& d) { return d.id == file.id; }))
+							due.push_back({ file.id, Clock::now(), 0, false });
+					}
+					notifier->Watch(directories);
+				}
+			}
+
+			int timeoutMs = -1;
+			for (const Due& d : due) {
+				auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(d.time - Clock::now()).count() + 1;
+				timeoutMs = (int)std::max<long long>(0, timeoutMs < 0 ? wait : std::min<long long>(timeoutMs, wait));
+			}
+			changes.clear();
+			notifier->Wait(timeoutMs, changes);
+
+			Clock::time_point settled = Clock::now() + std::chrono::milliseconds(DebounceMs);
+			if (!changes.empty()) {
+				std::lock_guard<std::mutex> lock(mutex);
+				for (const Change& change : changes) {
+					if (change.directory >= directories.size())
+						continue;
+					for (const File& file : files) {
+						if (!SamePath(DirectoryOf(file.path), directories[change.directory]) ||
+							(!change.name.empty() && !SamePath(NameOf(file.path), change.name)))
+							continue;
+						auto d = std::find_if(due.begin(), due.end(), [&](const Due& d) { return d.id == file.id; });
+						if (d == due.end())
+							due.push_back({ file.id, settled, 0, false });
+						else
+							d->time = settled;
+					}
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (File& file : files) {
+					if (!file.runRequested)
+						continue;
+					file.runRequested = false;
+					due.push_back({ file.id, Clock::now(), 0, true });
+				}
+			}
+
+			Clock::time_point now = Clock::now();
+			for (size_t i = 0; i < due.size();) {
+				if (due[i].time > now) {
+					i++;
+					continue;
+				}
+				if (!Load(due[i].id, due[i].force) && ++due[i].attempts < ReadAttempts) {
+					due[i].time = now + std::chrono::milliseconds(DebounceMs);
+					i++;
+					continue;
+				}
+				if (due[i].attempts >= ReadAttempts) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (File* file = Find(due[i].id)) {
+						file->status = StatusReadError;
+						file->message = "Couldn't read the file";
+					}
+				}
+				due.erase(due.begin() + i);
+			}
+		}
+	}
+
+	// Writes the list as one "<run on save> <path>" line per file
+	void SaveList() {
+		std::string text;
+		for (const File& file : files)
+			text += std::string(file.autoRun ? "1 " : "0 ") + file.path + "\n";
+		WriteFileBytes(listPath, text.data(), text.size());
+	}
+
+	void Add(const std::string& path, bool autoRun) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (std::any_of(files.begin(), files.end(), [&](const File& file) { return SamePath(file.path, path); }))
+				return;
+			files.push_back({ nextId++, path, autoRun, StatusWaiting, std::string(), 0, 0, false });
+			listVersion++;
+			SaveList();
+		}
+		if (notifier)
+			notifier->Wake();
+	}
+
+	void Remove(int id) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			files.erase(std::remove_if(files.begin(), files.end(), [&](const File& file) { return file.id == id; }), files.end());
+			listVersion++;
+			SaveList();
+		}
+		if (notifier)
+			notifier->Wake();
+	}
+
+	void SetAutoRun(int id, bool autoRun) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (File* file = Find(id)) {
+			file->autoRun = autoRun;
+			SaveList();
+		}
+	}
+
+	void RunNow(int id) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			File* file = Find(id);
+			if (!file)
+				return;
+			file->runRequested = true;
+		}
+		if (notifier)
+			notifier->Wake();
+	}
+
+	void Start(const std::string& path) {
+		listPath = path;
+		std::vector<char> bytes;
+		if (ReadFileBytes(listPath, bytes)) {
+			std::string text(bytes.begin(), bytes.end());
+			size_t start = 0;
+			for (size_t end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+				if (end - start > 2)
+					files.push_back({ nextId++, text.substr(start + 2, end - start - 2), text[start] == '1', StatusWaiting, std::string(), 0, 0, false });
+			}
+		}
+		notifier = new Notifier();
+		thread = std::thread(Run);
+	}
+
+	void Stop() {
+		if (!thread.joinable())
+			return;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		cancel = true;
+		notifier->Wake();
+		thread.join();
+		delete notifier;
+		notifier = nullptr;
+	}
+}
\ No newline at end of file
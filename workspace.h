@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <imgui/TextEditor.h>
+#include "glua_completion.h"
+#include "glua_syntax.h"
+#include "luaglobals.h"
+
+// Open scripts, one editor per tab. Only the active editor keeps its glyphs and the caches it rebuilds when
+// rendered, the others are suspended down to packed text, colors and undo history.
+namespace Workspace {
+	struct Tab {
+		int id;
+		std::string name;
+		TextEditor editor;
+	};
+
+	std::vector<std::unique_ptr<Tab>> tabs;
+	Tab* active = nullptr;
+	int nextId = 1;
+
+	// The static API entries (they carry signatures) merged with names only the running Lua state knows about,
+	// both ranked the same way: names one level below the prefix first, then by name ignoring case
+	int Complete(const char* prefix, size_t length, TextEditor::Completion* out, int max) {
+		std::vector<TextEditor::Completion> found(max * 2);
+		int count = GLuaApi::Complete(prefix, length, found.data(), max);
+		int liveCount = LuaGlobals::Complete(prefix, length, found.data() + count, max);
+
+		int depth = (int)std::count(prefix, prefix + length, '.');
+		auto rank = [depth](const TextEditor::Completion& a, const TextEditor::Completion& b) {
+			bool aDirect = std::count(a.mText, a.mText + strlen(a.mText), '.') == depth;
+			bool bDirect = std::count(b.mText, b.mText + strlen(b.mText), '.') == depth;
+			if (aDirect != bDirect)
+				return aDirect;
+			// Exact text as the tie-break keeps duplicates adjacent when case variants sort between them, the
+			// stable sort still puts the static entry first
+			int order = _stricmp(a.mText, b.mText);
+			return order != 0 ? order < 0 : strcmp(a.mText, b.mText) < 0;
+		};
+		std::stable_sort(found.begin(), found.begin() + count + liveCount, rank);
+
+		int merged = 0;
+		for (int i = 0; i < count + liveCount && merged < max; i++) {
+			if (merged > 0 && strcmp(out[merged - 1].mText, found[i].mText) == 0)
+				continue;
+			out[merged++] = found[i];
+		}
+		return merged;
+	}
+
+	// Every tab colors, completes and checks with the same copy of the GLua definition and its API tables
+	std::shared_ptr<const TextEditor::LanguageDefinition> Language() {
+		static const std::shared_ptr<const TextEditor::LanguageDefinition> language = [] {
+			auto language = std::make_shared<TextEditor::LanguageDefinition>(TextEditor::LanguageDefinition::GLua());
+			language->mComplete = Complete;
+			language->mDiagnose = GLuaSyntax::Diagnose;
+			return std::shared_ptr<const TextEditor::LanguageDefinition>(language);
+		}();
+		return language;
+	}
+
+	Tab* Add(const std::string& name = "") {
+		std::unique_ptr<Tab> tab(new Tab());
+		tab->id = nextId++;
+		tab->name = name.empty() ? "Script " + std::to_string(tab->id) : name;
+		tab->editor.SetLanguageDefinition(Language());
+		// Picked up by the autosave journal every frame
+		tab->editor.SetRecordChanges(true);
+		tabs.push_back(std::move(tab));
+		if (!active)
+			active = tabs.back().get();
+		return tabs.back().get();
+	}
+
+	// Returns true if the active tab changed
+	bool Activate(Tab* tab) {
+		if (tab == active)
+			return false;
+		if (active)
+			active->editor.Suspend();
+		active = tab;
+		active->editor.Resume();
+		return true;
+	}
+
+	void Close(Tab* tab) {
+		for (size_t i = 0; i < tabs.size(); i++) {
+			if (tabs[i].get() != tab)
+				continue;
+
+			if (active == tab) {
+				active = tabs.size() > 1 ? tabs[i + 1 < tabs.size() ? i + 1 : i - 1].get() : nullptr;
+				if (active)
+					active->editor.Resume();
+			}
+			tabs.erase(tabs.begin() + i);
+			break;
+		}
+
+		// There is always a tab to type into
+		if (tabs.empty())
+			Add();
+	}
+
+	bool IsBlank(const Tab* tab) {
+		return tab->editor.GetTotalLines() == 1 && tab->editor.GetText().empty();
+	}
+
+	// Where a script being opened goes: the active tab if it's blank, else a new one
+	Tab* Open(const std::string& name) {
+		Tab* tab = active;
+		if (!tab || !IsBlank(tab))
+			tab = Add(name);
+		tab->name = name;
+		return tab;
+	}
+}
\ No newline at end of file